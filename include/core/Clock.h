@@ -0,0 +1,54 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+
+// Time source for Engine. Times are durations since the clock's own epoch, so a
+// virtual clock can start at zero and advance deterministically.
+class IClock
+{
+public:
+    using Duration = std::chrono::nanoseconds;
+
+    virtual ~IClock() = default;
+
+    // Current time since the clock's epoch
+    virtual Duration Now() const = 0;
+};
+
+// Real time from std::chrono::steady_clock, starting at zero on construction
+class SteadyClock : public IClock
+{
+public:
+    SteadyClock()
+        : m_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    Duration Now() const override
+    {
+        return std::chrono::duration_cast<Duration>(std::chrono::steady_clock::now() - m_start);
+    }
+
+private:
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// Manually advanced time for simulation, soak tests and fast-forward runs.
+// Nothing waits on it, so engine time passes as fast as the caller advances it.
+// One thread sets the time; any thread may read it.
+class VirtualClock : public IClock
+{
+public:
+    explicit VirtualClock(Duration start = Duration::zero())
+        : m_now(start.count())
+    {
+    }
+
+    Duration Now() const override { return Duration(m_now.load(std::memory_order_relaxed)); }
+
+    void Advance(Duration step) { m_now.store(m_now.load(std::memory_order_relaxed) + step.count(), std::memory_order_relaxed); }
+    void SetTime(Duration time) { m_now.store(time.count(), std::memory_order_relaxed); }
+
+private:
+    std::atomic<Duration::rep> m_now;
+};
@@ -0,0 +1,12 @@
+#pragma once
+#include <string>
+#include <vector>
+
+// Command-line arguments as UTF-8, argument 0 first. The narrow argv the C runtime passes
+// to main is in the ANSI code page, which cannot hold every file name, so the wide command
+// line is converted instead; argv is used only if that cannot be read.
+std::vector<std::string> GetUtf8Arguments(int argc = 0, char* argv[] = nullptr);
+
+// UTF-8 text such as a path argument as UTF-16, for the wide file APIs
+std::wstring Utf8ToWide(const std::string& text);
+std::string WideToUtf8(const std::wstring& text);
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class IRenderer;
+
+// Retained-mode description of one frame (clear, text runs, future primitives).
+// Engine rebuilds it only when scene state changes; any IRenderer can replay it.
+class DisplayList
+{
+public:
+    enum class CommandType : uint8_t
+    {
+        Clear,
+        Text
+    };
+
+    struct Command
+    {
+        CommandType type;
+        bool bold;
+        float r, g, b;
+
+        // Text commands only
+        float x, y;
+        float fontSize;
+        uint32_t textOffset;    // Index of the first character in the text pool
+        uint32_t textLength;    // Characters, excluding the terminator
+    };
+
+    DisplayList();
+
+    // Drop all commands; bumps the version so backends can tell the list changed
+    void Reset();
+
+    void AddClear(float r, float g, float b);
+    void AddText(const wchar_t* text, float x, float y, float fontSize,
+                 float r, float g, float b, bool bold = false);
+
+    // Append another list's commands after this one's (used to merge per-thread lists)
+    void Append(const DisplayList& other);
+
+    void Reserve(size_t commands, size_t textCharacters);
+
+    // Issue the whole frame (BeginFrame, commands, EndFrame) on a renderer
+    void Replay(IRenderer& renderer) const;
+
+    const std::vector<Command>& GetCommands() const { return m_commands; }
+    const wchar_t* GetText(const Command& command) const { return m_text.data() + command.textOffset; }
+    bool IsEmpty() const { return m_commands.empty(); }
+    size_t GetTextPoolSize() const { return m_text.size(); }
+
+    // Incremented on every Reset; equal versions mean identical contents
+    uint64_t GetVersion() const { return m_version; }
+
+private:
+    std::vector<Command> m_commands;
+    std::vector<wchar_t> m_text;    // Null-terminated strings, pooled for all text commands
+    uint64_t m_version;
+};
@@ -1,49 +1,183 @@
 #pragma once
 #include "IRenderer.h"
+#include "DisplayList.h"
+#include "Clock.h"
+#include "TimerWheel.h"
+#include "TaskScheduler.h"
+#include "TripleBuffer.h"
 #include <memory>
 #include <random>
 #include <chrono>
 
-// Application engine - handles logic only, delegates rendering to IRenderer
+// Application engine - handles logic only, delegates rendering to IRenderer.
+//
+// Simulation runs in fixed steps (60 Hz by default) driven by an accumulator; Render()
+// can run at any rate and draws the state of the latest step. Timed behaviors run as Tasks
+// on the engine's scheduler.
+//
+// Update() and Render() may run on different threads (see EngineThreads): Update()
+// publishes a snapshot of the simulation through a lock-free triple buffer and Render()
+// draws the newest one. Initialize, SwitchRenderer, Resize and OnDestroy belong to the
+// render side; SetSeed, the timing setters, timers and tasks to the update side.
 class Engine
 {
 public:
-    Engine(UINT width, UINT height);
+    // Uses a SteadyClock unless a clock is given (e.g. a VirtualClock for simulation)
+    Engine(UINT width, UINT height, std::shared_ptr<IClock> clock = nullptr);
     ~Engine();
 
     // Initialize engine with a renderer
     void Initialize(HWND hwnd, std::unique_ptr<IRenderer> renderer);
 
-    // Update application state
+    // Advance the simulation by as many fixed steps as the clock has moved on, up to
+    // the catch-up limit
     void Update();
 
-    // Render the scene
+    // Render the scene from the latest published snapshot
     void Render();
 
     // Cleanup
     void OnDestroy();
 
+    // Window client area changed; ignores 0x0 (minimized)
+    void Resize(UINT width, UINT height);
+
+    UINT GetWidth() const { return m_width; }
+    UINT GetHeight() const { return m_height; }
+
     // Switch to a different renderer at runtime
     void SwitchRenderer(std::unique_ptr<IRenderer> newRenderer);
 
-    // Get current random number
+    // Switch to an already initialized renderer (a suspended one, or one initialized for
+    // this window elsewhere) without tearing the current one down: it is suspended and
+    // returned so the caller can keep it warm
+    std::unique_ptr<IRenderer> SwapRenderer(std::unique_ptr<IRenderer> renderer);
+
+    HWND GetWindow() const { return m_hwnd; }
+
+    // Get current random number (update side)
     int GetRandomNumber() const { return m_randomNumber; }
 
+    // Reseed the generator and pick a new number, for reproducible runs
+    void SetSeed(uint32_t seed);
+
     // Get current renderer name
     const char* GetRendererName() const;
 
+    // Whether Render() blocks on the display by itself (IRenderer::IsPresentPaced)
+    bool IsRenderPaced() const { return m_renderer && m_renderer->IsPresentPaced(); }
+
+    // Fonts and atlases handed to every renderer, kept across switches
+    const std::shared_ptr<ResourceManager>& GetResources() const { return m_resources; }
+
+    // Engine time between random number updates (default 5 seconds)
+    void SetUpdateInterval(IClock::Duration interval);
+    IClock::Duration GetUpdateInterval() const { return m_updateInterval; }
+
+    // Number of timed updates performed by Update() so far
+    uint64_t GetUpdateCount() const { return m_updateCount; }
+
+    // Simulation step length (default 1/60 s)
+    void SetFixedTimestep(IClock::Duration step);
+    IClock::Duration GetFixedTimestep() const { return m_fixedStep; }
+
+    // Most steps a single Update() may run; clock time beyond that is dropped so a slow
+    // machine falls behind in simulation time instead of spiralling (default 8)
+    void SetMaxStepsPerUpdate(uint32_t steps) { m_maxStepsPerUpdate = steps; }
+
+    // Simulation progress: steps run, engine time simulated, and clock time dropped
+    uint64_t GetStepCount() const { return m_stepCount; }
+    IClock::Duration GetSimulationTime() const { return m_simulationTime; }
+    IClock::Duration GetDroppedTime() const { return m_droppedTime; }
+
+    // Fraction of a step between the current simulation state and the clock, [0, 1)
+    float GetStepFraction() const;
+
+    // Run a callback after (or every) `delay` of simulation time, rounded up to whole
+    // steps of the current timestep. Timers fire inside Update(), one wheel tick per step.
+    TimerWheel::TimerId ScheduleTimer(IClock::Duration delay, TimerWheel::Callback callback,
+                                      bool periodic = false);
+    bool CancelTimer(TimerWheel::TimerId id) { return m_timers.Cancel(id); }
+    TimerWheel& GetTimers() { return m_timers; }
+
+    // Coroutine tasks; frame waiters and async completions resume at the end of Update()
+    TaskScheduler& GetTasks() { return m_tasks; }
+
+    // Suspend a task for `delay` of simulation time, rounded up to whole steps
+    TaskScheduler::DelayAwaiter Delay(IClock::Duration delay) { return m_tasks.Delay(ToTicks(delay)); }
+
+    const IClock& GetClock() const { return *m_clock; }
+
 private:
+    // Everything Render() needs from the simulation: the number, its text and the colors
+    // derived from it. Layout is left to the render side because it depends on the active
+    // renderer's text metrics, which change with renderer switches and font residency.
+    struct Snapshot
+    {
+        int number;
+        wchar_t numberText[8];
+        float background[3];
+        float numberColor[3];
+    };
+
+    // One fixed simulation step
+    void Step();
+
+    // Hand the current simulation state to the render side
+    void PublishSnapshot();
+
+    // Picks a new number every update interval
+    Task RefreshNumbers();
+
+    // (Re)start the number refresh task, restarting its period
+    void ScheduleRefresh();
+
+    uint64_t ToTicks(IClock::Duration duration) const;
+
     void UpdateRandomNumber();
-    void RenderScene();
+
+    // Rebuild m_displayList from m_rendered, laid out with the renderer's text metrics
+    void BuildScene();
+
+    void UpdateWindowTitle();
 
     HWND m_hwnd;
     UINT m_width;
     UINT m_height;
 
     std::unique_ptr<IRenderer> m_renderer;
+    std::shared_ptr<ResourceManager> m_resources;
 
     // Application state
     int m_randomNumber;
     std::mt19937 m_rng;
-    std::chrono::steady_clock::time_point m_lastUpdateTime;
+
+    // Timing
+    std::shared_ptr<IClock> m_clock;
+    IClock::Duration m_updateInterval;
+    uint64_t m_updateCount;
+
+    // Fixed-step simulation
+    IClock::Duration m_fixedStep;
+    uint32_t m_maxStepsPerUpdate;
+    IClock::Duration m_previousClockTime;
+    IClock::Duration m_accumulator;
+    IClock::Duration m_simulationTime;
+    IClock::Duration m_droppedTime;
+    uint64_t m_stepCount;
+
+    // Update -> render handoff
+    TripleBuffer<Snapshot> m_snapshots;
+
+    // Simulation-time timers, one tick per step, and the tasks waiting on them. The
+    // scheduler is declared last so its tasks are destroyed before the wheel.
+    TimerWheel m_timers;
+    TaskScheduler m_tasks;
+    TaskScheduler::TaskId m_refreshTask;
+
+    // Render side: retained scene, rebuilt only when state or renderer changes
+    Snapshot m_rendered;                // Snapshot the list was built from
+    DisplayList m_displayList;
+    bool m_sceneDirty;
+    uint64_t m_resourceVersion;         // Residency version the list was laid out with
 };
@@ -0,0 +1,68 @@
+#pragma once
+#include <windows.h>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Engine;
+
+// Runs Engine::Update and Engine::Render on threads of their own, so the window thread
+// only pumps messages and a blocking present or fence wait delays neither input nor the
+// simulation.
+//
+// The update thread runs Update() as each fixed step falls due and publishes a snapshot.
+// The render thread runs on its own at the display rate: each frame it runs posted
+// commands (renderer switches, resizes), then draws whichever snapshot is newest. A vsync
+// present paces it (IRenderer::IsPresentPaced); otherwise it waits for the compositor's
+// next frame. Once started, the engine must only be touched through Post().
+class EngineThreads
+{
+public:
+    using Command = std::function<void(Engine&)>;
+    using Hook = std::function<void()>;
+
+    // beforeUpdate runs on the update thread ahead of every Update() (e.g. to latch a
+    // frame clock); onFailure runs on the failing thread after it logged the exception;
+    // afterRender runs on the render thread after every Render()
+    EngineThreads(Engine& engine, Hook beforeUpdate = nullptr, Hook onFailure = nullptr,
+                  Hook afterRender = nullptr);
+    ~EngineThreads();
+
+    EngineThreads(const EngineThreads&) = delete;
+    EngineThreads& operator=(const EngineThreads&) = delete;
+
+    void Start();
+
+    // Joins both threads. Call from the window thread: messages the render thread sends
+    // to the window (title, repaint) are processed while waiting, so it cannot deadlock.
+    void Stop();
+
+    // Run a render-side command on the render thread before its next frame (within one
+    // display refresh)
+    void Post(Command command);
+
+    bool IsRunning() const { return m_running.load(); }
+
+private:
+    void UpdateLoop();
+    void RenderLoop();
+    void Fail(const char* where, const std::exception& e);
+
+    Engine& m_engine;
+    Hook m_beforeUpdate;
+    Hook m_onFailure;
+    Hook m_afterRender;
+
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_renderExited;
+
+    std::mutex m_commandMutex;
+    std::vector<Command> m_commands;
+
+    std::thread m_updateThread;
+    std::thread m_renderThread;
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Monotonic completion counter for work that finishes asynchronously - a GPU queue, a
+// present thread. The producer of the work signals increasing values as it completes;
+// anyone may wait for a value. 0 is complete from the start.
+class IFence
+{
+public:
+    virtual ~IFence() = default;
+
+    virtual uint64_t GetCompletedValue() const = 0;
+
+    // Block until GetCompletedValue() >= value
+    virtual void Wait(uint64_t value) = 0;
+};
+
+// Fence signaled from CPU threads: the software renderer's present thread, or a test
+// thread standing in for a GPU
+class CpuFence : public IFence
+{
+public:
+    explicit CpuFence(uint64_t initialValue = 0)
+        : m_completed(initialValue)
+    {
+    }
+
+    uint64_t GetCompletedValue() const override { return m_completed.load(std::memory_order_acquire); }
+
+    void Wait(uint64_t value) override
+    {
+        uint64_t completed;
+        while ((completed = m_completed.load(std::memory_order_acquire)) < value)
+            m_completed.wait(completed, std::memory_order_acquire);
+    }
+
+    // Values must not decrease
+    void Signal(uint64_t value)
+    {
+        m_completed.store(value, std::memory_order_release);
+        m_completed.notify_all();
+    }
+
+private:
+    std::atomic<uint64_t> m_completed;
+};
@@ -0,0 +1,94 @@
+#pragma once
+#include "Fence.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+// Deepest supported queue: the CPU may record up to this many frames ahead of the consumer
+const uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+
+// Frames in flight for any backend. Frame contexts - each owning that frame's transient
+// allocators and command storage (a D3D12 command allocator, a software framebuffer) -
+// are used round-robin. Before frame k records into its context, BeginFrame waits on the
+// fence for frame k - depth, the last one to use it, so the CPU runs at most `depth`
+// frames ahead of the GPU or present thread. Depth 1 serializes every frame.
+//
+// EndFrame returns the fence value that retires the frame; the owner must arrange for the
+// fence to reach it once the consumer is done (ID3D12CommandQueue::Signal, or
+// CpuFence::Signal from a present thread).
+template <typename Context>
+class FrameRing
+{
+public:
+    FrameRing(IFence& fence, uint32_t depth = 2)
+        : m_fence(fence)
+        , m_depth(ClampDepth(depth))
+        , m_current(0)
+        , m_frameNumber(0)
+        , m_lastFenceValue(0)
+        , m_stalls(0)
+        , m_retireValues()
+    {
+    }
+
+    FrameRing(const FrameRing&) = delete;
+    FrameRing& operator=(const FrameRing&) = delete;
+
+    // Wait until the next context is free, make it current and return it
+    Context& BeginFrame()
+    {
+        m_current = static_cast<uint32_t>(m_frameNumber % m_depth);
+        uint64_t retire = m_retireValues[m_current];
+        if (m_fence.GetCompletedValue() < retire)
+        {
+            m_stalls++;
+            m_fence.Wait(retire);
+        }
+        return m_contexts[m_current];
+    }
+
+    // Finish the current frame; returns the fence value the owner must signal for it
+    uint64_t EndFrame()
+    {
+        m_retireValues[m_current] = ++m_lastFenceValue;
+        m_frameNumber++;
+        return m_lastFenceValue;
+    }
+
+    // Wait for every submitted frame (before resizing or releasing shared resources)
+    void WaitIdle() { m_fence.Wait(m_lastFenceValue); }
+
+    // Takes effect from the next frame; waits for the queue to drain first
+    void SetDepth(uint32_t depth)
+    {
+        WaitIdle();
+        m_depth = ClampDepth(depth);
+        m_frameNumber = 0;
+    }
+
+    uint32_t GetDepth() const { return m_depth; }
+
+    // Context of the frame being recorded (the first one before any BeginFrame)
+    Context& Current() { return m_contexts[m_current]; }
+    const Context& Current() const { return m_contexts[m_current]; }
+
+    // All contexts, including ones beyond the current depth (for setup and resizing)
+    Context& GetContext(uint32_t index) { return m_contexts[index]; }
+
+    uint64_t GetFrameNumber() const { return m_frameNumber; }
+
+    // Frames whose BeginFrame had to wait for the consumer
+    uint64_t GetStallCount() const { return m_stalls; }
+
+private:
+    static uint32_t ClampDepth(uint32_t depth) { return std::clamp(depth, 1u, MAX_FRAMES_IN_FLIGHT); }
+
+    IFence& m_fence;
+    uint32_t m_depth;
+    uint32_t m_current;
+    uint64_t m_frameNumber;
+    uint64_t m_lastFenceValue;
+    uint64_t m_stalls;
+    std::array<Context, MAX_FRAMES_IN_FLIGHT> m_contexts;
+    std::array<uint64_t, MAX_FRAMES_IN_FLIGHT> m_retireValues;   // Fence value of each context's last frame
+};
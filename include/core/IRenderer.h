@@ -1,5 +1,9 @@
 #pragma once
 #include <Windows.h>
+#include "DisplayList.h"
+#include <memory>
+
+class ResourceManager;
 
 // Pure rendering interface - no application logic
 class IRenderer
@@ -19,7 +23,8 @@ public:
     // Draw text at position (x, y) with given font size and color
     // fontSize: point size (e.g., 24, 120)
     // r, g, b: color components 0.0-1.0
-    // bold: whether to use bold font
+    // bold: whether to use bold font; only GDI honours it. The sprite font renderers draw
+    // sizes above 60 from the 120pt font, which is itself a bold cut, whatever bold says
     virtual void DrawText(const wchar_t* text, float x, float y, float fontSize,
                          float r, float g, float b, bool bold = false) = 0;
 
@@ -27,9 +32,58 @@ public:
     virtual void MeasureText(const wchar_t* text, float fontSize,
                             float& outWidth, float& outHeight) = 0;
 
+    // Sprite font asset whose metrics DrawText and MeasureText use for text at fontSize,
+    // multiplied by outScale (fontSize over the size the font was made at), or nullptr when
+    // text is laid out some other way. Text in that font can then be measured ahead of
+    // time, without asking the renderer.
+    virtual const wchar_t* GetSpriteFontName(const wchar_t* text, float fontSize, float& outScale) const
+    {
+        (void)text;
+        (void)fontSize;
+        outScale = 1.0f;
+        return nullptr;
+    }
+
     // End frame and present to screen
     virtual void EndFrame() = 0;
 
+    // Whether EndFrame blocks until the display can take another frame (a vsync present),
+    // which paces a render loop to the refresh rate by itself. Loops wait for the display
+    // themselves when it does not.
+    virtual bool IsPresentPaced() const { return false; }
+
+    // Resize the back buffer to match the window's client area
+    virtual void Resize(UINT width, UINT height) = 0;
+
+    // Frames the CPU may record ahead of presentation, 1 to MAX_FRAMES_IN_FLIGHT. Higher
+    // depths overlap recording with GPU work or presents at the cost of latency. Backends
+    // without frame pipelining ignore it.
+    virtual void SetFramesInFlight(UINT frames) { (void)frames; }
+
+    // Shared asset store to take fonts from, set before Initialize. Renderers given none
+    // create a private one; backends without file-based assets ignore it.
+    virtual void SetResources(std::shared_ptr<ResourceManager> resources) { (void)resources; }
+
+    // Draw a complete retained frame. The default replays it through the immediate-mode
+    // calls above; backends may override to cache or diff work between list versions.
+    virtual void DrawDisplayList(const DisplayList& list) { list.Replay(*this); }
+
+    // Park an initialized renderer while another one draws to the window: finish queued
+    // work and let go of the window's presentation surface (a swap chain, the window DC),
+    // but keep devices, fonts and pipelines. Resume makes it current again at the given
+    // size. Both are render-side calls.
+    virtual void Suspend() {}
+    virtual void Resume(UINT width, UINT height) { Resize(width, height); }
+
+    // Initialize straight into the suspended state, possibly on a background thread while
+    // another renderer presents to the window: devices, fonts and pipelines, but no
+    // presentation surface until Resume. The default initializes and then suspends.
+    virtual void InitializeSuspended(HWND hwnd, UINT width, UINT height)
+    {
+        Initialize(hwnd, width, height);
+        Suspend();
+    }
+
     // Cleanup resources
     virtual void OnDestroy() = 0;
 
@@ -1,5 +1,7 @@
 #pragma once
 #include <windows.h>
+#include <chrono>
+#include <cstdio>
 #include <string>
 #include <sstream>
 #include <fstream>
@@ -21,11 +23,26 @@ private:
         return mtx;
     }
 
+    // Lines are stamped with seconds since ClearLog (or the first line)
+    static std::chrono::steady_clock::time_point& GetStartTime()
+    {
+        static std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        return start;
+    }
+
+    static std::string Timestamp()
+    {
+        char stamp[32];
+        snprintf(stamp, sizeof(stamp), "[%9.3f] ",
+                 std::chrono::duration<double>(std::chrono::steady_clock::now() - GetStartTime()).count());
+        return stamp;
+    }
+
 public:
     static void Log(const std::string& message)
     {
         std::lock_guard<std::mutex> lock(GetMutex());
-        std::string fullMsg = "[LOG] " + message + "\n";
+        std::string fullMsg = Timestamp() + "[LOG] " + message + "\n";
         OutputDebugStringA(fullMsg.c_str());
         GetLogFile() << fullMsg << std::flush;
     }
@@ -34,7 +51,7 @@ public:
     {
         std::lock_guard<std::mutex> lock(GetMutex());
         std::stringstream ss;
-        ss << "[ERROR] " << message;
+        ss << Timestamp() << "[ERROR] " << message;
         if (FAILED(hr))
         {
             ss << " (HRESULT: 0x" << std::hex << hr << ")";
@@ -51,13 +68,14 @@ public:
     static void LogWarning(const std::string& message)
     {
         std::lock_guard<std::mutex> lock(GetMutex());
-        std::string fullMsg = "[WARNING] " + message + "\n";
+        std::string fullMsg = Timestamp() + "[WARNING] " + message + "\n";
         OutputDebugStringA(fullMsg.c_str());
         GetLogFile() << fullMsg << std::flush;
     }
 
     static void ClearLog()
     {
+        GetStartTime() = std::chrono::steady_clock::now();
         std::ofstream logFile("graphics_engine_log.txt", std::ios::trunc);
         logFile.close();
     }
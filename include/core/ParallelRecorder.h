@@ -0,0 +1,65 @@
+#pragma once
+#include "DisplayList.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Records one frame's display list from several threads at once.
+//
+// The frame is split into jobs (e.g. one per dashboard row). Every job records into its
+// own command buffer, and EndFrame merges the buffers in job order. The merged list is
+// therefore identical however the jobs were spread over threads. IRenderer itself stays
+// single-threaded: only recording (layout and Add* calls) runs in parallel, and the
+// result is replayed on the render thread as usual.
+class ParallelRecorder
+{
+public:
+    using RecordFunction = std::function<void(size_t job, DisplayList& buffer)>;
+
+    // Uses up to `threads` threads including the caller; 0 picks the hardware concurrency
+    explicit ParallelRecorder(unsigned threads = 0);
+    ~ParallelRecorder();
+
+    ParallelRecorder(const ParallelRecorder&) = delete;
+    ParallelRecorder& operator=(const ParallelRecorder&) = delete;
+
+    // Run record(job, buffer) for every job across the pool, then merge into `out`
+    // (after resetting it). Jobs run concurrently, so record() must only write its own
+    // buffer and read thread-safe state (e.g. GlyphTable metrics). The first exception
+    // thrown by a job is rethrown here once all jobs have finished.
+    void Record(DisplayList& out, size_t jobs, const RecordFunction& record);
+
+    // The same in steps, for callers with their own threads: each buffer must be recorded
+    // by one thread at a time, and EndFrame called once they are all done
+    void BeginFrame(size_t buffers);
+    DisplayList& GetBuffer(size_t index) { return m_buffers[index]; }
+    void EndFrame(DisplayList& out);
+
+    unsigned GetThreadCount() const { return static_cast<unsigned>(m_workers.size()) + 1; }
+
+private:
+    void WorkerLoop();
+    void RunJobs();
+
+    std::vector<DisplayList> m_buffers;     // Kept between frames to reuse their capacity
+    size_t m_bufferCount;
+
+    // Current Record() call, shared with the workers
+    const RecordFunction* m_record;
+    size_t m_jobCount;
+    std::atomic<size_t> m_nextJob;
+    std::exception_ptr m_error;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    uint64_t m_generation;
+    size_t m_busyWorkers;
+    bool m_stopping;
+    std::vector<std::thread> m_workers;
+};
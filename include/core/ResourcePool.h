@@ -0,0 +1,150 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// 32-bit reference to an item in a ResourcePool<T>: a slot index in the low 20 bits and
+// the slot's generation in the high 12. Releasing an item bumps its slot's generation,
+// so handles still held elsewhere stop resolving instead of reaching whatever reuses the
+// slot. The value 0 is never issued and means "no resource".
+template <typename T>
+struct ResourceHandle
+{
+    static const uint32_t INDEX_BITS = 20;
+    static const uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static const uint32_t GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+
+    uint32_t value = 0;
+
+    uint32_t GetIndex() const { return value & INDEX_MASK; }
+    uint32_t GetGeneration() const { return value >> INDEX_BITS; }
+    bool IsNull() const { return value == 0; }
+
+    explicit operator bool() const { return value != 0; }
+    bool operator==(const ResourceHandle& other) const { return value == other.value; }
+    bool operator!=(const ResourceHandle& other) const { return value != other.value; }
+};
+
+// Generational slot map. Items live packed in one dense array (iteration and lookups
+// touch contiguous memory); slots map handles to dense positions. Add, Get and Remove
+// are O(1): removal moves the last item into the hole. Pointers returned by Get are
+// invalidated by Add and Remove, so hold handles, not pointers, across frames.
+//
+// Tag sets the handle type, so a pool of std::unique_ptr<X> can hand out handles to X.
+// Not thread-safe; the owner serializes access.
+template <typename T, typename Tag = T>
+class ResourcePool
+{
+public:
+    using Handle = ResourceHandle<Tag>;
+
+    static const uint32_t MAX_ITEMS = Handle::INDEX_MASK + 1;
+
+    Handle Add(T item)
+    {
+        uint32_t slot;
+        if (!m_freeSlots.empty())
+        {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+        else
+        {
+            if (m_slots.size() >= MAX_ITEMS)
+                return Handle();
+            slot = static_cast<uint32_t>(m_slots.size());
+            m_slots.push_back(Slot{ 0, 1 });
+        }
+
+        m_slots[slot].dense = static_cast<uint32_t>(m_items.size());
+        m_items.push_back(std::move(item));
+        m_owners.push_back(slot);
+        return MakeHandle(slot);
+    }
+
+    // nullptr for null or released handles
+    T* Get(Handle handle)
+    {
+        const Slot* slot = Find(handle);
+        return slot ? &m_items[slot->dense] : nullptr;
+    }
+
+    const T* Get(Handle handle) const
+    {
+        const Slot* slot = Find(handle);
+        return slot ? &m_items[slot->dense] : nullptr;
+    }
+
+    bool IsValid(Handle handle) const { return Find(handle) != nullptr; }
+
+    // Returns false if the handle was already stale
+    bool Remove(Handle handle)
+    {
+        const Slot* found = Find(handle);
+        if (!found)
+            return false;
+
+        uint32_t slotIndex = handle.GetIndex();
+        uint32_t dense = found->dense;
+        uint32_t last = static_cast<uint32_t>(m_items.size()) - 1;
+        if (dense != last)
+        {
+            m_items[dense] = std::move(m_items[last]);
+            m_owners[dense] = m_owners[last];
+            m_slots[m_owners[dense]].dense = dense;
+        }
+        m_items.pop_back();
+        m_owners.pop_back();
+
+        // Generation 0 is skipped so no live handle is ever 0
+        Slot& slot = m_slots[slotIndex];
+        slot.generation = (slot.generation + 1) & Handle::GENERATION_MASK;
+        if (slot.generation == 0)
+            slot.generation = 1;
+        m_freeSlots.push_back(slotIndex);
+        return true;
+    }
+
+    void Clear()
+    {
+        while (!m_owners.empty())
+            Remove(MakeHandle(m_owners.back()));
+    }
+
+    size_t GetCount() const { return m_items.size(); }
+
+    // Dense iteration over live items, in no particular order
+    typename std::vector<T>::iterator begin() { return m_items.begin(); }
+    typename std::vector<T>::iterator end() { return m_items.end(); }
+    typename std::vector<T>::const_iterator begin() const { return m_items.begin(); }
+    typename std::vector<T>::const_iterator end() const { return m_items.end(); }
+
+private:
+    struct Slot
+    {
+        uint32_t dense;         // Position in m_items while live
+        uint32_t generation;    // Bumped on release; free slots match no issued handle
+    };
+
+    Handle MakeHandle(uint32_t slot) const
+    {
+        Handle handle;
+        handle.value = (m_slots[slot].generation << Handle::INDEX_BITS) | slot;
+        return handle;
+    }
+
+    const Slot* Find(Handle handle) const
+    {
+        uint32_t index = handle.GetIndex();
+        if (handle.IsNull() || index >= m_slots.size())
+            return nullptr;
+        const Slot& slot = m_slots[index];
+        return slot.generation == handle.GetGeneration() ? &slot : nullptr;
+    }
+
+    std::vector<T> m_items;
+    std::vector<uint32_t> m_owners;     // Dense position -> slot
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+};
@@ -0,0 +1,93 @@
+#pragma once
+#include <Windows.h>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Clock.h"
+
+// Session recordings (.gesession): the RNG seed plus every event the window procedure
+// handles, so a live run - or an authored scenario - can be replayed deterministically.
+//
+// A fixed header followed by fixed-size events in the order they happened. Frame events
+// carry the engine clock time of the Update/Render they stand for, which makes the
+// random number sequence reproducible on a VirtualClock.
+namespace SessionFormat
+{
+    const char MAGIC[8] = { 'G', 'E', 'S', 'E', 'S', 'S', 'I', 'O' };
+    const uint32_t VERSION = 1;
+
+    enum class EventType : uint32_t
+    {
+        Frame = 1,          // Update + Render
+        SwitchRenderer = 2, // arg0 = RendererType value
+        Resize = 3,         // arg0 = width, arg1 = height
+        TimerTick = 4       // WM_TIMER (drives GDI repaints)
+    };
+
+    struct FileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t seed;
+        uint32_t width;         // Initial client size
+        uint32_t height;
+        uint32_t renderer;      // Initial RendererType value
+    };
+
+    struct Event
+    {
+        EventType type;
+        uint32_t arg0;
+        uint32_t arg1;
+        uint32_t reserved;
+        uint64_t timeNs;        // Engine clock time
+    };
+}
+
+// A whole session in memory
+struct SessionRecording
+{
+    uint32_t seed = 0;
+    uint32_t width = 1280;
+    uint32_t height = 720;
+    uint32_t renderer = 0;
+    std::vector<SessionFormat::Event> events;
+
+    // Throws std::runtime_error if the file is missing or malformed
+    static SessionRecording Load(const std::wstring& fileName);
+
+    // Throws std::runtime_error if the file cannot be written
+    void Save(const std::wstring& fileName) const;
+};
+
+// Streams events to a session file as they happen. Events are batched and written
+// when enough are pending, on Flush and on destruction. Safe to call from several
+// threads (frames come from the update thread, input from the window thread).
+class SessionRecorder
+{
+public:
+    // Creates (truncates) the file; throws std::runtime_error on failure
+    SessionRecorder(const std::wstring& fileName, uint32_t seed, UINT width, UINT height, uint32_t renderer);
+    ~SessionRecorder();
+
+    SessionRecorder(const SessionRecorder&) = delete;
+    SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+    void RecordFrame(IClock::Duration time);
+    void RecordSwitchRenderer(uint32_t renderer, IClock::Duration time);
+    void RecordResize(UINT width, UINT height, IClock::Duration time);
+    void RecordTimerTick(IClock::Duration time);
+
+    void Flush();
+
+private:
+    void Record(SessionFormat::EventType type, uint32_t arg0, uint32_t arg1, IClock::Duration time);
+    void WritePending();
+
+    FILE* m_file;
+    std::mutex m_mutex;
+    std::vector<SessionFormat::Event> m_pending;
+};
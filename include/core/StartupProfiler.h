@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// Startup instrumentation: named phases with wall time, process CPU time, I/O bytes and
+// heap allocations (operator new calls and bytes), reported once the first frame is up.
+// Allocations are only seen in programs whose replacement operator new reports them
+// through CountAllocation (GraphicsEngine's AllocationCounting.cpp); elsewhere they read 0.
+//
+// A phase begun while another is open on the same thread is reported nested under it, and
+// phases begun off the thread that called Start are marked as worker phases. Phases may
+// end on a different thread than they began on (e.g. from window creation to the first
+// present on the render thread). Outside Start/Finish every call is a cheap no-op, so
+// instrumented code runs unchanged in tools and after startup.
+class StartupProfiler
+{
+public:
+    using PhaseId = int;
+    static const PhaseId NO_PHASE = -1;
+
+    // Take the baseline and start counting allocations
+    static void Start();
+
+    static PhaseId BeginPhase(const char* name);
+    static void EndPhase(PhaseId phase);
+
+    // Stop profiling and return the report: one row per phase in the order they began
+    // (still open ones are cut off here), then the total since Start
+    static std::string Finish();
+
+    static bool IsActive();
+
+    // One heap allocation of `bytes`; a relaxed load unless profiling
+    static void CountAllocation(std::size_t bytes);
+
+    // Phase covering the enclosing block
+    class Scope
+    {
+    public:
+        explicit Scope(const char* name) : m_phase(BeginPhase(name)) {}
+        ~Scope() { EndPhase(m_phase); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        PhaseId m_phase;
+    };
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <utility>
+
+class TaskScheduler;
+
+// Coroutine for engine behaviors, written as sequential code that suspends on the
+// scheduler's awaitables (TaskScheduler::Delay, NextFrame, RunAsync):
+//
+//     Task Engine::RefreshNumbers()
+//     {
+//         for (;;)
+//         {
+//             co_await Delay(m_updateInterval);
+//             UpdateRandomNumber();
+//         }
+//     }
+//
+// A Task starts suspended and does nothing until handed to TaskScheduler::Spawn, which
+// takes ownership of the coroutine frame. A Task that is never spawned destroys its frame.
+class Task
+{
+public:
+    struct promise_type
+    {
+        uint64_t id = 0;                // Assigned by Spawn
+        uint64_t timer = 0;             // Pending Delay timer, for cancellation
+        bool running = false;
+        bool awaitingAsync = false;     // RunAsync work holds a pointer into the frame
+        bool cancelled = false;         // Destroy at the next suspension or async completion
+        std::exception_ptr exception;
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { exception = std::current_exception(); }
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (m_handle)
+                m_handle.destroy();
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task()
+    {
+        if (m_handle)
+            m_handle.destroy();
+    }
+
+private:
+    friend class TaskScheduler;
+
+    explicit Task(Handle handle) : m_handle(handle) {}
+
+    // Hand the frame over to the scheduler
+    Handle Release() { return std::exchange(m_handle, nullptr); }
+
+    Handle m_handle;
+};
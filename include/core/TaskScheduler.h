@@ -0,0 +1,108 @@
+#pragma once
+#include "Task.h"
+#include "TimerWheel.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Runs engine Tasks on the engine thread. A suspended task costs nothing per frame: it
+// is resumed only by the timer, frame boundary or async completion it is waiting for.
+//
+//   co_await scheduler.Delay(ticks);       // resumes from a TimerWheel callback
+//   co_await scheduler.NextFrame();        // resumes at the next RunFrame()
+//   co_await scheduler.RunAsync(work);     // work() runs on a background thread; the task
+//                                          // resumes at the first RunFrame() after it ends
+//
+// Exceptions thrown by a task end that task and are logged; exceptions from RunAsync work
+// are rethrown from the co_await.
+class TaskScheduler
+{
+public:
+    using TaskId = uint64_t;
+
+    static const TaskId INVALID_TASK = 0;
+
+    explicit TaskScheduler(TimerWheel& timers);
+
+    // Waits for running async work, then destroys all unfinished tasks
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    // Take ownership of a task and run it until its first suspension
+    TaskId Spawn(Task task);
+
+    // Destroy an unfinished task. A task that is running (cancelling itself) or waiting on
+    // async work is destroyed as soon as it next suspends or the work completes.
+    bool Cancel(TaskId id);
+
+    bool IsAlive(TaskId id) const { return m_tasks.count(id) != 0; }
+    size_t GetTaskCount() const { return m_tasks.size(); }
+
+    // Frame boundary: resume tasks waiting on NextFrame() or finished async work
+    void RunFrame();
+
+    struct DelayAwaiter
+    {
+        TaskScheduler& scheduler;
+        uint64_t ticks;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(Task::Handle handle);
+        void await_resume() const noexcept {}
+    };
+
+    struct FrameAwaiter
+    {
+        TaskScheduler& scheduler;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(Task::Handle handle);
+        void await_resume() const noexcept {}
+    };
+
+    struct AsyncAwaiter
+    {
+        TaskScheduler& scheduler;
+        std::function<void()> work;
+        std::exception_ptr error;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(Task::Handle handle);
+        void await_resume();
+    };
+
+    // Timer ticks (simulation steps when owned by Engine); at least one
+    DelayAwaiter Delay(uint64_t ticks) { return { *this, ticks }; }
+    FrameAwaiter NextFrame() { return { *this }; }
+    AsyncAwaiter RunAsync(std::function<void()> work) { return { *this, std::move(work), nullptr }; }
+
+private:
+    // Resume a live task by id; destroys it if it finished or was cancelled
+    void Resume(TaskId id);
+
+    // Free a task's frame and cancel its timer; no-op for ids that are not live
+    void Destroy(TaskId id);
+
+    // Background thread for RunAsync work, started on first use
+    void WorkerLoop();
+
+    TimerWheel& m_timers;
+    TaskId m_nextId;
+    std::unordered_map<TaskId, Task::Handle> m_tasks;
+    std::vector<TaskId> m_frameWaiters;
+
+    // Async work queue and completions, shared with the worker thread
+    std::mutex m_mutex;
+    std::condition_variable m_workAvailable;
+    std::deque<std::pair<TaskId, AsyncAwaiter*>> m_work;
+    std::vector<TaskId> m_completed;
+    bool m_stopping;
+    std::thread m_worker;
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Hierarchical hashed timer wheel measured in ticks (Engine uses one tick per
+// simulation step).
+//
+// Four levels of 256 slots cover 2^32 ticks; longer delays park in the top level and
+// are re-filed as they get closer. Timers live in a pooled array of intrusive list
+// nodes, so scheduling and cancelling are O(1) and Advance() only touches timers that
+// fire or move down a level. Callbacks may schedule or cancel timers, including their own.
+class TimerWheel
+{
+public:
+    // Generation in the high 32 bits, pool index in the low 32; 0 is never a valid id
+    using TimerId = uint64_t;
+    using Callback = std::function<void()>;
+
+    static const TimerId INVALID_TIMER = 0;
+
+    TimerWheel();
+
+    // Fire once, delayTicks from now (at least one tick)
+    TimerId Schedule(uint64_t delayTicks, Callback callback);
+
+    // Fire every periodTicks (at least one), first firing one period from now.
+    // Periods are kept drift-free: each firing is scheduled from the previous deadline.
+    TimerId SchedulePeriodic(uint64_t periodTicks, Callback callback);
+
+    // Returns false if the timer already fired (one-shot) or was cancelled
+    bool Cancel(TimerId id);
+
+    // Advance time, running due callbacks in deadline order (same-tick order unspecified)
+    void Advance(uint64_t ticks = 1);
+
+    uint64_t GetCurrentTick() const { return m_nextTick - 1; }
+    size_t GetActiveCount() const { return m_activeCount; }
+
+private:
+    static const uint32_t LEVEL_BITS = 8;
+    static const uint32_t SLOTS_PER_LEVEL = 1u << LEVEL_BITS;
+    static const uint32_t LEVEL_COUNT = 4;
+    static const uint32_t SLOT_MASK = SLOTS_PER_LEVEL - 1;
+    static const uint32_t NO_NODE = 0xFFFFFFFFu;
+
+    // Sentinel nodes: one per slot plus the list being fired
+    static const uint32_t FIRING_LIST = LEVEL_COUNT * SLOTS_PER_LEVEL;
+    static const uint32_t FIRST_TIMER_NODE = FIRING_LIST + 1;
+
+    struct Node
+    {
+        uint32_t prev;
+        uint32_t next;
+        uint32_t generation;
+        bool active;
+        uint64_t deadline;
+        uint64_t period;        // 0 for one-shot timers
+        Callback callback;
+    };
+
+    TimerId Add(uint64_t delayTicks, uint64_t period, Callback callback);
+    void Insert(uint32_t index);
+    void Link(uint32_t list, uint32_t index);
+    void Unlink(uint32_t index);
+    void Release(uint32_t index);
+    void Cascade(uint32_t level, uint32_t slot);
+    void ProcessTick();
+
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_freeNodes;
+    uint64_t m_nextTick;        // The tick Advance() processes next
+    size_t m_activeCount;
+};
@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single-producer, single-consumer triple buffer for handing the latest value
+// from one thread to another. The producer always has a slot to write and never waits;
+// the consumer always reads a complete value and skips any it was too slow to see.
+//
+// Producer: fill WriteBuffer(), then Publish().
+// Consumer: Acquire() switches ReadBuffer() to the newest published value, if any.
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer()
+        : m_front(0)
+        , m_middle(1)
+        , m_back(2)
+    {
+    }
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Producer side
+    T& WriteBuffer() { return m_slots[m_back].value; }
+
+    void Publish()
+    {
+        // Hand the written slot over and take back whichever one was waiting
+        uint8_t previous = m_middle.exchange(static_cast<uint8_t>(m_back | FRESH), std::memory_order_acq_rel);
+        m_back = previous & INDEX_MASK;
+    }
+
+    // Consumer side; returns false (and keeps the current value) if nothing new was published
+    bool Acquire()
+    {
+        if (!(m_middle.load(std::memory_order_relaxed) & FRESH))
+            return false;
+
+        uint8_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & INDEX_MASK;
+        return true;
+    }
+
+    const T& ReadBuffer() const { return m_slots[m_front].value; }
+
+private:
+    static const uint8_t INDEX_MASK = 0x3;
+    static const uint8_t FRESH = 0x4;    // Middle slot holds a value the consumer has not seen
+
+    // Own cache lines so the two threads do not false-share
+    struct alignas(64) Slot
+    {
+        T value{};
+    };
+
+    Slot m_slots[3];
+    alignas(64) uint8_t m_front;                // Consumer only
+    alignas(64) std::atomic<uint8_t> m_middle;  // Slot index | FRESH
+    alignas(64) uint8_t m_back;                 // Producer only
+};
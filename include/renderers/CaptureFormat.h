@@ -0,0 +1,119 @@
+#pragma once
+#include <Windows.h>
+#include <cstdint>
+#include <string>
+
+// Binary draw-command capture format (.gecap).
+//
+// A fixed header followed by variable-size records. Every record starts on an 8-byte
+// boundary and text payloads are stored as null-terminated UTF-16, so a memory-mapped
+// file can be replayed without copying or decoding anything.
+namespace CaptureFormat
+{
+    const char MAGIC[8] = { 'G', 'E', 'C', 'A', 'P', 'T', 'U', 'R' };
+    const uint32_t VERSION = 1;
+    const uint32_t RECORD_ALIGNMENT = 8;
+
+    enum class RecordType : uint16_t
+    {
+        Initialize = 1,     // InitializePayload + renderer name (UTF-16)
+        BeginFrame = 2,     // No payload
+        Clear = 3,          // ClearPayload
+        DrawText = 4,       // TextPayload + text
+        MeasureText = 5,    // TextPayload (x, y hold the measured width, height) + text
+        EndFrame = 6        // No payload
+    };
+
+    struct FileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+    };
+
+    struct RecordHeader
+    {
+        RecordType type;
+        uint16_t reserved;
+        uint32_t size;          // Whole record including this header and padding
+        uint64_t timestampNs;   // Since the capture was opened
+    };
+
+    struct InitializePayload
+    {
+        uint32_t width;
+        uint32_t height;
+        uint32_t nameLength;    // Characters, excluding the terminator
+        uint32_t reserved;
+    };
+
+    struct ClearPayload
+    {
+        float r, g, b;
+        uint32_t reserved;
+    };
+
+    struct TextPayload
+    {
+        float x, y;
+        float fontSize;
+        float r, g, b;
+        uint32_t bold;
+        uint32_t textLength;    // Characters, excluding the terminator
+    };
+
+    static_assert(sizeof(FileHeader) % RECORD_ALIGNMENT == 0, "Header must keep records aligned");
+    static_assert(sizeof(RecordHeader) % RECORD_ALIGNMENT == 0, "Record header must keep payloads aligned");
+    static_assert(sizeof(wchar_t) == sizeof(uint16_t), "Captures store wchar_t text as UTF-16");
+
+    inline uint32_t AlignRecordSize(size_t size)
+    {
+        return static_cast<uint32_t>((size + RECORD_ALIGNMENT - 1) & ~static_cast<size_t>(RECORD_ALIGNMENT - 1));
+    }
+
+    // Text that follows a payload struct within a record
+    template <typename Payload>
+    const wchar_t* PayloadText(const Payload* payload)
+    {
+        return reinterpret_cast<const wchar_t*>(payload + 1);
+    }
+}
+
+// Read-only, memory-mapped view of a capture file
+class CaptureReader
+{
+public:
+    CaptureReader();
+    ~CaptureReader();
+
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+
+    // Map a capture file; throws std::runtime_error on failure
+    void Open(const std::wstring& fileName);
+    void Close();
+
+    // First record, or nullptr if the capture is empty
+    const CaptureFormat::RecordHeader* First() const;
+
+    // Record after the given one, or nullptr at the end (or on a truncated record)
+    const CaptureFormat::RecordHeader* Next(const CaptureFormat::RecordHeader* record) const;
+
+    // Payload immediately following a record header, or nullptr if the record is too
+    // small to hold it (a truncated or corrupt capture)
+    template <typename Payload>
+    static const Payload* GetPayload(const CaptureFormat::RecordHeader* record)
+    {
+        if (record->size < sizeof(CaptureFormat::RecordHeader) + sizeof(Payload))
+            return nullptr;
+        return reinterpret_cast<const Payload*>(record + 1);
+    }
+
+    size_t GetSize() const { return m_size; }
+
+private:
+    HANDLE m_file;
+    HANDLE m_mapping;
+    const uint8_t* m_data;
+    size_t m_size;
+};
@@ -0,0 +1,70 @@
+#pragma once
+#include "IRenderer.h"
+#include "CaptureFormat.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+// Appends capture records to a file. One writer can be shared by several
+// CaptureRenderers so a session survives renderer switches in a single capture.
+class CaptureWriter
+{
+public:
+    // Creates (truncates) the file; throws std::runtime_error on failure
+    explicit CaptureWriter(const std::wstring& fileName);
+    ~CaptureWriter();
+
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    void WriteInitialize(UINT width, UINT height, const char* rendererName);
+    void WriteBeginFrame();
+    void WriteClear(float r, float g, float b);
+    void WriteDrawText(const wchar_t* text, float x, float y, float fontSize,
+                       float r, float g, float b, bool bold);
+    void WriteMeasureText(const wchar_t* text, float fontSize, float width, float height);
+    void WriteEndFrame();
+
+    // Push buffered records to disk
+    void Flush();
+
+private:
+    void WriteRecord(CaptureFormat::RecordType type, const void* payload, size_t payloadSize,
+                     const wchar_t* text, size_t textLength);
+
+    FILE* m_file;
+    std::vector<uint8_t> m_buffer;      // Records are batched and written per frame
+    std::chrono::steady_clock::time_point m_startTime;
+};
+
+// IRenderer decorator that records every call before forwarding it to the wrapped renderer
+class CaptureRenderer : public IRenderer
+{
+public:
+    CaptureRenderer(std::unique_ptr<IRenderer> inner, std::shared_ptr<CaptureWriter> writer);
+    ~CaptureRenderer() override;
+
+    void Initialize(HWND hwnd, UINT width, UINT height) override;
+    void InitializeSuspended(HWND hwnd, UINT width, UINT height) override;
+    void BeginFrame() override;
+    void Clear(float r, float g, float b) override;
+    void DrawText(const wchar_t* text, float x, float y, float fontSize,
+                 float r, float g, float b, bool bold = false) override;
+    void MeasureText(const wchar_t* text, float fontSize,
+                    float& outWidth, float& outHeight) override;
+    void EndFrame() override;
+    bool IsPresentPaced() const override { return m_inner->IsPresentPaced(); }
+    void Resize(UINT width, UINT height) override;
+    void OnDestroy() override;
+    const char* GetName() const override { return m_inner->GetName(); }
+    const wchar_t* GetSpriteFontName(const wchar_t* text, float fontSize, float& outScale) const override { return m_inner->GetSpriteFontName(text, fontSize, outScale); }
+    void SetFramesInFlight(UINT frames) override { m_inner->SetFramesInFlight(frames); }
+    void SetResources(std::shared_ptr<ResourceManager> resources) override { m_inner->SetResources(std::move(resources)); }
+    void Suspend() override { m_inner->Suspend(); }
+    void Resume(UINT width, UINT height) override { m_inner->Resume(width, height); }
+
+private:
+    std::unique_ptr<IRenderer> m_inner;
+    std::shared_ptr<CaptureWriter> m_writer;
+};
@@ -3,7 +3,9 @@
 #include <d3d12.h>
 #include <dxgi1_6.h>
 #include <wrl/client.h>
+#include <future>
 #include <memory>
+#include <vector>
 
 // DirectXTK12 headers
 #include "SpriteBatch.h"
@@ -12,9 +14,20 @@
 #include "GraphicsMemory.h"
 #include "d3dx12.h"
 
+#include "ResourceManager.h"
+#include "GlyphCache.h"
+#include "Fence.h"
+#include "FrameRing.h"
+
 using Microsoft::WRL::ComPtr;
 
-// DirectX 12 renderer implementation
+// DirectX 12 renderer implementation. Up to MAX_FRAMES_IN_FLIGHT frames (2 by default)
+// are recorded ahead of the GPU, each with its own command allocator. While suspended
+// only the swap chain is released (GDI cannot draw over a flip-model swap chain); the
+// device, fonts and SpriteBatch pipeline stay resident. Fonts load in the background and
+// are uploaded as they become resident; until then text uses whichever font is uploaded.
+// With an outline font loaded, text is rasterized at the exact size into a GlyphCache
+// whose pages are mirrored in textures and drawn with the same SpriteBatch.
 class DX12Renderer : public IRenderer
 {
 public:
@@ -22,38 +35,141 @@ public:
     ~DX12Renderer() override;
 
     void Initialize(HWND hwnd, UINT width, UINT height) override;
+    void InitializeSuspended(HWND hwnd, UINT width, UINT height) override;
     void BeginFrame() override;
     void Clear(float r, float g, float b) override;
     void DrawText(const wchar_t* text, float x, float y, float fontSize,
                  float r, float g, float b, bool bold = false) override;
     void MeasureText(const wchar_t* text, float fontSize,
                     float& outWidth, float& outHeight) override;
+    const wchar_t* GetSpriteFontName(const wchar_t* text, float fontSize, float& outScale) const override;
     void EndFrame() override;
+    bool IsPresentPaced() const override { return true; }    // Present(1, 0)
+    void Resize(UINT width, UINT height) override;
     void OnDestroy() override;
     const char* GetName() const override { return "DirectX 12 Renderer"; }
+    void SetFramesInFlight(UINT frames) override { m_frames.SetDepth(frames); }
+    void SetResources(std::shared_ptr<ResourceManager> resources) override;
+    void Suspend() override;
+    void Resume(UINT width, UINT height) override;
 
 private:
-    void LoadPipeline(HWND hwnd);
+    // ID3D12Fence signaled by the command queue, as an IFence for FrameRing
+    class GpuFence : public IFence
+    {
+    public:
+        GpuFence() : event(nullptr) {}
+
+        uint64_t GetCompletedValue() const override { return fence ? fence->GetCompletedValue() : UINT64_MAX; }
+        void Wait(uint64_t value) override;
+
+        ComPtr<ID3D12Fence> fence;
+        HANDLE event;
+    };
+
+    // Per-frame transient storage, reused once the GPU has retired the frame
+    struct FrameContext
+    {
+        ComPtr<ID3D12CommandAllocator> commandAllocator;
+    };
+
+    // One size bucket. The metrics (used by MeasureText) are requested by the first
+    // measure and the atlas by the first draw; both are shared with other renderers, and
+    // only the texture and SpriteFont are created per device.
+    struct FontSlot
+    {
+        const wchar_t* fileName;
+        float size;                                 // Made at, in points
+        std::shared_future<FontHandle> metricsRequest;
+        std::shared_future<FontHandle> textureRequest;
+        FontHandle data;                            // Once the metrics are resident
+        ComPtr<ID3D12Resource> texture;
+        std::unique_ptr<DirectX::SpriteFont> font;  // Once the atlas is uploaded
+        bool failed;
+    };
+
+    static const int FONT_COUNT = 3;
+    static const int SMALL_FONT = 0;
+    static const int LARGE_FONT = 1;
+    static const int DIGITS_FONT = 2;   // The 120pt font cut to 0-9
+
+    // Sizes up to this are scaled from the 24pt font; larger ones from the 120pt font,
+    // which is a bold cut and would thicken text just above 24pt
+    static constexpr float LARGE_FONT_MIN_SIZE = 60.0f;
+
+    // Device, queue and everything else except the swap chain unless createSwapChain
+    void InitializeDevice(HWND hwnd, UINT width, UINT height, bool createSwapChain);
+    void LoadPipeline(bool createSwapChain);
+    void CreateSwapChain();
+    void CreateRenderTargets();
+    void SetViewportSize(UINT width, UINT height);
     void LoadAssets();
     void InitializeSpriteBatch();
-    void WaitForPreviousFrame();
 
-    static const UINT FRAME_COUNT = 2;
+    // Same size buckets as SoftwareRenderer: the 24pt font up to LARGE_FONT_MIN_SIZE, the
+    // 120pt font above it or its digits-only cut for text of only digits, drawn scaled to
+    // fontSize. A bucket that is still loading falls back to the 24pt font, and a digits cut
+    // that failed to load hands its text to the full 120pt font; drawn buckets are measured
+    // with the font they are drawn with. Null while no usable font is resident.
+    const FontSlot* SelectFont(const wchar_t* text, float fontSize, bool forDraw);
+    int GetFontIndex(const wchar_t* text, float fontSize) const;
+
+    // Pick up a bucket's metrics and upload its atlas once they are resident, without
+    // waiting for the copy
+    void PollFont(int index);
+
+    // One GlyphCache page as an R8 texture read as white with coverage alpha
+    struct OutlinePage
+    {
+        ComPtr<ID3D12Resource> texture;
+        uint64_t uploadedVersion = UINT64_MAX;  // Page version the texture holds
+        bool queued = false;                    // Sprites from it wait in the batch
+    };
+
+    // Glyphs bigger than a page, from text around 1000pt and up, are not drawn
+    static const uint32_t OUTLINE_PAGE_SIZE = 1024;
+    static const uint32_t OUTLINE_PAGE_COUNT = 4;
+
+    // The cache for the resource manager's outline font, or null if it has none
+    GlyphCache* GetOutlineCache();
+
+    void DrawOutlineText(GlyphCache& cache, const wchar_t* text, float x, float y, float fontSize,
+                         DirectX::FXMVECTOR color);
+
+    // Record copies of the pages whose pixels changed since they were last uploaded
+    void UploadOutlinePages();
+
+    // Submit the queued sprites with the pages as they are now and start a new batch, so
+    // a page can be rewritten without changing what was drawn from it
+    void FlushOutlineBatch();
+
+    D3D12_GPU_DESCRIPTOR_HANDLE GetOutlinePageHandle(uint32_t page) const;
+
+    // Upload a shared font texture into `texture` and wrap it in a SpriteFont
+    std::unique_ptr<DirectX::SpriteFont> CreateSpriteFont(TextureHandle font, DirectX::ResourceUploadBatch& upload,
+                                                          D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle,
+                                                          D3D12_GPU_DESCRIPTOR_HANDLE gpuHandle,
+                                                          ComPtr<ID3D12Resource>& texture);
+
+    // Wait until the GPU has finished every submitted frame
+    void WaitForGpu();
+
+    // Back buffers: one per frame in flight at the deepest queue
+    static const UINT FRAME_COUNT = MAX_FRAMES_IN_FLIGHT;
 
     // D3D12 Pipeline objects
+    ComPtr<IDXGIFactory4> m_factory;
     ComPtr<ID3D12Device> m_device;
     ComPtr<ID3D12CommandQueue> m_commandQueue;
     ComPtr<IDXGISwapChain3> m_swapChain;
     ComPtr<ID3D12DescriptorHeap> m_rtvHeap;
     ComPtr<ID3D12Resource> m_renderTargets[FRAME_COUNT];
-    ComPtr<ID3D12CommandAllocator> m_commandAllocator;
     ComPtr<ID3D12GraphicsCommandList> m_commandList;
 
     // Synchronization
-    UINT m_frameIndex;
-    HANDLE m_fenceEvent;
-    ComPtr<ID3D12Fence> m_fence;
-    UINT64 m_fenceValue;
+    UINT m_frameIndex;      // Current back buffer
+    GpuFence m_fence;
+    FrameRing<FrameContext> m_frames;
 
     // Viewport
     D3D12_VIEWPORT m_viewport;
@@ -63,9 +179,13 @@ private:
     // DirectXTK12 for text rendering
     std::unique_ptr<DirectX::GraphicsMemory> m_graphicsMemory;
     std::unique_ptr<DirectX::SpriteBatch> m_spriteBatch;
-    std::unique_ptr<DirectX::SpriteFont> m_font;          // 24pt
-    std::unique_ptr<DirectX::SpriteFont> m_largeFont;     // 120pt
-    ComPtr<ID3D12DescriptorHeap> m_fontHeap;
+    FontSlot m_fonts[FONT_COUNT];                   // 24pt, 120pt, 120pt digits; descriptors 0-2
+    ComPtr<ID3D12DescriptorHeap> m_fontHeap;        // Then one descriptor per outline page
+    std::shared_ptr<const TrueTypeFont> m_outlineFont;
+    std::unique_ptr<GlyphCache> m_outlineCache;
+    OutlinePage m_outlinePages[OUTLINE_PAGE_COUNT];
+    std::vector<std::future<void>> m_uploads;       // Keep staging memory until copied
+    std::shared_ptr<ResourceManager> m_resources;
 
     // State
     HWND m_hwnd;
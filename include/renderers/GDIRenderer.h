@@ -16,6 +16,7 @@ public:
     void MeasureText(const wchar_t* text, float fontSize,
                     float& outWidth, float& outHeight) override;
     void EndFrame() override;
+    void Resize(UINT width, UINT height) override;
     void OnDestroy() override;
     const char* GetName() const override { return "GDI Renderer"; }
 
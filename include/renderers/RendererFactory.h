@@ -0,0 +1,18 @@
+#pragma once
+#include "IRenderer.h"
+#include <memory>
+#include <string>
+
+// Renderer selection enum
+enum class RendererType
+{
+    GDI,
+    DirectX12,
+    Software
+};
+
+// Create renderer based on type
+std::unique_ptr<IRenderer> CreateRenderer(RendererType type);
+
+// Parse a backend name ("gdi", "dx12", "software"); returns false for unknown names
+bool ParseRendererType(const std::string& name, RendererType& outType);
@@ -0,0 +1,61 @@
+#pragma once
+#include "RendererFactory.h"
+#include "Engine.h"
+#include <functional>
+#include <future>
+#include <memory>
+
+// Keeps switched-out renderers initialized, so switching back is a Suspend/Resume pair
+// instead of OnDestroy plus a full Initialize (device and swap chain creation, font
+// upload, pipeline setup). Backends can also be initialized ahead of time on a
+// background thread, without a presentation surface: that is only created on the render
+// thread when the renderer is switched to. The pool owns the parked renderers; the
+// engine owns the current one.
+//
+// Switch and Clear are render-side calls, like Engine::SwitchRenderer.
+class RendererPool
+{
+public:
+    using Factory = std::function<std::unique_ptr<IRenderer>(RendererType)>;
+
+    explicit RendererPool(Factory factory = CreateRenderer);
+    ~RendererPool();
+
+    RendererPool(const RendererPool&) = delete;
+    RendererPool& operator=(const RendererPool&) = delete;
+
+    // Type of the renderer the engine currently holds (set after Engine::Initialize)
+    void SetCurrent(RendererType type) { m_current = static_cast<int>(type); }
+
+    // Start initializing a suspended `type` renderer (IRenderer::InitializeSuspended) for
+    // the engine's window on a background thread, unless one is current, parked or
+    // already on its way. The engine must have been
+    // initialized; its size is used and corrected on the first switch.
+    void Prewarm(const Engine& engine, RendererType type);
+
+    // Make a `type` renderer current. A parked renderer is resumed, a background
+    // initialization is waited for, and only otherwise is one created and initialized
+    // here. The previous renderer is parked. Returns true if no initialization ran on
+    // this call. Throws if creating or initializing the renderer fails.
+    bool Switch(Engine& engine, RendererType type);
+
+    bool IsWarm(RendererType type) const;
+
+    // Destroy every parked renderer (waiting for background initializations first)
+    void Clear();
+
+private:
+    static const int TYPE_COUNT = static_cast<int>(RendererType::Software) + 1;
+
+    struct Slot
+    {
+        std::unique_ptr<IRenderer> renderer;                    // Initialized and suspended
+        std::future<std::unique_ptr<IRenderer>> pending;        // Being prewarmed
+    };
+
+    std::unique_ptr<IRenderer> Create(RendererType type, const Engine& engine) const;
+
+    Factory m_factory;
+    Slot m_slots[TYPE_COUNT];
+    int m_current;
+};
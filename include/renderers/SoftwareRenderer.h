@@ -0,0 +1,159 @@
+#pragma once
+#include "IRenderer.h"
+#include "ResourceManager.h"
+#include "GlyphCache.h"
+#include "GlyphScaler.h"
+#include "Fence.h"
+#include "FrameRing.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// CPU renderer drawing into a BGRA framebuffer with the same sprite fonts as DX12Renderer.
+// Initialize with a null HWND for headless rendering (tests, tools); with a window,
+// finished frames are presented through SetDIBitsToDevice on a present thread while the
+// next frame is drawn into another framebuffer (2 frames in flight by default).
+// Fonts are loaded the first time a size bucket is measured or drawn. Windowed, they load
+// in the background and text uses whichever font is resident; headless, the first call
+// waits, so output does not depend on timing and measuring never loads atlas pixels.
+// Sizes other than the two the sprite fonts were made at are cut from the nearest larger
+// atlas (the largest beyond 120pt), filtered down or up and cached per size.
+// When the resource manager has an outline font, text is rasterized from it at the exact
+// size asked for instead, through a GlyphCache, and the sprite fonts are never loaded.
+class SoftwareRenderer : public IRenderer
+{
+public:
+    SoftwareRenderer();
+    ~SoftwareRenderer() override;
+
+    void Initialize(HWND hwnd, UINT width, UINT height) override;
+    void BeginFrame() override;
+    void Clear(float r, float g, float b) override;
+    void DrawText(const wchar_t* text, float x, float y, float fontSize,
+                 float r, float g, float b, bool bold = false) override;
+    void MeasureText(const wchar_t* text, float fontSize,
+                    float& outWidth, float& outHeight) override;
+    const wchar_t* GetSpriteFontName(const wchar_t* text, float fontSize, float& outScale) const override;
+    void EndFrame() override;
+    void Resize(UINT width, UINT height) override;
+    void OnDestroy() override;
+    const char* GetName() const override { return "Software Renderer"; }
+    void SetFramesInFlight(UINT frames) override;
+    void SetResources(std::shared_ptr<ResourceManager> resources) override;
+    void Suspend() override;
+    void Resume(UINT width, UINT height) override;
+
+    // Framebuffer readback: 0xAARRGGBB pixels, top-down, GetWidth() pixels per row. The
+    // last frame ended, or the one being drawn before any EndFrame.
+    const uint32_t* GetPixels() const { return m_displayed->pixels.data(); }
+    UINT GetWidth() const { return m_width; }
+    UINT GetHeight() const { return m_height; }
+
+    // Glyph cache activity: the outline font's, or with sprite fonts the scaled glyphs'
+    // of both sizes together
+    GlyphCacheStats GetGlyphCacheStats() const;
+
+private:
+    // A font's shared data, resolved from its handles for one call, with the scale from
+    // the size it was made at. The atlas and scaled glyphs are null for measuring; all are
+    // null while no font is resident.
+    struct Font
+    {
+        const GlyphTable* glyphs;
+        const CoverageAtlas* atlas;
+        GlyphCache* scaled;
+        float scale;
+    };
+
+    // One size bucket. Its metrics are requested by the first MeasureText and its
+    // coverage atlas by the first DrawText that needs it.
+    struct FontSlot
+    {
+        const wchar_t* fileName;
+        float size;                             // Made at, in points
+        std::shared_future<FontHandle> metricsRequest;
+        std::shared_future<FontHandle> coverageRequest;
+        FontHandle font;        // Once the metrics are resident
+        AtlasHandle atlas;      // Once the coverage atlas is resident
+        bool failed;
+        std::unique_ptr<GlyphCache> scaled;     // Glyphs at other sizes, cut from the atlas
+    };
+
+    static const int FONT_COUNT = 3;
+    static const int SMALL_FONT = 0;
+    static const int LARGE_FONT = 1;
+    static const int DIGITS_FONT = 2;   // The 120pt font cut to 0-9
+
+    // Sizes up to this are scaled from the 24pt font; larger ones from the 120pt font,
+    // which is a bold cut and would thicken text just above 24pt
+    static constexpr float LARGE_FONT_MIN_SIZE = 60.0f;
+
+    // Same size buckets as DX12Renderer: the 24pt font up to LARGE_FONT_MIN_SIZE, the 120pt
+    // font above it, or its digits-only cut for text of only digits. A bucket that is still
+    // loading falls back to the 24pt font, and a digits cut that failed to load hands its
+    // text to the full 120pt font. Buckets that have been drawn are measured with the font
+    // they are drawn with, so layout matches what is drawn.
+    Font SelectFont(const wchar_t* text, float fontSize, bool forDraw);
+    int GetFontIndex(const wchar_t* text, float fontSize) const;
+
+    // Request a bucket's metrics or coverage the first time; waits when headless
+    void RequestFont(FontSlot& slot, bool forDraw);
+
+    // Pick up parts of a bucket that became resident since the last call
+    void PollFont(FontSlot& slot);
+
+    // One framebuffer per frame in flight
+    struct FrameContext
+    {
+        std::vector<uint32_t> pixels;
+    };
+
+    struct PresentJob
+    {
+        const FrameContext* frame;
+        uint64_t fenceValue;
+    };
+
+    void BlitGlyph(const Font& font, const SpriteFontGlyph& glyph, int destX, int destY, uint32_t color);
+
+    // The cache for the resource manager's outline font, or null if it has none
+    GlyphCache* GetOutlineCache();
+
+    void DrawOutlineText(GlyphCache& cache, const wchar_t* text, float x, float y, float fontSize, uint32_t color);
+    void BlitCoverage(const CachedGlyph& glyph, int destX, int destY, uint32_t color);
+
+    // Size the framebuffer to the current client area
+    void PrepareFrame(FrameContext& frame);
+
+    void StartPresentThread();
+    void StopPresentThread();
+    void PresentLoop();
+
+    HWND m_hwnd;
+    UINT m_width;
+    UINT m_height;
+    HDC m_windowDC;     // Used by the present thread only
+
+    // Frames in flight, retired by the present thread (immediately when headless)
+    CpuFence m_presentFence;
+    FrameRing<FrameContext> m_frames;
+    UINT m_framesInFlight;
+    FrameContext* m_target;             // Being drawn
+    const FrameContext* m_displayed;    // Last ended
+
+    std::mutex m_presentMutex;
+    std::condition_variable m_presentReady;
+    std::deque<PresentJob> m_presentQueue;
+    bool m_stopPresenting;
+    std::thread m_presentThread;
+
+    std::shared_ptr<ResourceManager> m_resources;
+    FontSlot m_fonts[FONT_COUNT];       // 24pt, 120pt, 120pt digits
+    std::shared_ptr<const TrueTypeFont> m_outlineFont;
+    std::unique_ptr<GlyphCache> m_outlineCache;
+};
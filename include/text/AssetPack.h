@@ -0,0 +1,140 @@
+#pragma once
+#include <Windows.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Single-file asset pack format (.gepack).
+//
+// A fixed header, a bucket table, the entry table, the entry names and then the payloads.
+// Entries are sorted by the hash of their name and the bucket table holds the first entry
+// of every run of hashes sharing their top bits, so a lookup is one bucket read and a
+// short scan. Every payload starts on a page boundary, so a payload of a mapped pack can
+// be handed out as a pointer without copying, and pages of one pack mapped by several
+// processes are shared in the page cache.
+namespace AssetPackFormat
+{
+    const char MAGIC[8] = { 'G', 'E', 'A', 'S', 'S', 'E', 'T', 'S' };
+    const uint32_t VERSION = 1;
+    const uint32_t PAYLOAD_ALIGNMENT = 4096;
+
+    struct FileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t entryCount;
+        uint32_t bucketBits;        // 1 << bucketBits buckets
+        uint64_t bucketsOffset;     // uint32_t[buckets + 1]: first entry of each bucket, then entryCount
+        uint64_t entriesOffset;     // Entry[entryCount], sorted by hash
+        uint64_t namesOffset;       // Null-terminated UTF-16 names (char16_t)
+        uint64_t fileSize;
+    };
+
+    struct Entry
+    {
+        uint64_t hash;
+        uint64_t offset;            // Payload, from the start of the file
+        uint64_t size;
+        uint32_t nameOffset;        // Characters from namesOffset
+        uint32_t nameLength;        // Characters, excluding the terminator
+    };
+
+    static_assert(sizeof(FileHeader) % 8 == 0, "Header must keep the tables aligned");
+    static_assert(sizeof(Entry) % 8 == 0, "Entries must stay aligned");
+
+    // 64-bit FNV-1a over the UTF-16 code units; names are matched exactly
+    template <typename Char>
+    uint64_t HashName(const Char* name, size_t length)
+    {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (size_t i = 0; i < length; i++)
+        {
+            hash ^= static_cast<uint16_t>(name[i]);
+            hash *= 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    inline uint32_t GetBucket(uint64_t hash, uint32_t bucketBits)
+    {
+        return bucketBits ? static_cast<uint32_t>(hash >> (64 - bucketBits)) : 0;
+    }
+
+    inline uint64_t AlignPayloadOffset(uint64_t offset)
+    {
+        return (offset + PAYLOAD_ALIGNMENT - 1) & ~static_cast<uint64_t>(PAYLOAD_ALIGNMENT - 1);
+    }
+}
+
+// Bytes of one asset inside a mapped pack
+struct AssetView
+{
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    explicit operator bool() const { return data != nullptr; }
+};
+
+// Read-only, memory-mapped view of an asset pack. Views stay valid until the pack is
+// closed; const calls are thread-safe.
+class AssetPack
+{
+public:
+    AssetPack();
+    ~AssetPack();
+
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+
+    // Map a pack and validate its index; throws std::runtime_error on failure
+    void Open(const std::wstring& fileName);
+    void Close();
+
+    bool IsOpen() const { return m_data != nullptr; }
+
+    // Payload of the named asset, or a null view if the pack has no such asset
+    AssetView Find(const wchar_t* name) const;
+
+    // Entries in index (hash) order
+    size_t GetEntryCount() const { return m_header ? m_header->entryCount : 0; }
+    std::wstring GetName(size_t index) const;
+    AssetView GetAsset(size_t index) const;
+
+    size_t GetSize() const { return m_size; }
+
+private:
+    const AssetPackFormat::Entry* GetEntries() const;
+    const char16_t* GetNameData(size_t index) const;
+
+    HANDLE m_file;
+    HANDLE m_mapping;
+    const uint8_t* m_data;
+    size_t m_size;
+    const AssetPackFormat::FileHeader* m_header;
+};
+
+// Builds a pack from assets held in memory
+class AssetPackWriter
+{
+public:
+    // Names must be unique; throws std::runtime_error on a duplicate
+    void Add(const std::wstring& name, std::vector<uint8_t> data);
+
+    // Add a file from disk under its file name without the directory
+    void AddFile(const std::wstring& path);
+
+    // Throws std::runtime_error on I/O errors
+    void Write(const std::wstring& fileName) const;
+
+    size_t GetCount() const { return m_assets.size(); }
+
+private:
+    struct Asset
+    {
+        std::wstring name;
+        std::vector<uint8_t> data;
+    };
+
+    std::vector<Asset> m_assets;
+};
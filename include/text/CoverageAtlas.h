@@ -0,0 +1,105 @@
+#pragma once
+#include "SpriteFontFile.h"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// How a CoverageAtlas stores its pixels
+enum class CoverageEncoding
+{
+    Dense,      // Every pixel at 8 bits, one run per row: the decoded texture as is
+    Compact,    // Only the covered runs of each row, at 4 bits per pixel when the source
+                // has no more precision than that (BC2, B4G4R4A4)
+};
+
+// Coverage image of a sprite font atlas, decoded once for the CPU text path and sampled
+// in place by the glyph blit. Sprite font atlases are white with premultiplied alpha, so
+// alpha alone is the glyph shape.
+//
+// Each row is a sorted list of runs of pixels; everything between runs is empty. Most of
+// a glyph atlas is padding and empty rows, so the compact encoding keeps a fraction of
+// the dense size, and blits skip the empty spans instead of testing every pixel.
+struct CoverageAtlas
+{
+    // Columns [begin, begin + length) of a row, stored from pixel `offset` of data
+    struct Run
+    {
+        uint16_t begin;
+        uint16_t length;
+        uint32_t offset;
+    };
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t bitsPerPixel = 8;          // 8, or 4 with two pixels per byte, low nibble first
+    std::vector<uint32_t> rowRuns;      // height + 1 entries: the first run of each row
+    std::vector<Run> runs;
+    std::vector<uint8_t> data;
+
+    // Call cover(x, alpha) for each pixel of row y in [left, right) with non-zero coverage
+    // (alpha 1-255), left to right
+    template <typename Cover>
+    void ForEachCovered(uint32_t y, uint32_t left, uint32_t right, Cover&& cover) const
+    {
+        const Run* first = runs.data() + rowRuns[y];
+        const Run* last = runs.data() + rowRuns[y + 1];
+        const Run* run = std::partition_point(first, last,
+            [left](const Run& r) { return static_cast<uint32_t>(r.begin) + r.length <= left; });
+
+        for (; run != last && run->begin < right; ++run)
+        {
+            uint32_t from = std::max<uint32_t>(run->begin, left);
+            uint32_t to = std::min<uint32_t>(run->begin + run->length, right);
+            uint32_t pixel = run->offset + (from - run->begin);
+
+            if (bitsPerPixel == 8)
+            {
+                for (uint32_t x = from; x < to; x++, pixel++)
+                {
+                    if (uint32_t alpha = data[pixel])
+                        cover(x, alpha);
+                }
+            }
+            else
+            {
+                // Two pixels per byte once on an even pixel
+                uint32_t x = from;
+                if ((pixel & 1) && x < to)
+                {
+                    if (uint32_t alpha = (data[pixel >> 1] >> 4) * 17)
+                        cover(x, alpha);
+                    x++;
+                    pixel++;
+                }
+                const uint8_t* source = data.data() + (pixel >> 1);
+                for (; x + 1 < to; x += 2, source++)
+                {
+                    uint32_t pair = *source;
+                    if (!pair)
+                        continue;
+                    if (uint32_t alpha = (pair & 0xF) * 17)
+                        cover(x, alpha);
+                    if (uint32_t alpha = (pair >> 4) * 17)
+                        cover(x + 1, alpha);
+                }
+                if (x < to)
+                {
+                    if (uint32_t alpha = (*source & 0xF) * 17)
+                        cover(x, alpha);
+                }
+            }
+        }
+    }
+
+    // Coverage of one pixel, 0-255
+    uint8_t Sample(uint32_t x, uint32_t y) const;
+
+    // Pixel data plus run tables
+    size_t GetByteSize() const;
+
+    // Decode the atlas of a font loaded with its texture. Supports the formats
+    // MakeSpriteFont writes (BC2 compressed mono, R8G8B8A8, B8G8R8A8, B4G4R4A4).
+    // Throws std::runtime_error for anything else.
+    static CoverageAtlas FromSpriteFont(const SpriteFontData& font,
+                                        CoverageEncoding encoding = CoverageEncoding::Compact);
+};
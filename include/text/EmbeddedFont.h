@@ -0,0 +1,117 @@
+#pragma once
+#include "SpriteFontFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+struct EmbeddedTextSize
+{
+    float width = 0.0f;
+    float height = 0.0f;
+};
+
+// A sprite font compiled into the binary: FontCooker --header writes the glyph records and
+// atlas bytes as constexpr tables (see GRAPHICS_ENGINE_EMBED_FONTS in CMakeLists.txt).
+// Nothing is read from disk, and text in a known font can be measured by the compiler.
+struct EmbeddedFont
+{
+    const wchar_t* name;                // Asset it replaces, e.g. L"arial24.spritefont"
+    const SpriteFontGlyph* glyphs;      // Sorted by character
+    size_t glyphCount;
+    float lineSpacing;
+    uint32_t defaultCharacter;
+    uint32_t textureWidth;
+    uint32_t textureHeight;
+    uint32_t textureFormat;
+    uint32_t textureStride;
+    uint32_t textureRows;
+    const uint8_t* texture;             // textureStride * textureRows bytes
+
+    // Measure text exactly as GlyphTable::MeasureText (and so SpriteFont::MeasureString)
+    // does; usable in constant expressions
+    constexpr EmbeddedTextSize MeasureText(const wchar_t* text) const
+    {
+        float x = 0.0f;
+        float y = 0.0f;
+        EmbeddedTextSize size;
+
+        for (; *text; text++)
+        {
+            wchar_t character = *text;
+            if (character == L'\r')
+                continue;
+
+            if (character == L'\n')
+            {
+                x = 0.0f;
+                y += lineSpacing;
+                continue;
+            }
+
+            const SpriteFontGlyph* glyph = FindGlyph(static_cast<uint32_t>(character));
+            if (!glyph)
+                continue;
+
+            float glyphWidth = static_cast<float>(glyph->right - glyph->left);
+            float glyphHeight = static_cast<float>(glyph->bottom - glyph->top);
+            bool whitespace = IsWhitespace(glyph->character);
+
+            x += glyph->xOffset;
+            if (x < 0.0f)
+                x = 0.0f;
+
+            // Blank whitespace glyphs are skipped entirely
+            if (!whitespace || glyphWidth > 1.0f || glyphHeight > 1.0f)
+            {
+                float bottom = whitespace ? lineSpacing
+                                          : (glyphHeight + glyph->yOffset > lineSpacing ? glyphHeight + glyph->yOffset : lineSpacing);
+                size.width = x + glyphWidth > size.width ? x + glyphWidth : size.width;
+                size.height = y + bottom > size.height ? y + bottom : size.height;
+            }
+
+            x += glyphWidth + glyph->xAdvance;
+        }
+
+        return size;
+    }
+
+    // Glyph for a character, falling back to the default character; nullptr if neither
+    constexpr const SpriteFontGlyph* FindGlyph(uint32_t character) const
+    {
+        if (const SpriteFontGlyph* glyph = FindExact(character))
+            return glyph;
+        return defaultCharacter ? FindExact(defaultCharacter) : nullptr;
+    }
+
+    // The font as SpriteFontFile would load it; the texture refers to the embedded bytes
+    SpriteFontData ToSpriteFontData(bool loadTexture) const;
+
+private:
+    constexpr const SpriteFontGlyph* FindExact(uint32_t character) const
+    {
+        size_t low = 0;
+        size_t high = glyphCount;
+        while (low < high)
+        {
+            size_t middle = (low + high) / 2;
+            if (glyphs[middle].character < character)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+        return low < glyphCount && glyphs[low].character == character ? &glyphs[low] : nullptr;
+    }
+
+    // iswspace, for constant expressions
+    static constexpr bool IsWhitespace(uint32_t character)
+    {
+        return character == 0x20 || (character >= 0x09 && character <= 0x0D) || character == 0x85 ||
+               character == 0xA0 || character == 0x1680 || (character >= 0x2000 && character <= 0x200A) ||
+               character == 0x2028 || character == 0x2029 || character == 0x202F || character == 0x205F ||
+               character == 0x3000;
+    }
+};
+
+// Fonts compiled into this build, empty unless it was configured with
+// GRAPHICS_ENGINE_EMBED_FONTS
+std::span<const EmbeddedFont* const> GetEmbeddedFonts();
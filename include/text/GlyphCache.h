@@ -0,0 +1,142 @@
+#pragma once
+#include "TrueTypeFont.h"
+#include "GlyphRasterizer.h"
+#include "SkylinePacker.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// A cached glyph: 8-bit coverage and where it goes relative to the pen
+struct CachedGlyph
+{
+    const uint8_t* pixels = nullptr;    // Top-left coverage pixel, null when empty
+    uint32_t stride = 0;
+    GlyphBitmap bitmap;
+    float advance = 0.0f;               // Pixels
+
+    // Where the pixels sit in the cache, for renderers that mirror pages as textures.
+    // GlyphCache::NO_PAGE for glyphs without pixels and glyphs too big for a page.
+    uint32_t page = UINT32_MAX;
+    uint32_t x = 0;
+    uint32_t y = 0;
+};
+
+struct GlyphCacheStats
+{
+    uint64_t hits = 0;
+    uint64_t misses = 0;                // Rendered
+    uint64_t uncached = 0;              // Too big for a page; rendered on every use
+    uint64_t evictedPages = 0;
+    uint64_t evictedGlyphs = 0;
+    uint64_t renderedPixels = 0;
+    double renderMs = 0.0;
+    size_t residentGlyphs = 0;
+    size_t pages = 0;
+};
+
+// What a GlyphCache renders glyphs from. Render always follows a Measure of the same
+// glyph and size, so a source can keep what it prepared for the one between the two.
+class GlyphSource
+{
+public:
+    virtual ~GlyphSource() = default;
+
+    // Bitmap rectangle and advance (pixels) of a glyph at a font size
+    virtual GlyphBitmap Measure(uint16_t glyph, float fontSize, float& outAdvance) = 0;
+
+    // 8-bit coverage into the measured rectangle, `stride` bytes per row. Writes every pixel.
+    virtual void Render(uint16_t glyph, float fontSize, const GlyphBitmap& bitmap,
+                        uint8_t* output, size_t stride) = 0;
+};
+
+// Glyphs rasterized from a TrueType font's outlines, sized like GDI (TrueTypeFont::GetScale)
+class OutlineGlyphSource : public GlyphSource
+{
+public:
+    explicit OutlineGlyphSource(std::shared_ptr<const TrueTypeFont> font);
+
+    GlyphBitmap Measure(uint16_t glyph, float fontSize, float& outAdvance) override;
+    void Render(uint16_t glyph, float fontSize, const GlyphBitmap& bitmap,
+                uint8_t* output, size_t stride) override;
+
+private:
+    std::shared_ptr<const TrueTypeFont> m_font;
+    GlyphRasterizer m_rasterizer;
+    GlyphOutline m_outline;     // Of the glyph measured last
+};
+
+// Glyphs from a GlyphSource, rendered on first use at whatever sizes text is drawn and
+// kept in fixed-size coverage pages packed with a SkylinePacker.
+//
+// When a glyph fits in no page and all pages are allocated, the least recently used page
+// is emptied and reused: eviction is per page, so packing never has to find holes, and
+// glyphs drawn together in a frame tend to share a page and stay resident together.
+// BeginFrame advances the recency clock.
+//
+// Pixels returned by GetGlyph stay valid until the next GetGlyph or Clear, which is all a
+// blit needs. Renderers that draw from textures instead upload the pages whose version
+// changed, and set an eviction handler to submit draws from a page before it is reused.
+// Not thread-safe; each renderer keeps its own cache.
+class GlyphCache
+{
+public:
+    static const uint32_t NO_PAGE = UINT32_MAX;
+
+    // Called with a page about to be emptied for new glyphs, while it still holds the old ones
+    using EvictionHandler = std::function<void(uint32_t page)>;
+
+    GlyphCache(std::unique_ptr<GlyphSource> source, uint32_t pageSize = 512, uint32_t maxPages = 4);
+
+    // A glyph at a font size, rendered on a miss. Sizes are distinguished to 1/64 pixel.
+    const CachedGlyph& GetGlyph(uint16_t glyph, float fontSize);
+
+    void BeginFrame() { m_frame++; }
+
+    // Drop every glyph; pages stay allocated
+    void Clear();
+
+    GlyphCacheStats GetStats() const;
+    void ResetStats();
+
+    size_t GetResidentBytes() const { return m_pages.size() * static_cast<size_t>(m_pageSize) * m_pageSize; }
+
+    // Pages: pageSize x pageSize coverage, one byte per pixel, allocated as glyphs need them
+    uint32_t GetPageSize() const { return m_pageSize; }
+    size_t GetPageCount() const { return m_pages.size(); }
+    const uint8_t* GetPagePixels(uint32_t page) const { return m_pages[page].pixels.data(); }
+
+    // Changes whenever glyphs are rendered into the page
+    uint64_t GetPageVersion(uint32_t page) const { return m_pages[page].version; }
+
+    void SetEvictionHandler(EvictionHandler handler) { m_evictionHandler = std::move(handler); }
+
+private:
+    struct Page
+    {
+        std::vector<uint8_t> pixels;
+        SkylinePacker packer;
+        std::vector<uint64_t> keys;     // Glyphs resident on this page
+        uint64_t lastUse = 0;
+        uint64_t version = 0;
+    };
+
+    // Room for a width x height bitmap, evicting the least recently used page if needed
+    uint32_t Allocate(uint32_t width, uint32_t height, uint32_t& outX, uint32_t& outY);
+    void EvictPage(uint32_t page);
+
+    std::unique_ptr<GlyphSource> m_source;
+    uint32_t m_pageSize;
+    uint32_t m_maxPages;
+    std::vector<Page> m_pages;
+    std::unordered_map<uint64_t, CachedGlyph> m_glyphs;
+    uint64_t m_frame;
+    EvictionHandler m_evictionHandler;
+
+    // Glyphs bigger than a page, rendered here each time
+    std::vector<uint8_t> m_scratch;
+    CachedGlyph m_scratchGlyph;
+
+    GlyphCacheStats m_stats;
+};
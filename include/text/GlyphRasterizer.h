@@ -0,0 +1,47 @@
+#pragma once
+#include "TrueTypeFont.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Pixel rectangle a glyph covers at some scale, relative to the pen on the baseline
+struct GlyphBitmap
+{
+    int32_t left = 0;       // Columns right of the pen
+    int32_t top = 0;        // Rows above the baseline
+    uint32_t width = 0;
+    uint32_t height = 0;
+};
+
+// Signed-area outline rasterizer: every edge adds its exact signed area to the pixels it
+// crosses, and one running sum over the buffer turns those into coverage. Antialiasing is
+// analytic (no supersampling), and the cost is proportional to the edge length plus the
+// bitmap area. Quadratic curves are flattened into as few lines as keep them within a
+// fraction of a pixel.
+//
+// Not thread-safe; keeps its accumulation buffer between calls.
+class GlyphRasterizer
+{
+public:
+    // Bitmap rectangle of an outline scaled by `scale` (pixels per font unit)
+    static GlyphBitmap Measure(const GlyphOutline& outline, float scale);
+
+    // Rasterize an outline into a bitmap from Measure with the same scale: 8-bit coverage,
+    // `stride` bytes per row. Writes every pixel of the rectangle.
+    void Rasterize(const GlyphOutline& outline, float scale, const GlyphBitmap& bitmap,
+                   uint8_t* output, size_t stride);
+
+private:
+    struct Point
+    {
+        float x;
+        float y;
+    };
+
+    void DrawLine(Point from, Point to);
+    void DrawQuadratic(Point from, Point control, Point to);
+
+    std::vector<float> m_accumulation;
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+};
@@ -0,0 +1,65 @@
+#pragma once
+#include "GlyphCache.h"
+#include "GlyphTable.h"
+#include "CoverageAtlas.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Resamples glyph subrects of a coverage atlas to another size with a separable tent
+// filter as wide as one destination pixel: bilinear when enlarging, an area-weighted
+// average of every covered source pixel when shrinking, so small sizes cut from a large
+// atlas keep their thin strokes instead of aliasing.
+//
+// Rows are filtered horizontally into 16-bit fixed point, then whole destination rows are
+// blended from those with SSE2 where available. Not thread-safe; keeps its buffers.
+class GlyphScaler
+{
+public:
+    // Destination rectangle of a width x height subrect scaled by `scale`, relative to
+    // where the subrect's top-left corner lands: one pixel of margin on each side holds
+    // the filter's tails
+    static GlyphBitmap Measure(uint32_t width, uint32_t height, float scale);
+
+    // Scale the atlas subrect at (left, top) into a bitmap from Measure with the same size
+    // and scale, `stride` bytes per row. Writes every pixel.
+    void Scale(const CoverageAtlas& atlas, uint32_t left, uint32_t top, uint32_t width, uint32_t height,
+               float scale, const GlyphBitmap& bitmap, uint8_t* output, size_t stride);
+
+private:
+    // Source taps of each destination pixel along one axis, with fixed-point weights
+    struct Filter
+    {
+        std::vector<uint32_t> first;        // Per destination pixel, into taps/weights
+        std::vector<uint32_t> taps;         // Source pixel indices
+        std::vector<uint16_t> weights;
+    };
+
+    static void BuildFilter(uint32_t sourceSize, float scale, uint32_t destinationSize,
+                            uint32_t one, Filter& filter);
+
+    Filter m_columns;
+    Filter m_rows;
+    std::vector<uint8_t> m_sourceRow;
+    std::vector<uint16_t> m_filtered;       // Source rows at destination width
+};
+
+// Glyphs of a sprite font cut from its coverage atlas at any size, scaled from the size
+// the font was made at. The glyph table and atlas must outlive the source.
+class SpriteGlyphSource : public GlyphSource
+{
+public:
+    SpriteGlyphSource(const GlyphTable& glyphs, const CoverageAtlas& atlas, float fontSize);
+
+    // Bitmaps are placed relative to the glyph's scaled top-left corner (its subrect
+    // origin at the pen, moved by the scaled offsets), not a baseline
+    GlyphBitmap Measure(uint16_t glyph, float fontSize, float& outAdvance) override;
+    void Render(uint16_t glyph, float fontSize, const GlyphBitmap& bitmap,
+                uint8_t* output, size_t stride) override;
+
+private:
+    const GlyphTable& m_glyphs;
+    const CoverageAtlas& m_atlas;
+    float m_fontSize;
+    GlyphScaler m_scaler;
+};
@@ -0,0 +1,210 @@
+#pragma once
+#include "ResourcePool.h"
+#include "AssetPack.h"
+#include "EmbeddedFont.h"
+#include "SpriteFontFile.h"
+#include "GlyphTable.h"
+#include "CoverageAtlas.h"
+#include "TrueTypeFont.h"
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A sprite font's metrics: glyph records, line spacing and the atlas description, which
+// is all text measurement needs. The atlas pixels are separate resources, read or
+// decoded the first time something draws with the font.
+struct FontResource
+{
+    std::wstring fileName;
+    SpriteFontData data;                        // Loaded without the atlas pixels
+    GlyphTable glyphs;
+    ResourceHandle<SpriteFontData> texture;     // Read on first GetFontTexture
+    ResourceHandle<CoverageAtlas> coverage;     // Decoded on first GetCoverageAtlas
+};
+
+using FontHandle = ResourceHandle<FontResource>;
+using TextureHandle = ResourceHandle<SpriteFontData>;
+using AtlasHandle = ResourceHandle<CoverageAtlas>;
+
+// How much of a font a request makes resident; each level includes the ones before it
+enum class FontPart
+{
+    Metrics,    // Glyph table, for measuring
+    Texture,    // Encoded atlas, for GPU upload
+    Coverage,   // Decoded 8-bit atlas, for the CPU text path
+};
+
+enum class AssetLoadState
+{
+    Queued,
+    Loading,
+    Resident,
+    Failed
+};
+
+// One background load and where its time went
+struct AssetLoadRecord
+{
+    std::wstring name;
+    FontPart part = FontPart::Metrics;
+    AssetLoadState state = AssetLoadState::Queued;
+    double queuedMs = 0.0;      // Waiting for a worker thread
+    double readMs = 0.0;        // File reads and glyph table
+    double decodeMs = 0.0;      // Coverage atlas, for FontPart::Coverage
+    double totalMs = 0.0;       // Request to resident (or failed)
+    std::string error;
+};
+
+struct AssetLoadProgress
+{
+    size_t requested = 0;
+    size_t resident = 0;
+    size_t failed = 0;
+
+    bool IsComplete() const { return resident + failed == requested; }
+    float GetFraction() const { return requested ? static_cast<float>(resident + failed) / requested : 1.0f; }
+};
+
+// CPU-side assets shared by every renderer an Engine creates. Fonts are read and decoded
+// once and stay resident across renderer switches; renderers keep handles and only
+// create their own device objects (textures, SpriteFonts) from the shared data.
+//
+// Handles go stale when their resource is released, and resolving a stale handle throws
+// instead of reading freed or reused memory. All calls are thread-safe, so a renderer
+// can initialize on a background thread while another draws; files are read and atlases
+// decoded outside the lock. References from GetFont and GetAtlas stay valid until the
+// resource is released.
+//
+// RequestFont loads on a worker thread so a renderer can draw its first frames before
+// its fonts are resident; it polls FindFont and falls back to whatever is resident.
+// GetResidencyVersion changes whenever a font or atlas becomes resident, which is when
+// text laid out with a fallback needs measuring again.
+//
+// With an asset pack mounted, fonts it contains are parsed straight from the mapping and
+// their atlas pixels are used in place; everything else is still read from loose files.
+// Mounted embedded fonts come first and are never read from anywhere.
+class ResourceManager
+{
+public:
+    ResourceManager() = default;
+    ~ResourceManager();
+
+    ResourceManager(const ResourceManager&) = delete;
+    ResourceManager& operator=(const ResourceManager&) = delete;
+
+    // Look fonts up in `pack` before the file system. Mount before loading anything:
+    // fonts already resident stay as they were loaded.
+    void MountPack(std::shared_ptr<const AssetPack> pack);
+    std::shared_ptr<const AssetPack> GetPack() const;
+
+    // Serve fonts compiled into the binary (GetEmbeddedFonts) under their asset names,
+    // ahead of the pack and the file system. Mount before loading anything.
+    void MountEmbeddedFonts(std::span<const EmbeddedFont* const> fonts);
+
+    // Read a TrueType font from the mounted pack or the file system and make it the outline
+    // font, which renderers that rasterize glyphs (SoftwareRenderer, DX12Renderer) draw text
+    // with at any size instead of the sprite fonts. Throws std::runtime_error on I/O or
+    // format errors.
+    std::shared_ptr<const TrueTypeFont> LoadOutlineFont(const wchar_t* fileName);
+
+    // Null unless an outline font was loaded
+    std::shared_ptr<const TrueTypeFont> GetOutlineFont() const;
+
+    // Load a .spritefont's metrics, or return the already loaded copy. withTexture also
+    // makes the encoded atlas resident, taking the metrics from the same file read.
+    // Throws std::runtime_error on I/O or format errors.
+    FontHandle LoadFont(const wchar_t* fileName, bool withTexture = false);
+
+    // The font file again with its encoded atlas, read once per font
+    TextureHandle GetFontTexture(FontHandle font);
+
+    // Coverage image of a font's atlas for the CPU text path, decoded once per font
+    AtlasHandle GetCoverageAtlas(FontHandle font);
+
+    // Encoding for atlases decoded from now on (Compact by default)
+    void SetCoverageEncoding(CoverageEncoding encoding) { m_coverageEncoding = encoding; }
+
+    // Start making `part` of a font resident on a worker thread. Repeated requests share
+    // one load, and a request builds on an outstanding request for a lower part. The
+    // future rethrows load errors; waiting on it is optional. Failed loads are forgotten,
+    // so a later request tries again.
+    std::shared_future<FontHandle> RequestFont(const wchar_t* fileName, FontPart part = FontPart::Metrics);
+
+    // Null until the font, its texture or its coverage atlas is resident
+    FontHandle FindFont(const wchar_t* fileName) const;
+    TextureHandle FindFontTexture(FontHandle font) const;
+    AtlasHandle FindCoverageAtlas(FontHandle font) const;
+
+    uint64_t GetResidencyVersion() const { return m_residencyVersion.load(); }
+
+    // Background loads issued by RequestFont, in request order
+    AssetLoadProgress GetLoadProgress() const;
+    std::vector<AssetLoadRecord> GetLoadRecords() const;
+
+    // Throw std::runtime_error for null or stale handles
+    const FontResource& GetFont(FontHandle font) const;
+    const SpriteFontData& GetTexture(TextureHandle texture) const;
+    const CoverageAtlas& GetAtlas(AtlasHandle atlas) const;
+
+    bool IsValid(FontHandle font) const;
+    bool IsValid(TextureHandle texture) const;
+    bool IsValid(AtlasHandle atlas) const;
+
+    // Drop a font with its texture and decoded atlas; outstanding handles go stale
+    void ReleaseFont(FontHandle font);
+
+    size_t GetFontCount() const;
+    size_t GetTextureCount() const;
+    size_t GetAtlasCount() const;
+
+    // Bytes of font data held: glyph records, encoded textures and decoded atlases. Atlas
+    // pixels used in place from a mounted pack (page cache) or an embedded font (part of
+    // the binary) are not counted here.
+    size_t GetResidentBytes() const;
+
+    // Files read and atlases decoded, versus requests answered from memory
+    uint64_t GetLoadCount() const { return m_loads.load(); }
+    uint64_t GetCacheHitCount() const { return m_cacheHits.load(); }
+
+private:
+    const EmbeddedFont* FindEmbeddedFont(const std::wstring& fileName) const;
+
+    // Fonts and atlases are few and large, so the pools hold them by pointer: adding one
+    // must not move the others while another thread is reading them
+    ResourcePool<std::unique_ptr<FontResource>, FontResource> m_fonts;
+    ResourcePool<std::unique_ptr<SpriteFontData>, SpriteFontData> m_textures;
+    ResourcePool<std::unique_ptr<CoverageAtlas>, CoverageAtlas> m_atlases;
+    std::unordered_map<std::wstring, FontHandle> m_fontsByName;
+    std::shared_ptr<const AssetPack> m_pack;
+    std::vector<const EmbeddedFont*> m_embeddedFonts;
+    std::shared_ptr<const TrueTypeFont> m_outlineFont;
+    mutable std::shared_mutex m_mutex;
+
+    std::atomic<uint64_t> m_loads{ 0 };
+    std::atomic<uint64_t> m_cacheHits{ 0 };
+    std::atomic<uint64_t> m_residencyVersion{ 0 };
+    std::atomic<CoverageEncoding> m_coverageEncoding{ CoverageEncoding::Compact };
+
+    static const int FONT_PART_COUNT = static_cast<int>(FontPart::Coverage) + 1;
+
+    struct FontRequest
+    {
+        std::shared_future<FontHandle> future;
+        size_t record;      // Into m_records
+    };
+
+    // Requests that failed are dropped the next time their font is requested. Needs
+    // m_requestMutex.
+    bool HasFailed(const FontRequest& request) const { return m_records[request.record].state == AssetLoadState::Failed; }
+
+    // Background loads, keyed by file name, per FontPart
+    std::unordered_map<std::wstring, FontRequest> m_requests[FONT_PART_COUNT];
+    std::vector<AssetLoadRecord> m_records;
+    mutable std::mutex m_requestMutex;
+};
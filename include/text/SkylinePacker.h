@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Skyline rectangle packer for glyph atlases.
+//
+// The packed area is tracked as its top outline: a list of horizontal segments, left to
+// right. A rectangle goes where it would rest lowest on the outline (bottom-left), ties
+// going to the placement that wastes the least width, so glyphs sorted by height pack
+// into tight rows. Rectangles can be added at any time; nothing already placed moves.
+class SkylinePacker
+{
+public:
+    SkylinePacker();
+    SkylinePacker(uint32_t width, uint32_t height);
+
+    // Start over with an empty area
+    void Reset(uint32_t width, uint32_t height);
+
+    // Place a width x height rectangle. Returns false, leaving the packer unchanged,
+    // when there is no room for it.
+    bool Insert(uint32_t width, uint32_t height, uint32_t& outX, uint32_t& outY);
+
+    uint32_t GetWidth() const { return m_width; }
+    uint32_t GetHeight() const { return m_height; }
+
+    // Bottom of the lowest-reaching rectangle so far
+    uint32_t GetUsedHeight() const { return m_usedHeight; }
+
+    // Area covered by placed rectangles
+    uint64_t GetUsedArea() const { return m_usedArea; }
+
+private:
+    struct Segment
+    {
+        uint32_t x;
+        uint32_t y;         // Top of the packed area below this segment
+        uint32_t width;
+    };
+
+    // Lowest y at which a rectangle starting at segment `index` clears the outline, or
+    // UINT32_MAX if it would run past the right or bottom edge
+    uint32_t Fit(size_t index, uint32_t width, uint32_t height) const;
+
+    std::vector<Segment> m_skyline;
+    uint32_t m_width;
+    uint32_t m_height;
+    uint32_t m_usedHeight;
+    uint64_t m_usedArea;
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// One glyph record as stored in a DirectXTK .spritefont file.
+// Layout matches DirectX::SpriteFont::Glyph so the two can be used interchangeably.
+struct SpriteFontGlyph
+{
+    uint32_t character;
+    int32_t left;       // Subrect in the atlas texture
+    int32_t top;
+    int32_t right;
+    int32_t bottom;
+    float xOffset;
+    float yOffset;
+    float xAdvance;
+};
+
+static_assert(sizeof(SpriteFontGlyph) == 32, "SpriteFontGlyph must match the on-disk glyph layout");
+
+// CPU-side contents of a .spritefont file (MakeSpriteFont output)
+struct SpriteFontData
+{
+    std::vector<SpriteFontGlyph> glyphs;   // Sorted by character
+    float lineSpacing = 0.0f;
+    uint32_t defaultCharacter = 0;
+
+    // Atlas texture description (DXGI format, block-compressed rows)
+    uint32_t textureWidth = 0;
+    uint32_t textureHeight = 0;
+    uint32_t textureFormat = 0;
+    uint32_t textureStride = 0;
+    uint32_t textureRows = 0;
+
+    // Atlas pixel data - empty when loaded metrics-only
+    std::vector<uint8_t> textureData;
+
+    // Set instead of textureData when the pixels are read in place from mapped memory,
+    // which `storage` keeps alive
+    const uint8_t* mappedTexture = nullptr;
+    std::shared_ptr<const void> storage;
+
+    const uint8_t* GetTextureData() const { return mappedTexture ? mappedTexture : textureData.data(); }
+    size_t GetTextureSize() const
+    {
+        return mappedTexture ? static_cast<size_t>(textureStride) * textureRows : textureData.size();
+    }
+};
+
+// Reader for the DirectXTK sprite font format
+class SpriteFontFile
+{
+public:
+    // Load a .spritefont from disk. With loadTexture == false only the header and glyph
+    // table are read, which is all that text measurement needs.
+    // Throws std::runtime_error on I/O or format errors.
+    static SpriteFontData Load(const wchar_t* fileName, bool loadTexture = true);
+
+    // Parse a .spritefont already resident in memory
+    static SpriteFontData Parse(const uint8_t* data, size_t size, bool loadTexture = true);
+
+    // Parse a .spritefont in mapped memory that `storage` keeps alive; the atlas pixels are
+    // referenced in place instead of copied
+    static SpriteFontData Map(const uint8_t* data, size_t size, std::shared_ptr<const void> storage);
+
+    // Encode a font and its texture in the .spritefont format
+    static std::vector<uint8_t> Serialize(const SpriteFontData& font);
+
+    // Write a font loaded with its texture; throws std::runtime_error on I/O errors
+    static void Save(const SpriteFontData& font, const wchar_t* fileName);
+
+private:
+    enum class TextureMode { Skip, Copy, Reference };
+
+    static SpriteFontData ParseBlob(const uint8_t* data, size_t size, TextureMode texture);
+};
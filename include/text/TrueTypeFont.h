@@ -0,0 +1,106 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Glyph outline in font units, y up: closed contours of quadratic B-spline points, where
+// two off-curve points in a row imply an on-curve point halfway between them
+struct GlyphOutline
+{
+    struct Point
+    {
+        float x;
+        float y;
+        bool onCurve;
+    };
+
+    std::vector<Point> points;
+    std::vector<uint32_t> contourEnds;  // One past the last point of each contour
+    float xMin = 0.0f;
+    float yMin = 0.0f;
+    float xMax = 0.0f;
+    float yMax = 0.0f;
+
+    bool IsEmpty() const { return contourEnds.empty(); }
+};
+
+// Reader for TrueType (glyf outline) font files: character mapping, horizontal metrics
+// and outlines, including composite glyphs. Everything is validated by the constructor,
+// so lookups do not throw.
+//
+// Sizes follow GDI's CreateFont height: a font of size N has a cell (win ascent plus win
+// descent) N pixels tall, so text matches what the GDI backend draws at the same size.
+class TrueTypeFont
+{
+public:
+    // Parse a font file image. Throws std::runtime_error for anything but a valid
+    // TrueType outline font.
+    explicit TrueTypeFont(std::vector<uint8_t> data);
+
+    // Read and parse a .ttf file; throws std::runtime_error on I/O or format errors
+    static std::shared_ptr<TrueTypeFont> Load(const wchar_t* fileName);
+
+    // Glyph index of a character, 0 (the missing glyph) if the font lacks it
+    uint16_t FindGlyph(uint32_t character) const;
+
+    uint16_t GetGlyphCount() const { return m_glyphCount; }
+    uint16_t GetUnitsPerEm() const { return m_unitsPerEm; }
+
+    // Font units to pixels for a font of the given size
+    float GetScale(float fontSize) const { return fontSize / m_cellHeight; }
+
+    // Cell metrics in font units: ascent above and descent below the baseline
+    float GetAscent() const { return m_ascent; }
+    float GetDescent() const { return m_descent; }
+
+    // Advance width in font units
+    float GetAdvance(uint16_t glyph) const;
+
+    // Size of text at fontSize in pixels, from advances only: the widest line rounded up,
+    // and a cell per line, as GDI lays it out
+    void MeasureText(const wchar_t* text, float fontSize, float& outWidth, float& outHeight) const;
+
+    // Outline of a glyph; empty for glyphs without contours (spaces)
+    void GetOutline(uint16_t glyph, GlyphOutline& outline) const;
+
+private:
+    struct Table
+    {
+        uint32_t offset = 0;
+        uint32_t length = 0;
+    };
+
+    Table FindTable(const char tag[4]) const;
+    void ParseCharacterMap(const Table& cmap);
+    void AppendGlyph(uint16_t glyph, const float transform[6], int depth, GlyphOutline& outline) const;
+    bool GetGlyphData(uint16_t glyph, uint32_t& offset, uint32_t& length) const;
+
+    uint16_t Read16(size_t offset) const;
+    uint32_t Read32(size_t offset) const;
+
+    std::vector<uint8_t> m_data;
+    uint16_t m_glyphCount;
+    uint16_t m_unitsPerEm;
+    uint16_t m_horizontalMetricCount;
+    bool m_longLocations;
+    float m_ascent;
+    float m_descent;
+    float m_cellHeight;
+    Table m_glyf;
+    Table m_loca;
+    Table m_hmtx;
+
+    // Character ranges mapped to glyphs, sorted by first character
+    struct CharacterRange
+    {
+        uint32_t first;
+        uint32_t last;
+        uint32_t glyphOffset;   // Into m_rangeGlyphs, or UINT32_MAX for a delta mapping
+        int32_t delta;
+    };
+
+    std::vector<CharacterRange> m_ranges;
+    std::vector<uint16_t> m_rangeGlyphs;
+    uint16_t m_latinGlyphs[256];        // Direct lookup for U+0000-U+00FF
+};
@@ -0,0 +1,83 @@
+#include "StartupProfiler.h"
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+
+// GraphicsEngine's replacement global allocation functions: every form of operator new
+// and delete, with allocations reported to the startup profiler. Linked into the
+// application only, so the library and tools keep the default allocator.
+
+namespace
+{
+    void* Allocate(std::size_t size)
+    {
+        StartupProfiler::CountAllocation(size);
+        for (;;)
+        {
+            if (void* memory = std::malloc(size ? size : 1))
+                return memory;
+            std::new_handler handler = std::get_new_handler();
+            if (!handler)
+                throw std::bad_alloc();
+            handler();
+        }
+    }
+
+    // Over-aligned types; freed with _aligned_free, never free
+    void* AllocateAligned(std::size_t size, std::align_val_t alignment)
+    {
+        StartupProfiler::CountAllocation(size);
+        for (;;)
+        {
+            if (void* memory = _aligned_malloc(size ? size : 1, static_cast<std::size_t>(alignment)))
+                return memory;
+            std::new_handler handler = std::get_new_handler();
+            if (!handler)
+                throw std::bad_alloc();
+            handler();
+        }
+    }
+
+    template <typename Allocator, typename... Args>
+    void* AllocateNoThrow(Allocator allocator, Args... args) noexcept
+    {
+        try
+        {
+            return allocator(args...);
+        }
+        catch (...)
+        {
+            return nullptr;
+        }
+    }
+}
+
+void* operator new(std::size_t size) { return Allocate(size); }
+void* operator new[](std::size_t size) { return Allocate(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return AllocateNoThrow(Allocate, size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return AllocateNoThrow(Allocate, size); }
+
+void* operator new(std::size_t size, std::align_val_t alignment) { return AllocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return AllocateAligned(size, alignment); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return AllocateNoThrow(AllocateAligned, size, alignment);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return AllocateNoThrow(AllocateAligned, size, alignment);
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { std::free(memory); }
+
+void operator delete(void* memory, std::align_val_t) noexcept { _aligned_free(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { _aligned_free(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { _aligned_free(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { _aligned_free(memory); }
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept { _aligned_free(memory); }
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept { _aligned_free(memory); }
@@ -0,0 +1,44 @@
+#include "CommandLine.h"
+#include <windows.h>
+#include <shellapi.h>
+
+std::vector<std::string> GetUtf8Arguments(int argc, char* argv[])
+{
+    std::vector<std::string> arguments;
+    int count = 0;
+    LPWSTR* argvW = CommandLineToArgvW(GetCommandLineW(), &count);
+    if (!argvW)
+    {
+        if (argv)
+            arguments.assign(argv, argv + argc);
+        return arguments;
+    }
+
+    arguments.reserve(count);
+    for (int i = 0; i < count; i++)
+        arguments.push_back(WideToUtf8(argvW[i]));
+    LocalFree(argvW);
+    return arguments;
+}
+
+std::wstring Utf8ToWide(const std::string& text)
+{
+    if (text.empty())
+        return std::wstring();
+
+    int length = MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), nullptr, 0);
+    std::wstring wide(length, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), wide.data(), length);
+    return wide;
+}
+
+std::string WideToUtf8(const std::wstring& text)
+{
+    if (text.empty())
+        return std::string();
+
+    int length = WideCharToMultiByte(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), nullptr, 0, nullptr, nullptr);
+    std::string utf8(length, '\0');
+    WideCharToMultiByte(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), utf8.data(), length, nullptr, nullptr);
+    return utf8;
+}
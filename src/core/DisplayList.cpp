@@ -0,0 +1,87 @@
+#include "DisplayList.h"
+#include "IRenderer.h"
+#include <cwchar>
+
+DisplayList::DisplayList()
+    : m_version(0)
+{
+}
+
+void DisplayList::Reset()
+{
+    m_commands.clear();
+    m_text.clear();
+    m_version++;
+}
+
+void DisplayList::AddClear(float r, float g, float b)
+{
+    Command command = {};
+    command.type = CommandType::Clear;
+    command.r = r;
+    command.g = g;
+    command.b = b;
+    m_commands.push_back(command);
+}
+
+void DisplayList::AddText(const wchar_t* text, float x, float y, float fontSize,
+                          float r, float g, float b, bool bold)
+{
+    size_t length = wcslen(text);
+
+    Command command = {};
+    command.type = CommandType::Text;
+    command.bold = bold;
+    command.r = r;
+    command.g = g;
+    command.b = b;
+    command.x = x;
+    command.y = y;
+    command.fontSize = fontSize;
+    command.textOffset = static_cast<uint32_t>(m_text.size());
+    command.textLength = static_cast<uint32_t>(length);
+
+    m_text.insert(m_text.end(), text, text + length + 1);
+    m_commands.push_back(command);
+}
+
+void DisplayList::Append(const DisplayList& other)
+{
+    // Text offsets are relative to the pool they were recorded into
+    const uint32_t textBase = static_cast<uint32_t>(m_text.size());
+    for (Command command : other.m_commands)
+    {
+        if (command.type == CommandType::Text)
+            command.textOffset += textBase;
+        m_commands.push_back(command);
+    }
+    m_text.insert(m_text.end(), other.m_text.begin(), other.m_text.end());
+}
+
+void DisplayList::Reserve(size_t commands, size_t textCharacters)
+{
+    m_commands.reserve(commands);
+    m_text.reserve(textCharacters);
+}
+
+void DisplayList::Replay(IRenderer& renderer) const
+{
+    renderer.BeginFrame();
+
+    for (const Command& command : m_commands)
+    {
+        switch (command.type)
+        {
+        case CommandType::Clear:
+            renderer.Clear(command.r, command.g, command.b);
+            break;
+
+        case CommandType::Text:
+            renderer.DrawText(GetText(command), command.x, command.y, command.fontSize,
+                              command.r, command.g, command.b, command.bold);
+            break;
+        }
+    }
+
+    renderer.EndFrame();
+}
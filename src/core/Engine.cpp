@@ -1,16 +1,87 @@
 #include "Engine.h"
+#include "ResourceManager.h"
+#include "EmbeddedFont.h"
+#include <algorithm>
+#include <cwchar>
+#include <iterator>
 #include <string>
 
-Engine::Engine(UINT width, UINT height)
+#ifdef GRAPHICS_ENGINE_EMBEDDED_FONTS
+#include "Embedded_arial24.h"
+#endif
+
+namespace
+{
+    constexpr wchar_t TITLE_TEXT[] = L"Random Number Generator";
+    constexpr wchar_t MESSAGE_TEXT[] = L"Updates every 5 seconds";
+
+#ifdef GRAPHICS_ENGINE_EMBEDDED_FONTS
+    // The constant labels, laid out by the compiler in the font they are drawn with
+    constexpr bool LABELS_PRECOMPUTED = true;
+    constexpr const wchar_t* LABEL_FONT_NAME = EmbeddedFonts::arial24.name;
+    constexpr EmbeddedTextSize TITLE_SIZE = EmbeddedFonts::arial24.MeasureText(TITLE_TEXT);
+    constexpr EmbeddedTextSize MESSAGE_SIZE = EmbeddedFonts::arial24.MeasureText(MESSAGE_TEXT);
+#else
+    constexpr bool LABELS_PRECOMPUTED = false;
+    constexpr const wchar_t* LABEL_FONT_NAME = L"";
+    constexpr EmbeddedTextSize TITLE_SIZE = {};
+    constexpr EmbeddedTextSize MESSAGE_SIZE = {};
+#endif
+
+    // Size of a constant label: its compile-time layout, scaled to fontSize, when the
+    // renderer draws it with the embedded label font, otherwise measured by the renderer
+    void MeasureLabel(IRenderer& renderer, const wchar_t* text, float fontSize, const EmbeddedTextSize& size,
+                      float& outWidth, float& outHeight)
+    {
+        float scale;
+        const wchar_t* fontName = renderer.GetSpriteFontName(text, fontSize, scale);
+        if (LABELS_PRECOMPUTED && fontName && wcscmp(fontName, LABEL_FONT_NAME) == 0)
+        {
+            outWidth = size.width * scale;
+            outHeight = size.height * scale;
+            return;
+        }
+        renderer.MeasureText(text, fontSize, outWidth, outHeight);
+    }
+
+    constexpr float NUMBER_COLOR[3] = { 1.0f, 1.0f, 0.39f };     // Yellow
+
+    void GetNumberColor(int number, float color[3])
+    {
+        color[0] = 0.3f + (number % 100) / 300.0f;
+        color[1] = 0.4f + ((number / 10) % 100) / 300.0f;
+        color[2] = 0.6f + ((number / 100) % 100) / 300.0f;
+    }
+}
+
+Engine::Engine(UINT width, UINT height, std::shared_ptr<IClock> clock)
     : m_hwnd(nullptr)
     , m_width(width)
     , m_height(height)
+    , m_resources(std::make_shared<ResourceManager>())
     , m_randomNumber(0)
+    , m_clock(clock ? std::move(clock) : std::make_shared<SteadyClock>())
+    , m_updateInterval(std::chrono::seconds(5))
+    , m_updateCount(0)
+    , m_fixedStep(std::chrono::nanoseconds(16666667))
+    , m_maxStepsPerUpdate(8)
+    , m_previousClockTime(0)
+    , m_accumulator(0)
+    , m_simulationTime(0)
+    , m_droppedTime(0)
+    , m_stepCount(0)
+    , m_tasks(m_timers)
+    , m_refreshTask(TaskScheduler::INVALID_TASK)
+    , m_rendered{ -1 }
+    , m_sceneDirty(true)
+    , m_resourceVersion(0)
 {
     std::random_device rd;
     m_rng.seed(rd());
     UpdateRandomNumber();
-    m_lastUpdateTime = std::chrono::steady_clock::now();
+    PublishSnapshot();
+    ScheduleRefresh();
+    m_previousClockTime = m_clock->Now();
 }
 
 Engine::~Engine()
@@ -21,27 +92,135 @@ void Engine::Initialize(HWND hwnd, std::unique_ptr<IRenderer> renderer)
 {
     m_hwnd = hwnd;
     m_renderer = std::move(renderer);
+    m_renderer->SetResources(m_resources);
     m_renderer->Initialize(hwnd, m_width, m_height);
+    m_sceneDirty = true;
 }
 
 void Engine::Update()
 {
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - m_lastUpdateTime);
+    IClock::Duration now = m_clock->Now();
+    m_accumulator += std::max(now - m_previousClockTime, IClock::Duration::zero());
+    m_previousClockTime = now;
+
+    uint32_t steps = 0;
+    while (m_accumulator >= m_fixedStep && steps < m_maxStepsPerUpdate)
+    {
+        Step();
+        m_accumulator -= m_fixedStep;
+        steps++;
+    }
+
+    // Out of catch-up budget: drop the backlog rather than trying to repay it next time
+    if (m_accumulator >= m_fixedStep)
+    {
+        IClock::Duration remainder = m_accumulator % m_fixedStep;
+        m_droppedTime += m_accumulator - remainder;
+        m_accumulator = remainder;
+    }
+
+    m_tasks.RunFrame();
+    PublishSnapshot();
+}
+
+void Engine::Step()
+{
+    m_simulationTime += m_fixedStep;
+    m_stepCount++;
+
+    // Timers and the tasks delayed on them, including the number refresh
+    m_timers.Advance(1);
+}
+
+void Engine::PublishSnapshot()
+{
+    Snapshot& snapshot = m_snapshots.WriteBuffer();
+    snapshot.number = m_randomNumber;
+    std::swprintf(snapshot.numberText, std::size(snapshot.numberText), L"%d", m_randomNumber);
+    GetNumberColor(m_randomNumber, snapshot.background);
+    std::copy(std::begin(NUMBER_COLOR), std::end(NUMBER_COLOR), snapshot.numberColor);
+    m_snapshots.Publish();
+}
 
-    if (elapsed.count() >= 5)
+Task Engine::RefreshNumbers()
+{
+    for (;;)
     {
+        co_await Delay(m_updateInterval);
         UpdateRandomNumber();
-        m_lastUpdateTime = now;
+        m_updateCount++;
     }
 }
 
+void Engine::ScheduleRefresh()
+{
+    m_tasks.Cancel(m_refreshTask);
+    m_refreshTask = m_tasks.Spawn(RefreshNumbers());
+}
+
+uint64_t Engine::ToTicks(IClock::Duration duration) const
+{
+    // Round up so timers never fire early
+    uint64_t ticks = static_cast<uint64_t>((duration + m_fixedStep - IClock::Duration(1)) / m_fixedStep);
+    return std::max<uint64_t>(ticks, 1);
+}
+
+TimerWheel::TimerId Engine::ScheduleTimer(IClock::Duration delay, TimerWheel::Callback callback, bool periodic)
+{
+    return periodic ? m_timers.SchedulePeriodic(ToTicks(delay), std::move(callback))
+                    : m_timers.Schedule(ToTicks(delay), std::move(callback));
+}
+
+void Engine::SetUpdateInterval(IClock::Duration interval)
+{
+    m_updateInterval = interval;
+    ScheduleRefresh();
+}
+
+void Engine::SetFixedTimestep(IClock::Duration step)
+{
+    m_fixedStep = std::max(step, IClock::Duration(1));
+    ScheduleRefresh();
+}
+
+float Engine::GetStepFraction() const
+{
+    return static_cast<float>(static_cast<double>(m_accumulator.count()) / m_fixedStep.count());
+}
+
 void Engine::Render()
 {
     if (!m_renderer)
         return;
 
-    RenderScene();
+    // Keeps drawing the last snapshot if the update side has not published a new one
+    m_snapshots.Acquire();
+    const Snapshot& snapshot = m_snapshots.ReadBuffer();
+
+    // The text and colors follow the number
+    if (snapshot.number != m_rendered.number)
+    {
+        m_rendered = snapshot;
+        m_sceneDirty = true;
+        UpdateWindowTitle();
+    }
+
+    // Fonts finishing a background load change text metrics, as do renderer switches
+    uint64_t resourceVersion = m_resources->GetResidencyVersion();
+    if (resourceVersion != m_resourceVersion)
+    {
+        m_resourceVersion = resourceVersion;
+        m_sceneDirty = true;
+    }
+
+    // Layout depends on the renderer's text metrics, so the list is rebuilt on switches too
+    if (m_sceneDirty)
+    {
+        BuildScene();
+        m_sceneDirty = false;
+    }
+
+    m_renderer->DrawDisplayList(m_displayList);
 }
 
 void Engine::OnDestroy()
@@ -62,63 +241,109 @@ void Engine::SwitchRenderer(std::unique_ptr<IRenderer> newRenderer)
     if (m_renderer)
         m_renderer->OnDestroy();
 
+    // Fonts loaded by earlier renderers are still resident in m_resources
     m_renderer = std::move(newRenderer);
+    m_renderer->SetResources(m_resources);
     m_renderer->Initialize(m_hwnd, m_width, m_height);
+    m_sceneDirty = true;
 
-    // Force immediate redraw
-    InvalidateRect(m_hwnd, nullptr, TRUE);
-    UpdateWindow(m_hwnd);
+    // Force immediate redraw (headless engines have no window)
+    if (m_hwnd)
+    {
+        InvalidateRect(m_hwnd, nullptr, TRUE);
+        UpdateWindow(m_hwnd);
+    }
+}
+
+std::unique_ptr<IRenderer> Engine::SwapRenderer(std::unique_ptr<IRenderer> renderer)
+{
+    if (m_renderer)
+        m_renderer->Suspend();
+
+    // The window may have been resized while this renderer was parked
+    renderer->Resume(m_width, m_height);
+    std::swap(m_renderer, renderer);
+    m_sceneDirty = true;
+
+    if (m_hwnd)
+    {
+        InvalidateRect(m_hwnd, nullptr, TRUE);
+        UpdateWindow(m_hwnd);
+    }
+    return renderer;
+}
+
+void Engine::Resize(UINT width, UINT height)
+{
+    if (width == 0 || height == 0 || (width == m_width && height == m_height))
+        return;
+
+    m_width = width;
+    m_height = height;
+    if (m_renderer)
+        m_renderer->Resize(width, height);
+
+    // Layout is centered on the window size
+    m_sceneDirty = true;
+}
+
+void Engine::SetSeed(uint32_t seed)
+{
+    m_rng.seed(seed);
+    UpdateRandomNumber();
+    PublishSnapshot();
+    ScheduleRefresh();
 }
 
 void Engine::UpdateRandomNumber()
 {
     std::uniform_int_distribution<int> dist(0, 9999);
     m_randomNumber = dist(m_rng);
+}
 
-    // Update window title with the random number
+void Engine::UpdateWindowTitle()
+{
+    // Update window title with the displayed number
     if (m_hwnd)
     {
         std::string rendererName = GetRendererName();
         std::wstring title = L"Graphics Engine - ";
         title += std::wstring(rendererName.begin(), rendererName.end());
-        title += L" - Random Number: " + std::to_wstring(m_randomNumber);
+        title += L" - Random Number: ";
+        title += m_rendered.numberText;
         SetWindowTextW(m_hwnd, title.c_str());
     }
 }
 
-void Engine::RenderScene()
+void Engine::BuildScene()
 {
-    // Calculate color based on random number
-    float r = 0.3f + (m_randomNumber % 100) / 300.0f;
-    float g = 0.4f + ((m_randomNumber / 10) % 100) / 300.0f;
-    float b = 0.6f + ((m_randomNumber / 100) % 100) / 300.0f;
-
-    m_renderer->BeginFrame();
-    m_renderer->Clear(r, g, b);
+    // Background color based on the displayed number
+    const float* background = m_rendered.background;
+    m_displayList.Reset();
+    m_displayList.AddClear(background[0], background[1], background[2]);
 
     // Draw engine name (top left)
     std::wstring rendererName(GetRendererName(), GetRendererName() + strlen(GetRendererName()));
-    m_renderer->DrawText(rendererName.c_str(), 40.0f, 30.0f, 24.0f, 1.0f, 1.0f, 1.0f);
+    m_displayList.AddText(rendererName.c_str(), 40.0f, 30.0f, 24.0f, 1.0f, 1.0f, 1.0f);
 
     // Draw title (centered at top)
     float titleWidth, titleHeight;
-    m_renderer->MeasureText(L"Random Number Generator", 24.0f, titleWidth, titleHeight);
+    MeasureLabel(*m_renderer, TITLE_TEXT, 24.0f, TITLE_SIZE, titleWidth, titleHeight);
     float titleX = (m_width - titleWidth) / 2.0f;
-    m_renderer->DrawText(L"Random Number Generator", titleX, 80.0f, 24.0f, 1.0f, 1.0f, 1.0f);
+    m_displayList.AddText(TITLE_TEXT, titleX, 80.0f, 24.0f, 1.0f, 1.0f, 1.0f);
 
     // Draw large number (centered)
-    std::wstring numberText = std::to_wstring(m_randomNumber);
+    const wchar_t* numberText = m_rendered.numberText;
+    const float* numberColor = m_rendered.numberColor;
     float numberWidth, numberHeight;
-    m_renderer->MeasureText(numberText.c_str(), 120.0f, numberWidth, numberHeight);
+    m_renderer->MeasureText(numberText, 120.0f, numberWidth, numberHeight);
     float numberX = (m_width - numberWidth) / 2.0f;
     float numberY = (m_height - numberHeight) / 2.0f;
-    m_renderer->DrawText(numberText.c_str(), numberX, numberY, 120.0f, 1.0f, 1.0f, 0.39f, true); // Yellow, bold
+    m_displayList.AddText(numberText, numberX, numberY, 120.0f, numberColor[0], numberColor[1], numberColor[2], true); // Bold
 
     // Draw update message (bottom center)
     float messageWidth, messageHeight;
-    m_renderer->MeasureText(L"Updates every 5 seconds", 20.0f, messageWidth, messageHeight);
+    MeasureLabel(*m_renderer, MESSAGE_TEXT, 20.0f, MESSAGE_SIZE, messageWidth, messageHeight);
     float messageX = (m_width - messageWidth) / 2.0f;
-    m_renderer->DrawText(L"Updates every 5 seconds", messageX, m_height - 100.0f, 20.0f, 0.78f, 0.78f, 0.78f);
-
-    m_renderer->EndFrame();
+    m_displayList.AddText(MESSAGE_TEXT, messageX, m_height - 100.0f, 20.0f, 0.78f, 0.78f, 0.78f);
 }
@@ -0,0 +1,217 @@
+#include "EngineThreads.h"
+#include "Engine.h"
+#include "Logger.h"
+#include <mmsystem.h>
+#include <dwmapi.h>
+#include <algorithm>
+#include <chrono>
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+namespace
+{
+    // Sleeps to well under a millisecond. Windows' default timer tick is ~15.6 ms, so a
+    // plain sleep would bunch 60 Hz steps. This uses a high-resolution waitable timer
+    // (Windows 10 1803 and later), or raises the system timer resolution to 1 ms while
+    // the timer exists.
+    class PrecisionSleeper
+    {
+    public:
+        PrecisionSleeper()
+            : m_timer(CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS))
+            , m_raisedResolution(!m_timer && timeBeginPeriod(1) == TIMERR_NOERROR)
+        {
+        }
+
+        ~PrecisionSleeper()
+        {
+            if (m_timer)
+                CloseHandle(m_timer);
+            if (m_raisedResolution)
+                timeEndPeriod(1);
+        }
+
+        PrecisionSleeper(const PrecisionSleeper&) = delete;
+        PrecisionSleeper& operator=(const PrecisionSleeper&) = delete;
+
+        void Sleep(std::chrono::nanoseconds duration)
+        {
+            if (duration <= std::chrono::nanoseconds::zero())
+                return;
+
+            // Relative due times are negative, in 100 ns units
+            LARGE_INTEGER dueTime;
+            dueTime.QuadPart = -static_cast<LONGLONG>((duration.count() + 99) / 100);
+            if (m_timer && SetWaitableTimer(m_timer, &dueTime, 0, nullptr, nullptr, FALSE))
+            {
+                WaitForSingleObject(m_timer, INFINITE);
+                return;
+            }
+            std::this_thread::sleep_for(duration);
+        }
+
+    private:
+        HANDLE m_timer;
+        bool m_raisedResolution;
+    };
+
+    // Waits for the display's next refresh, for renderers whose present does not: the
+    // compositor's next frame, or where composition is unavailable the next refresh period
+    // of the display mode
+    class DisplayPacer
+    {
+    public:
+        DisplayPacer()
+            : m_period(GetRefreshPeriod())
+            , m_next(std::chrono::steady_clock::now())
+        {
+        }
+
+        void Wait(PrecisionSleeper& sleeper)
+        {
+            if (SUCCEEDED(DwmFlush()))
+                return;
+
+            // Keep to the period's grid, restarting it after a frame that overran
+            auto now = std::chrono::steady_clock::now();
+            m_next = std::max(m_next + m_period, now);
+            sleeper.Sleep(m_next - now);
+        }
+
+    private:
+        static std::chrono::nanoseconds GetRefreshPeriod()
+        {
+            DEVMODEW mode = {};
+            mode.dmSize = sizeof(mode);
+            DWORD hertz = EnumDisplaySettingsW(nullptr, ENUM_CURRENT_SETTINGS, &mode) ? mode.dmDisplayFrequency : 0;
+
+            // 0 and 1 stand for the hardware's default rate
+            if (hertz <= 1)
+                hertz = 60;
+            return std::chrono::nanoseconds(1000000000 / hertz);
+        }
+
+        std::chrono::nanoseconds m_period;
+        std::chrono::steady_clock::time_point m_next;
+    };
+}
+
+EngineThreads::EngineThreads(Engine& engine, Hook beforeUpdate, Hook onFailure, Hook afterRender)
+    : m_engine(engine)
+    , m_beforeUpdate(std::move(beforeUpdate))
+    , m_onFailure(std::move(onFailure))
+    , m_afterRender(std::move(afterRender))
+    , m_running(false)
+    , m_renderExited(false)
+{
+}
+
+EngineThreads::~EngineThreads()
+{
+    Stop();
+}
+
+void EngineThreads::Start()
+{
+    if (m_updateThread.joinable())
+        return;
+
+    m_running = true;
+    m_renderExited = false;
+    m_renderThread = std::thread(&EngineThreads::RenderLoop, this);
+    m_updateThread = std::thread(&EngineThreads::UpdateLoop, this);
+    Logger::Log("Engine update and render threads started");
+}
+
+void EngineThreads::Stop()
+{
+    if (!m_updateThread.joinable())
+        return;
+
+    m_running = false;
+    m_updateThread.join();
+
+    // The render thread may be blocked sending a message to a window owned by this thread
+    while (!m_renderExited.load())
+    {
+        MSG msg;
+        PeekMessageW(&msg, nullptr, 0, 0, PM_NOREMOVE | PM_QS_SENDMESSAGE);
+        Sleep(1);
+    }
+    m_renderThread.join();
+    Logger::Log("Engine update and render threads stopped");
+}
+
+void EngineThreads::Post(Command command)
+{
+    std::lock_guard<std::mutex> lock(m_commandMutex);
+    m_commands.push_back(std::move(command));
+}
+
+void EngineThreads::UpdateLoop()
+{
+    PrecisionSleeper sleeper;
+    while (m_running.load())
+    {
+        try
+        {
+            if (m_beforeUpdate)
+                m_beforeUpdate();
+            m_engine.Update();
+        }
+        catch (const std::exception& e)
+        {
+            Fail("Update", e);
+            return;
+        }
+
+        // Sleep until the next step falls due
+        auto remaining = std::chrono::duration<double, std::nano>(m_engine.GetFixedTimestep()) *
+                         (1.0 - m_engine.GetStepFraction());
+        sleeper.Sleep(std::chrono::duration_cast<std::chrono::nanoseconds>(remaining));
+    }
+}
+
+void EngineThreads::RenderLoop()
+{
+    PrecisionSleeper sleeper;
+    DisplayPacer pacer;
+    while (m_running.load())
+    {
+        std::vector<Command> commands;
+        {
+            std::lock_guard<std::mutex> lock(m_commandMutex);
+            commands.swap(m_commands);
+        }
+
+        try
+        {
+            for (Command& command : commands)
+                command(m_engine);
+            m_engine.Render();
+            if (m_afterRender)
+                m_afterRender();
+        }
+        catch (const std::exception& e)
+        {
+            Fail("Render", e);
+            break;
+        }
+
+        // Not waiting on the update thread: the next frame draws whichever snapshot is
+        // newest by the time the display wants one
+        if (!m_engine.IsRenderPaced())
+            pacer.Wait(sleeper);
+    }
+    m_renderExited = true;
+}
+
+void EngineThreads::Fail(const char* where, const std::exception& e)
+{
+    Logger::LogError(std::string(where) + " thread stopped: " + e.what());
+    m_running = false;
+    if (m_onFailure)
+        m_onFailure();
+}
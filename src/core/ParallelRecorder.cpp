@@ -0,0 +1,132 @@
+#include "ParallelRecorder.h"
+#include <algorithm>
+
+ParallelRecorder::ParallelRecorder(unsigned threads)
+    : m_bufferCount(0)
+    , m_record(nullptr)
+    , m_jobCount(0)
+    , m_nextJob(0)
+    , m_generation(0)
+    , m_busyWorkers(0)
+    , m_stopping(false)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // The calling thread takes jobs too
+    for (unsigned i = 1; i < threads; i++)
+        m_workers.emplace_back(&ParallelRecorder::WorkerLoop, this);
+}
+
+ParallelRecorder::~ParallelRecorder()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& worker : m_workers)
+        worker.join();
+}
+
+void ParallelRecorder::Record(DisplayList& out, size_t jobs, const RecordFunction& record)
+{
+    BeginFrame(jobs);
+
+    if (m_workers.empty() || jobs < 2)
+    {
+        for (size_t job = 0; job < jobs; job++)
+            record(job, m_buffers[job]);
+    }
+    else
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_record = &record;
+            m_jobCount = jobs;
+            m_nextJob = 0;
+            m_error = nullptr;
+            m_busyWorkers = m_workers.size();
+            m_generation++;
+        }
+        m_wake.notify_all();
+
+        RunJobs();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_busyWorkers == 0; });
+        m_record = nullptr;
+        if (m_error)
+            std::rethrow_exception(m_error);
+    }
+
+    EndFrame(out);
+}
+
+void ParallelRecorder::BeginFrame(size_t buffers)
+{
+    if (m_buffers.size() < buffers)
+        m_buffers.resize(buffers);
+    for (size_t i = 0; i < buffers; i++)
+        m_buffers[i].Reset();
+    m_bufferCount = buffers;
+}
+
+void ParallelRecorder::EndFrame(DisplayList& out)
+{
+    size_t commands = 0;
+    size_t text = 0;
+    for (size_t i = 0; i < m_bufferCount; i++)
+    {
+        commands += m_buffers[i].GetCommands().size();
+        text += m_buffers[i].GetTextPoolSize();
+    }
+
+    out.Reset();
+    out.Reserve(commands, text);
+    for (size_t i = 0; i < m_bufferCount; i++)
+        out.Append(m_buffers[i]);
+}
+
+void ParallelRecorder::WorkerLoop()
+{
+    uint64_t seen = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stopping || m_generation != seen; });
+            if (m_stopping)
+                return;
+            seen = m_generation;
+        }
+
+        RunJobs();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_busyWorkers == 0)
+            m_done.notify_one();
+    }
+}
+
+void ParallelRecorder::RunJobs()
+{
+    // Jobs are claimed dynamically; the buffer index, not the thread, fixes merge order
+    for (;;)
+    {
+        size_t job = m_nextJob.fetch_add(1);
+        if (job >= m_jobCount)
+            return;
+
+        try
+        {
+            (*m_record)(job, m_buffers[job]);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_error)
+                m_error = std::current_exception();
+        }
+    }
+}
@@ -0,0 +1,141 @@
+#include "Session.h"
+#include <cstring>
+#include <stdexcept>
+
+using namespace SessionFormat;
+
+namespace
+{
+    // Pending events are written out once this many are buffered
+    const size_t FLUSH_THRESHOLD = 4096;
+
+    FileHeader MakeHeader(uint32_t seed, uint32_t width, uint32_t height, uint32_t renderer)
+    {
+        FileHeader header = {};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.headerSize = sizeof(FileHeader);
+        header.seed = seed;
+        header.width = width;
+        header.height = height;
+        header.renderer = renderer;
+        return header;
+    }
+}
+
+SessionRecording SessionRecording::Load(const std::wstring& fileName)
+{
+    FILE* file = nullptr;
+    if (_wfopen_s(&file, fileName.c_str(), L"rb") != 0 || !file)
+        throw std::runtime_error("Failed to open session file");
+
+    FileHeader header = {};
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+                 std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+                 header.version == VERSION && header.headerSize >= sizeof(FileHeader);
+    if (!valid || fseek(file, header.headerSize, SEEK_SET) != 0)
+    {
+        fclose(file);
+        throw std::runtime_error("Not a session file or unsupported version");
+    }
+
+    SessionRecording recording;
+    recording.seed = header.seed;
+    recording.width = header.width;
+    recording.height = header.height;
+    recording.renderer = header.renderer;
+
+    Event event;
+    while (fread(&event, sizeof(event), 1, file) == 1)
+        recording.events.push_back(event);
+
+    fclose(file);
+    return recording;
+}
+
+void SessionRecording::Save(const std::wstring& fileName) const
+{
+    FILE* file = nullptr;
+    if (_wfopen_s(&file, fileName.c_str(), L"wb") != 0 || !file)
+        throw std::runtime_error("Failed to create session file");
+
+    FileHeader header = MakeHeader(seed, width, height, renderer);
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(events.data(), sizeof(Event), events.size(), file) == events.size();
+    fclose(file);
+
+    if (!written)
+        throw std::runtime_error("Failed to write session file");
+}
+
+SessionRecorder::SessionRecorder(const std::wstring& fileName, uint32_t seed, UINT width, UINT height,
+                                 uint32_t renderer)
+    : m_file(nullptr)
+{
+    if (_wfopen_s(&m_file, fileName.c_str(), L"wb") != 0 || !m_file)
+        throw std::runtime_error("Failed to create session file");
+
+    FileHeader header = MakeHeader(seed, width, height, renderer);
+    fwrite(&header, sizeof(header), 1, m_file);
+
+    m_pending.reserve(FLUSH_THRESHOLD);
+}
+
+SessionRecorder::~SessionRecorder()
+{
+    if (m_file)
+    {
+        Flush();
+        fclose(m_file);
+    }
+}
+
+void SessionRecorder::RecordFrame(IClock::Duration time)
+{
+    Record(EventType::Frame, 0, 0, time);
+}
+
+void SessionRecorder::RecordSwitchRenderer(uint32_t renderer, IClock::Duration time)
+{
+    Record(EventType::SwitchRenderer, renderer, 0, time);
+}
+
+void SessionRecorder::RecordResize(UINT width, UINT height, IClock::Duration time)
+{
+    Record(EventType::Resize, width, height, time);
+}
+
+void SessionRecorder::RecordTimerTick(IClock::Duration time)
+{
+    Record(EventType::TimerTick, 0, 0, time);
+}
+
+void SessionRecorder::Flush()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    WritePending();
+    fflush(m_file);
+}
+
+void SessionRecorder::WritePending()
+{
+    if (!m_pending.empty())
+    {
+        fwrite(m_pending.data(), sizeof(Event), m_pending.size(), m_file);
+        m_pending.clear();
+    }
+}
+
+void SessionRecorder::Record(EventType type, uint32_t arg0, uint32_t arg1, IClock::Duration time)
+{
+    Event event = {};
+    event.type = type;
+    event.arg0 = arg0;
+    event.arg1 = arg1;
+    event.timeNs = static_cast<uint64_t>(time.count());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending.push_back(event);
+    if (m_pending.size() >= FLUSH_THRESHOLD)
+        WritePending();
+}
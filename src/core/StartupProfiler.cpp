@@ -0,0 +1,179 @@
+#include "StartupProfiler.h"
+#include <windows.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Counted only while profiling; the rest of the run pays one relaxed load per allocation
+    std::atomic<bool> g_countAllocations(false);
+    std::atomic<uint64_t> g_allocations(0);
+    std::atomic<uint64_t> g_allocatedBytes(0);
+
+    struct Counters
+    {
+        std::chrono::steady_clock::time_point wall;
+        uint64_t cpuTime;           // Process kernel + user time, 100 ns units
+        uint64_t ioBytes;           // Read, write and other transfers
+        uint64_t allocations;
+        uint64_t allocatedBytes;
+    };
+
+    struct Phase
+    {
+        std::string name;
+        std::thread::id thread;
+        int depth;
+        bool open;
+        Counters begin;
+        Counters end;
+    };
+
+    struct State
+    {
+        std::mutex mutex;
+        std::atomic<bool> active{ false };
+        std::thread::id mainThread;         // The one that called Start
+        Counters start;
+        std::vector<Phase> phases;
+    };
+
+    State& GetState()
+    {
+        static State state;
+        return state;
+    }
+
+    uint64_t ToUInt64(const FILETIME& time)
+    {
+        return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    }
+
+    Counters Sample()
+    {
+        Counters counters = {};
+        counters.wall = std::chrono::steady_clock::now();
+
+        FILETIME creation, exit, kernel, user;
+        if (GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+            counters.cpuTime = ToUInt64(kernel) + ToUInt64(user);
+
+        IO_COUNTERS io;
+        if (GetProcessIoCounters(GetCurrentProcess(), &io))
+            counters.ioBytes = io.ReadTransferCount + io.WriteTransferCount + io.OtherTransferCount;
+
+        counters.allocations = g_allocations.load(std::memory_order_relaxed);
+        counters.allocatedBytes = g_allocatedBytes.load(std::memory_order_relaxed);
+        return counters;
+    }
+
+    void AppendRow(std::string& report, const std::string& name, const Counters& begin, const Counters& end)
+    {
+        char row[160];
+        snprintf(row, sizeof(row), "%-36s %9.2f %9.2f %10.1f %9llu %10.1f\n", name.c_str(),
+                 std::chrono::duration<double, std::milli>(end.wall - begin.wall).count(),
+                 (end.cpuTime - begin.cpuTime) / 1e4,
+                 (end.ioBytes - begin.ioBytes) / 1024.0,
+                 static_cast<unsigned long long>(end.allocations - begin.allocations),
+                 (end.allocatedBytes - begin.allocatedBytes) / 1024.0);
+        report += row;
+    }
+}
+
+void StartupProfiler::CountAllocation(std::size_t bytes)
+{
+    if (g_countAllocations.load(std::memory_order_relaxed))
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+}
+
+void StartupProfiler::Start()
+{
+    State& state = GetState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.phases.clear();
+    state.mainThread = std::this_thread::get_id();
+    g_allocations = 0;
+    g_allocatedBytes = 0;
+    g_countAllocations = true;
+    state.start = Sample();
+    state.active = true;
+}
+
+StartupProfiler::PhaseId StartupProfiler::BeginPhase(const char* name)
+{
+    State& state = GetState();
+    if (!state.active.load())
+        return NO_PHASE;
+
+    Counters begin = Sample();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (!state.active.load())
+        return NO_PHASE;
+
+    Phase phase = { name, std::this_thread::get_id(), 0, true, begin, begin };
+    for (const Phase& other : state.phases)
+    {
+        if (other.open && other.thread == phase.thread)
+            phase.depth++;
+    }
+    state.phases.push_back(std::move(phase));
+    return static_cast<PhaseId>(state.phases.size() - 1);
+}
+
+void StartupProfiler::EndPhase(PhaseId id)
+{
+    State& state = GetState();
+    if (id == NO_PHASE || !state.active.load())
+        return;
+
+    Counters end = Sample();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (id < 0 || static_cast<size_t>(id) >= state.phases.size() || !state.phases[id].open)
+        return;
+
+    state.phases[id].end = end;
+    state.phases[id].open = false;
+}
+
+std::string StartupProfiler::Finish()
+{
+    State& state = GetState();
+    Counters end = Sample();
+
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (!state.active.load())
+        return std::string();
+    state.active = false;
+    g_countAllocations = false;
+
+    std::string report = "Startup report\n";
+    char header[160];
+    snprintf(header, sizeof(header), "%-36s %9s %9s %10s %9s %10s\n",
+             "Phase", "Wall ms", "CPU ms", "I/O KB", "Allocs", "Alloc KB");
+    report += header;
+
+    for (Phase& phase : state.phases)
+    {
+        std::string name = std::string(phase.depth * 2, ' ') + phase.name;
+        if (phase.thread != state.mainThread)
+            name += " [worker]";
+        if (phase.open)
+            name += " (open)";
+        AppendRow(report, name, phase.begin, phase.open ? end : phase.end);
+    }
+    AppendRow(report, "Total", state.start, end);
+    return report;
+}
+
+bool StartupProfiler::IsActive()
+{
+    return GetState().active.load();
+}
@@ -0,0 +1,194 @@
+#include "TaskScheduler.h"
+#include "Logger.h"
+#include <stdexcept>
+
+TaskScheduler::TaskScheduler(TimerWheel& timers)
+    : m_timers(timers)
+    , m_nextId(1)
+    , m_stopping(false)
+{
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    // Queued work may point into task frames, so stop the worker before destroying them
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_workAvailable.notify_all();
+    if (m_worker.joinable())
+        m_worker.join();
+
+    for (auto& entry : m_tasks)
+    {
+        m_timers.Cancel(entry.second.promise().timer);
+        entry.second.destroy();
+    }
+}
+
+TaskScheduler::TaskId TaskScheduler::Spawn(Task task)
+{
+    Task::Handle handle = task.Release();
+    if (!handle)
+        return INVALID_TASK;
+
+    TaskId id = m_nextId++;
+    handle.promise().id = id;
+    m_tasks.emplace(id, handle);
+    Resume(id);
+    return id;
+}
+
+bool TaskScheduler::Cancel(TaskId id)
+{
+    auto it = m_tasks.find(id);
+    if (it == m_tasks.end())
+        return false;
+
+    Task::promise_type& promise = it->second.promise();
+    if (promise.running || promise.awaitingAsync)
+    {
+        promise.cancelled = true;
+        return true;
+    }
+
+    Destroy(id);
+    return true;
+}
+
+void TaskScheduler::RunFrame()
+{
+    // Waiters registered while resuming wait for the following frame
+    std::vector<TaskId> waiters;
+    waiters.swap(m_frameWaiters);
+    for (TaskId id : waiters)
+        Resume(id);
+
+    std::vector<TaskId> completed;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        completed.swap(m_completed);
+    }
+    for (TaskId id : completed)
+    {
+        auto it = m_tasks.find(id);
+        if (it == m_tasks.end())
+            continue;
+        it->second.promise().awaitingAsync = false;
+        Resume(id);
+    }
+}
+
+void TaskScheduler::Resume(TaskId id)
+{
+    // Waiter lists hold ids, so tasks cancelled while queued are simply skipped
+    auto it = m_tasks.find(id);
+    if (it == m_tasks.end())
+        return;
+
+    Task::Handle handle = it->second;
+    Task::promise_type& promise = handle.promise();
+    if (!promise.cancelled)
+    {
+        promise.running = true;
+        handle.resume();
+        promise.running = false;
+    }
+
+    if (promise.exception)
+    {
+        try
+        {
+            std::rethrow_exception(promise.exception);
+        }
+        catch (const std::exception& e)
+        {
+            Logger::LogError(std::string("Engine task failed: ") + e.what());
+        }
+        catch (...)
+        {
+            Logger::LogError("Engine task failed with an unknown exception");
+        }
+    }
+
+    if (handle.done() || (promise.cancelled && !promise.awaitingAsync))
+        Destroy(id);
+}
+
+void TaskScheduler::Destroy(TaskId id)
+{
+    // Unknown ids, including tasks already destroyed, are ignored
+    auto it = m_tasks.find(id);
+    if (it == m_tasks.end())
+        return;
+
+    Task::Handle handle = it->second;
+    m_timers.Cancel(handle.promise().timer);
+    m_tasks.erase(it);
+    handle.destroy();
+}
+
+void TaskScheduler::WorkerLoop()
+{
+    for (;;)
+    {
+        std::pair<TaskId, AsyncAwaiter*> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_workAvailable.wait(lock, [this] { return m_stopping || !m_work.empty(); });
+            if (m_stopping)
+                return;
+            job = m_work.front();
+            m_work.pop_front();
+        }
+
+        try
+        {
+            job.second->work();
+        }
+        catch (...)
+        {
+            job.second->error = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_completed.push_back(job.first);
+    }
+}
+
+void TaskScheduler::DelayAwaiter::await_suspend(Task::Handle handle)
+{
+    TaskId id = handle.promise().id;
+    handle.promise().timer = scheduler.m_timers.Schedule(ticks, [this_ = &scheduler, id]
+    {
+        auto it = this_->m_tasks.find(id);
+        if (it != this_->m_tasks.end())
+            it->second.promise().timer = TimerWheel::INVALID_TIMER;
+        this_->Resume(id);
+    });
+}
+
+void TaskScheduler::FrameAwaiter::await_suspend(Task::Handle handle)
+{
+    scheduler.m_frameWaiters.push_back(handle.promise().id);
+}
+
+void TaskScheduler::AsyncAwaiter::await_suspend(Task::Handle handle)
+{
+    handle.promise().awaitingAsync = true;
+    {
+        std::lock_guard<std::mutex> lock(scheduler.m_mutex);
+        scheduler.m_work.emplace_back(handle.promise().id, this);
+    }
+
+    if (!scheduler.m_worker.joinable())
+        scheduler.m_worker = std::thread(&TaskScheduler::WorkerLoop, &scheduler);
+    scheduler.m_workAvailable.notify_one();
+}
+
+void TaskScheduler::AsyncAwaiter::await_resume()
+{
+    if (error)
+        std::rethrow_exception(error);
+}
@@ -0,0 +1,188 @@
+#include "TimerWheel.h"
+#include <algorithm>
+
+TimerWheel::TimerWheel()
+    : m_nextTick(1)
+    , m_activeCount(0)
+{
+    // Every slot and the firing list start as empty circular lists
+    m_nodes.resize(FIRST_TIMER_NODE);
+    for (uint32_t i = 0; i < FIRST_TIMER_NODE; i++)
+    {
+        m_nodes[i].prev = i;
+        m_nodes[i].next = i;
+    }
+}
+
+TimerWheel::TimerId TimerWheel::Schedule(uint64_t delayTicks, Callback callback)
+{
+    return Add(delayTicks, 0, std::move(callback));
+}
+
+TimerWheel::TimerId TimerWheel::SchedulePeriodic(uint64_t periodTicks, Callback callback)
+{
+    periodTicks = std::max<uint64_t>(periodTicks, 1);
+    return Add(periodTicks, periodTicks, std::move(callback));
+}
+
+bool TimerWheel::Cancel(TimerId id)
+{
+    uint32_t index = static_cast<uint32_t>(id);
+    uint32_t generation = static_cast<uint32_t>(id >> 32);
+    if (index < FIRST_TIMER_NODE || index >= m_nodes.size())
+        return false;
+
+    Node& node = m_nodes[index];
+    if (!node.active || node.generation != generation)
+        return false;
+
+    // A timer cancelling itself from its callback is detached; ProcessTick frees it
+    node.active = false;
+    node.period = 0;
+    m_activeCount--;
+    if (node.next != NO_NODE)
+    {
+        Unlink(index);
+        Release(index);
+    }
+    return true;
+}
+
+void TimerWheel::Advance(uint64_t ticks)
+{
+    for (uint64_t i = 0; i < ticks; i++)
+        ProcessTick();
+}
+
+TimerWheel::TimerId TimerWheel::Add(uint64_t delayTicks, uint64_t period, Callback callback)
+{
+    uint32_t index;
+    if (!m_freeNodes.empty())
+    {
+        index = m_freeNodes.back();
+        m_freeNodes.pop_back();
+    }
+    else
+    {
+        index = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+        m_nodes[index].generation = 1;
+    }
+
+    Node& node = m_nodes[index];
+    node.active = true;
+    node.deadline = GetCurrentTick() + std::max<uint64_t>(delayTicks, 1);
+    node.period = period;
+    node.callback = std::move(callback);
+    Insert(index);
+    m_activeCount++;
+
+    return (static_cast<uint64_t>(node.generation) << 32) | index;
+}
+
+void TimerWheel::Insert(uint32_t index)
+{
+    // Level by distance, slot by the deadline's bits at that level. Anything beyond the
+    // top level parks at the furthest top-level slot and is re-filed when it cascades.
+    uint64_t deadline = std::max(m_nodes[index].deadline, m_nextTick);
+    uint64_t distance = deadline - m_nextTick;
+    uint32_t level = 0;
+    while (level < LEVEL_COUNT - 1 && distance >= (1ull << (LEVEL_BITS * (level + 1))))
+        level++;
+
+    if (distance >= (1ull << (LEVEL_BITS * LEVEL_COUNT)))
+        deadline = m_nextTick + (1ull << (LEVEL_BITS * LEVEL_COUNT)) - 1;
+
+    uint32_t slot = static_cast<uint32_t>(deadline >> (LEVEL_BITS * level)) & SLOT_MASK;
+    Link(level * SLOTS_PER_LEVEL + slot, index);
+}
+
+void TimerWheel::Link(uint32_t list, uint32_t index)
+{
+    Node& node = m_nodes[index];
+    node.prev = m_nodes[list].prev;
+    node.next = list;
+    m_nodes[node.prev].next = index;
+    m_nodes[list].prev = index;
+}
+
+void TimerWheel::Unlink(uint32_t index)
+{
+    Node& node = m_nodes[index];
+    m_nodes[node.prev].next = node.next;
+    m_nodes[node.next].prev = node.prev;
+    node.prev = NO_NODE;
+    node.next = NO_NODE;
+}
+
+void TimerWheel::Release(uint32_t index)
+{
+    Node& node = m_nodes[index];
+    node.callback = nullptr;
+    node.generation = (node.generation == 0xFFFFFFFFu) ? 1 : node.generation + 1;
+    m_freeNodes.push_back(index);
+}
+
+void TimerWheel::Cascade(uint32_t level, uint32_t slot)
+{
+    // Re-file every timer of a higher-level slot relative to the current tick
+    uint32_t list = level * SLOTS_PER_LEVEL + slot;
+    while (m_nodes[list].next != list)
+    {
+        uint32_t index = m_nodes[list].next;
+        Unlink(index);
+        Insert(index);
+    }
+}
+
+void TimerWheel::ProcessTick()
+{
+    const uint64_t tick = m_nextTick;
+
+    // When a level's index wraps, pull the matching slot of the next level down
+    for (uint32_t level = 1; level < LEVEL_COUNT; level++)
+    {
+        if (((tick >> (LEVEL_BITS * (level - 1))) & SLOT_MASK) != 0)
+            break;
+        Cascade(level, static_cast<uint32_t>(tick >> (LEVEL_BITS * level)) & SLOT_MASK);
+    }
+
+    // Detach the due slot first so timers scheduled by callbacks land in the wheel
+    m_nextTick = tick + 1;
+    uint32_t due = static_cast<uint32_t>(tick) & SLOT_MASK;
+    if (m_nodes[due].next == due)
+        return;
+
+    m_nodes[m_nodes[due].next].prev = FIRING_LIST;
+    m_nodes[m_nodes[due].prev].next = FIRING_LIST;
+    m_nodes[FIRING_LIST].next = m_nodes[due].next;
+    m_nodes[FIRING_LIST].prev = m_nodes[due].prev;
+    m_nodes[due].next = due;
+    m_nodes[due].prev = due;
+
+    while (m_nodes[FIRING_LIST].next != FIRING_LIST)
+    {
+        uint32_t index = m_nodes[FIRING_LIST].next;
+        Unlink(index);
+
+        // The callback may grow m_nodes, so it runs from a local and is moved back after
+        Callback callback = std::move(m_nodes[index].callback);
+        callback();
+
+        Node& node = m_nodes[index];
+        if (node.active && node.period != 0)
+        {
+            node.deadline += node.period;
+            node.callback = std::move(callback);
+            Insert(index);
+            continue;
+        }
+
+        if (node.active)
+        {
+            node.active = false;
+            m_activeCount--;
+        }
+        Release(index);
+    }
+}
@@ -1,58 +1,124 @@
 #include <windows.h>
-#include <shellapi.h>
 #include <string>
+#include <vector>
 #include <memory>
+#include <random>
+#include <cstdlib>
+#include <chrono>
 #include "Engine.h"
-#include "GDIRenderer.h"
-#include "DX12Renderer.h"
+#include "EngineThreads.h"
+#include "Clock.h"
+#include "Session.h"
+#include "RendererFactory.h"
+#include "RendererPool.h"
+#include "ResourceManager.h"
+#include "CaptureRenderer.h"
 #include "Logger.h"
-
-// Renderer selection enum
-enum class RendererType
-{
-    GDI,
-    DirectX12
-};
+#include "StartupProfiler.h"
+#include "CommandLine.h"
 
 // Global variables
 Engine* g_engine = nullptr;
 HWND g_hwnd = nullptr;
 RendererType g_selectedRenderer = RendererType::DirectX12; // Default renderer
+std::shared_ptr<CaptureWriter> g_captureWriter;             // Set by --capture=<file>
+std::unique_ptr<SessionRecorder> g_sessionRecorder;         // Set by --record-session=<file>
+std::unique_ptr<EngineThreads> g_engineThreads;             // Null with --single-thread
+UINT g_framesInFlight = 0;                                  // --frames-in-flight=<n>; 0 keeps backend defaults
+std::unique_ptr<RendererPool> g_rendererPool;               // Switched-out renderers, kept initialized
+std::chrono::steady_clock::time_point g_startTime;          // For time-to-first-frame
+StartupProfiler::PhaseId g_firstPresentPhase = StartupProfiler::NO_PHASE;   // Ended by the first frame
+
+// Posted by a failed engine thread
+const UINT WM_ENGINE_FAILED = WM_APP + 1;
+
+// The engine runs on frame-latched time: the wall clock is sampled once per update into a
+// VirtualClock, so a recorded session sees exactly the times Update() saw.
+SteadyClock g_wallClock;
+std::shared_ptr<VirtualClock> g_frameClock = std::make_shared<VirtualClock>();
 
 // Function declarations
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
-std::unique_ptr<IRenderer> CreateRenderer(RendererType type);
+std::unique_ptr<IRenderer> CreateSessionRenderer(RendererType type);
 RendererType SelectRendererFromCommandLine(int argc, char* argv[]);
+std::string GetCommandLineOption(int argc, char* argv[], const std::string& prefix);
+void LatchFrame();
+void RunFrame();
+void ReportStartup();
+void SwitchToRenderer(HWND hwnd, RendererType type);
+void SwitchEngineRenderer(Engine& engine, RendererType type);
 
 // Entry point
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow)
 {
+    g_startTime = std::chrono::steady_clock::now();
+    StartupProfiler::Start();
+
     // Clear previous log
     Logger::ClearLog();
     Logger::Log("Application starting...");
 
     // Parse command line to select renderer
-    int argc = 0;
-    LPWSTR* argvW = CommandLineToArgvW(GetCommandLineW(), &argc);
+    StartupProfiler::PhaseId phase = StartupProfiler::BeginPhase("Argument parsing");
+    // UTF-8, as char** for easier parsing; paths go back through Utf8ToWide
+    std::vector<std::string> arguments = GetUtf8Arguments();
+    std::vector<char*> argvPointers;
+    for (std::string& argument : arguments)
+        argvPointers.push_back(argument.data());
+    int argc = static_cast<int>(argvPointers.size());
+    char** argv = argvPointers.data();
 
-    // Convert to char** for easier parsing
-    char** argv = new char*[argc];
-    for (int i = 0; i < argc; i++)
+    g_selectedRenderer = SelectRendererFromCommandLine(argc, argv);
+    std::string capturePath = GetCommandLineOption(argc, argv, "--capture=");
+    std::string sessionPath = GetCommandLineOption(argc, argv, "--record-session=");
+    std::string seedOption = GetCommandLineOption(argc, argv, "--seed=");
+    std::string framesInFlightOption = GetCommandLineOption(argc, argv, "--frames-in-flight=");
+    std::string outlineFontPath = GetCommandLineOption(argc, argv, "--ttf=");
+    bool singleThread = false;
+    bool prewarmRenderers = false;
+    for (int i = 1; i < argc; i++)
     {
-        int size = WideCharToMultiByte(CP_UTF8, 0, argvW[i], -1, nullptr, 0, nullptr, nullptr);
-        argv[i] = new char[size];
-        WideCharToMultiByte(CP_UTF8, 0, argvW[i], -1, argv[i], size, nullptr, nullptr);
+        singleThread |= std::string(argv[i]) == "--single-thread";
+        prewarmRenderers |= std::string(argv[i]) == "--prewarm-renderers";
     }
 
-    g_selectedRenderer = SelectRendererFromCommandLine(argc, argv);
+    StartupProfiler::EndPhase(phase);
 
-    // Cleanup argv
-    for (int i = 0; i < argc; i++)
-        delete[] argv[i];
-    delete[] argv;
-    LocalFree(argvW);
+    if (!capturePath.empty())
+    {
+        try
+        {
+            g_captureWriter = std::make_shared<CaptureWriter>(Utf8ToWide(capturePath));
+            Logger::Log("Capturing draw commands to " + capturePath);
+        }
+        catch (const std::exception& e)
+        {
+            Logger::LogError(std::string("Failed to start capture: ") + e.what());
+        }
+    }
+
+    if (!framesInFlightOption.empty())
+        g_framesInFlight = static_cast<UINT>(strtoul(framesInFlightOption.c_str(), nullptr, 10));
+
+    // Pick the RNG seed up front so a recorded session can reproduce it
+    uint32_t seed = seedOption.empty() ? std::random_device()() : static_cast<uint32_t>(strtoul(seedOption.c_str(), nullptr, 10));
+
+    if (!sessionPath.empty())
+    {
+        try
+        {
+            g_sessionRecorder = std::make_unique<SessionRecorder>(Utf8ToWide(sessionPath),
+                seed, 1280, 720, static_cast<uint32_t>(g_selectedRenderer));
+            Logger::Log("Recording session to " + sessionPath);
+        }
+        catch (const std::exception& e)
+        {
+            Logger::LogError(std::string("Failed to start session recording: ") + e.what());
+        }
+    }
 
     // Register window class
+    phase = StartupProfiler::BeginPhase("Window creation");
     const wchar_t CLASS_NAME[] = L"GraphicsEngineWindowClass";
 
     WNDCLASSW wc = {};
@@ -81,6 +147,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         hInstance,
         nullptr
     );
+    StartupProfiler::EndPhase(phase);
 
     if (g_hwnd == nullptr)
     {
@@ -89,13 +156,67 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 
     // Create engine with selected renderer
     Logger::Log("Creating engine and renderer...");
-    g_engine = new Engine(1280, 720);
+    phase = StartupProfiler::BeginPhase("Engine construction");
+    g_engine = new Engine(1280, 720, g_frameClock);
+    g_engine->SetSeed(seed);
+    StartupProfiler::EndPhase(phase);
+
+    // Fonts come from the binary when it was built with them, else from the asset pack when
+    // there is one, and from loose files otherwise
+    phase = StartupProfiler::BeginPhase("Asset pack mount");
+    if (!GetEmbeddedFonts().empty())
+    {
+        Logger::Log("Using " + std::to_string(GetEmbeddedFonts().size()) + " embedded fonts");
+        g_engine->GetResources()->MountEmbeddedFonts(GetEmbeddedFonts());
+    }
+    else
+    {
+        try
+        {
+            auto pack = std::make_shared<AssetPack>();
+            pack->Open(L"assets.gepack");
+            Logger::Log("Mounted assets.gepack (" + std::to_string(pack->GetEntryCount()) + " assets)");
+            g_engine->GetResources()->MountPack(std::move(pack));
+        }
+        catch (const std::exception& e)
+        {
+            Logger::LogWarning(std::string("No asset pack, loading loose asset files: ") + e.what());
+        }
+    }
+    StartupProfiler::EndPhase(phase);
+
+    // --ttf=<file>: the software and DX12 renderers rasterize text from this font at any size
+    if (!outlineFontPath.empty())
+    {
+        phase = StartupProfiler::BeginPhase("Outline font load");
+        try
+        {
+            g_engine->GetResources()->LoadOutlineFont(Utf8ToWide(outlineFontPath).c_str());
+            Logger::Log("Loaded outline font " + outlineFontPath);
+        }
+        catch (const std::exception& e)
+        {
+            Logger::LogWarning(std::string("Failed to load outline font, using sprite fonts: ") + e.what());
+        }
+        StartupProfiler::EndPhase(phase);
+    }
 
     try
     {
-        auto renderer = CreateRenderer(g_selectedRenderer);
+        phase = StartupProfiler::BeginPhase("Renderer Initialize");
+        auto renderer = CreateSessionRenderer(g_selectedRenderer);
         g_engine->Initialize(g_hwnd, std::move(renderer));
+        StartupProfiler::EndPhase(phase);
         Logger::Log("Engine and renderer initialized successfully");
+
+        g_rendererPool = std::make_unique<RendererPool>(CreateSessionRenderer);
+        g_rendererPool->SetCurrent(g_selectedRenderer);
+        if (prewarmRenderers)
+        {
+            // The other backends initialize in the background while the first frames run
+            for (RendererType type : { RendererType::GDI, RendererType::DirectX12, RendererType::Software })
+                g_rendererPool->Prewarm(*g_engine, type);
+        }
     }
     catch (const std::exception& e)
     {
@@ -105,19 +226,34 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     }
 
     Logger::Log("Showing window...");
+    g_firstPresentPhase = StartupProfiler::BeginPhase("First present");
     ShowWindow(g_hwnd, nCmdShow);
     UpdateWindow(g_hwnd);
 
+    MSG msg = {};
+    if (!singleThread)
+    {
+        // Update and render on their own threads; this thread only handles input
+        g_engineThreads = std::make_unique<EngineThreads>(*g_engine, LatchFrame,
+            [] { PostMessageW(g_hwnd, WM_ENGINE_FAILED, 0, 0); }, ReportStartup);
+        g_engineThreads->Start();
+
+        Logger::Log("Entering message loop...");
+        while (GetMessageW(&msg, nullptr, 0, 0) > 0)
+        {
+            TranslateMessage(&msg);
+            DispatchMessageW(&msg);
+        }
+    }
+
     // Set up timer for continuous updates (only needed for GDI renderer)
-    if (g_selectedRenderer == RendererType::GDI)
+    if (singleThread && g_selectedRenderer == RendererType::GDI)
     {
         SetTimer(g_hwnd, 1, 16, nullptr); // ~60 FPS
     }
 
-    Logger::Log("Entering message loop...");
-    // Message loop
-    MSG msg = {};
-    while (msg.message != WM_QUIT)
+    // Single-threaded message loop: update and render whenever the queue is empty
+    while (singleThread && msg.message != WM_QUIT)
     {
         if (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE))
         {
@@ -131,8 +267,7 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
             {
                 try
                 {
-                    g_engine->Update();
-                    g_engine->Render();
+                    RunFrame();
                 }
                 catch (const std::exception& e)
                 {
@@ -148,6 +283,8 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     }
 
     // Cleanup
+    g_engineThreads.reset();
+    g_rendererPool.reset();
     if (g_engine)
     {
         g_engine->OnDestroy();
@@ -155,6 +292,9 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         g_engine = nullptr;
     }
 
+    g_captureWriter.reset();
+    g_sessionRecorder.reset();
+
     return (int)msg.wParam;
 }
 
@@ -165,39 +305,27 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
     {
     case WM_DESTROY:
         KillTimer(hwnd, 1);
+        // Renderers draw into this window, so the engine threads stop before it goes
+        if (g_engineThreads)
+            g_engineThreads->Stop();
         PostQuitMessage(0);
         return 0;
 
+    case WM_ENGINE_FAILED:
+        if (g_engineThreads)
+            g_engineThreads->Stop();
+        PostQuitMessage(1);
+        return 0;
+
     case WM_KEYDOWN:
-        // Press 'G' to switch to GDI, 'D' to switch to DirectX 12, ESC to quit
-        if (wParam == 'G' || wParam == 'D')
+        // Press 'G' to switch to GDI, 'D' to switch to DirectX 12, 'S' for software, ESC to quit
+        if (wParam == 'G' || wParam == 'D' || wParam == 'S')
         {
-            RendererType newRenderer = (wParam == 'G') ? RendererType::GDI : RendererType::DirectX12;
+            RendererType newRenderer = (wParam == 'G') ? RendererType::GDI :
+                                       (wParam == 'S') ? RendererType::Software : RendererType::DirectX12;
 
             if (newRenderer != g_selectedRenderer)
-            {
-                Logger::Log("Switching renderer...");
-                g_selectedRenderer = newRenderer;
-
-                try
-                {
-                    // Switch renderer
-                    auto renderer = CreateRenderer(g_selectedRenderer);
-                    g_engine->SwitchRenderer(std::move(renderer));
-
-                    // Manage timer
-                    if (g_selectedRenderer == RendererType::GDI)
-                        SetTimer(hwnd, 1, 16, nullptr);
-                    else
-                        KillTimer(hwnd, 1);
-
-                    Logger::Log("Renderer switched successfully");
-                }
-                catch (const std::exception& e)
-                {
-                    Logger::LogError(std::string("Failed to switch renderer: ") + e.what());
-                }
-            }
+                SwitchToRenderer(hwnd, newRenderer);
         }
         else if (wParam == VK_ESCAPE)
         {
@@ -205,16 +333,32 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
         }
         return 0;
 
+    case WM_SIZE:
+        if (g_engine)
+        {
+            UINT width = LOWORD(lParam);
+            UINT height = HIWORD(lParam);
+            if (g_sessionRecorder)
+                g_sessionRecorder->RecordResize(width, height, g_frameClock->Now());
+            if (g_engineThreads)
+                g_engineThreads->Post([width, height](Engine& engine) { engine.Resize(width, height); });
+            else
+                g_engine->Resize(width, height);
+        }
+        return 0;
+
     case WM_PAINT:
-        if (g_selectedRenderer == RendererType::GDI && g_engine)
+        // With engine threads the render thread repaints continuously
+        if (g_selectedRenderer == RendererType::GDI && g_engine && !g_engineThreads)
         {
-            g_engine->Update();
-            g_engine->Render();
+            RunFrame();
         }
         ValidateRect(hwnd, nullptr);
         return 0;
 
     case WM_TIMER:
+        if (g_sessionRecorder)
+            g_sessionRecorder->RecordTimerTick(g_frameClock->Now());
         if (g_selectedRenderer == RendererType::GDI)
         {
             InvalidateRect(hwnd, nullptr, FALSE);
@@ -229,22 +373,127 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
     return DefWindowProc(hwnd, uMsg, wParam, lParam);
 }
 
-// Create renderer based on type
-std::unique_ptr<IRenderer> CreateRenderer(RendererType type)
+// Latch the wall clock into the engine's clock for the next Update
+void LatchFrame()
 {
-    switch (type)
+    g_frameClock->SetTime(g_wallClock.Now());
+    if (g_sessionRecorder)
+        g_sessionRecorder->RecordFrame(g_frameClock->Now());
+}
+
+// Single-threaded frame: latch, Update and Render
+void RunFrame()
+{
+    LatchFrame();
+    g_engine->Update();
+    g_engine->Render();
+    ReportStartup();
+}
+
+// Render side, after each frame: log time to the first frame, then how long each
+// background asset load took once they have all finished
+void ReportStartup()
+{
+    static bool firstFrameReported = false;
+    static bool assetsReported = false;
+    if (assetsReported)
+        return;
+
+    auto sinceStart = [] {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - g_startTime).count();
+    };
+    AssetLoadProgress progress = g_engine->GetResources()->GetLoadProgress();
+
+    if (!firstFrameReported)
     {
-    case RendererType::GDI:
-        Logger::Log("Creating GDI Renderer...");
-        return std::make_unique<GDIRenderer>();
+        firstFrameReported = true;
+        StartupProfiler::EndPhase(g_firstPresentPhase);
+        Logger::Log("First frame after " + std::to_string(sinceStart()) + " ms (" +
+                    std::to_string(progress.resident) + "/" + std::to_string(progress.requested) +
+                    " assets resident)");
+        Logger::Log(StartupProfiler::Finish());
+    }
 
-    case RendererType::DirectX12:
-        Logger::Log("Creating DirectX 12 Renderer...");
-        return std::make_unique<DX12Renderer>();
+    if (!progress.IsComplete())
+        return;
 
-    default:
-        return nullptr;
+    assetsReported = true;
+    for (const AssetLoadRecord& record : g_engine->GetResources()->GetLoadRecords())
+    {
+        const char* parts[] = { "metrics", "texture", "coverage" };
+        std::string name = std::string(record.name.begin(), record.name.end()) + " (" +
+                           parts[static_cast<int>(record.part)] + ")";
+        if (record.state == AssetLoadState::Failed)
+        {
+            Logger::LogWarning("Loading " + name + " failed after " + std::to_string(record.totalMs) + " ms: " + record.error);
+            continue;
+        }
+        Logger::Log("Loaded " + name + " in " + std::to_string(record.totalMs) + " ms (queued " +
+                    std::to_string(record.queuedMs) + ", read " + std::to_string(record.readMs) +
+                    ", decode " + std::to_string(record.decodeMs) + ")");
     }
+    Logger::Log("All assets resident after " + std::to_string(sinceStart()) + " ms");
+}
+
+void SwitchToRenderer(HWND hwnd, RendererType type)
+{
+    Logger::Log("Switching renderer...");
+    g_selectedRenderer = type;
+
+    if (g_sessionRecorder)
+        g_sessionRecorder->RecordSwitchRenderer(static_cast<uint32_t>(type), g_frameClock->Now());
+
+    if (g_engineThreads)
+    {
+        // Renderers are created and used on the render thread
+        g_engineThreads->Post([type](Engine& engine)
+        {
+            try
+            {
+                SwitchEngineRenderer(engine, type);
+            }
+            catch (const std::exception& e)
+            {
+                Logger::LogError(std::string("Failed to switch renderer: ") + e.what());
+            }
+        });
+        return;
+    }
+
+    try
+    {
+        SwitchEngineRenderer(*g_engine, g_selectedRenderer);
+
+        // Manage timer
+        if (g_selectedRenderer == RendererType::GDI)
+            SetTimer(hwnd, 1, 16, nullptr);
+        else
+            KillTimer(hwnd, 1);
+    }
+    catch (const std::exception& e)
+    {
+        Logger::LogError(std::string("Failed to switch renderer: ") + e.what());
+    }
+}
+
+// Switch through the renderer pool (render side) and log how long the switch took
+void SwitchEngineRenderer(Engine& engine, RendererType type)
+{
+    auto start = std::chrono::steady_clock::now();
+    bool warm = g_rendererPool->Switch(engine, type);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    Logger::Log("Renderer switched in " + std::to_string(ms) + " ms (" + (warm ? "warm" : "cold") + ")");
+}
+
+// Create renderer based on type, wrapped for capture when --capture is active
+std::unique_ptr<IRenderer> CreateSessionRenderer(RendererType type)
+{
+    auto renderer = CreateRenderer(type);
+    if (renderer && g_framesInFlight > 0)
+        renderer->SetFramesInFlight(g_framesInFlight);
+    if (renderer && g_captureWriter)
+        return std::make_unique<CaptureRenderer>(std::move(renderer), g_captureWriter);
+    return renderer;
 }
 
 // Parse command line arguments to select renderer
@@ -262,16 +511,29 @@ RendererType SelectRendererFromCommandLine(int argc, char* argv[])
         {
             return RendererType::DirectX12;
         }
+        else if (arg == "--renderer=software" || arg == "-sw")
+        {
+            return RendererType::Software;
+        }
         else if (arg == "--help" || arg == "-h")
         {
             MessageBoxA(nullptr,
                 "Graphics Engine - Random Number Display\n\n"
                 "Command line options:\n"
                 "  --renderer=gdi or -gdi    : Use GDI renderer\n"
-                "  --renderer=dx12 or -dx12  : Use DirectX 12 renderer (default)\n\n"
+                "  --renderer=dx12 or -dx12  : Use DirectX 12 renderer (default)\n"
+                "  --renderer=software or -sw : Use CPU software renderer\n"
+                "  --capture=<file>          : Record draw commands for RenderReplay\n"
+                "  --record-session=<file>   : Record input events for SessionReplay\n"
+                "  --seed=<n>                : Seed the random number generator\n"
+                "  --single-thread           : Update and render on the window thread\n"
+                "  --frames-in-flight=<1-3>  : Frames recorded ahead of presentation\n"
+                "  --prewarm-renderers       : Initialize the other renderers in the background\n"
+                "  --ttf=<file>              : Software and DX12 renderers draw text from this TrueType font\n\n"
                 "Runtime controls:\n"
                 "  G : Switch to GDI renderer\n"
                 "  D : Switch to DirectX 12 renderer\n"
+                "  S : Switch to software renderer\n"
                 "  ESC : Exit application\n\n"
                 "The random number updates every 5 seconds.",
                 "Graphics Engine Help",
@@ -282,3 +544,15 @@ RendererType SelectRendererFromCommandLine(int argc, char* argv[])
     // Default to DirectX 12
     return RendererType::DirectX12;
 }
+
+// Value of the first "--name=value" argument with the given prefix, or empty
+std::string GetCommandLineOption(int argc, char* argv[], const std::string& prefix)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg.compare(0, prefix.size(), prefix) == 0)
+            return arg.substr(prefix.size());
+    }
+    return std::string();
+}
@@ -0,0 +1,110 @@
+#include "CaptureFormat.h"
+#include <cstring>
+#include <stdexcept>
+
+using namespace CaptureFormat;
+
+CaptureReader::CaptureReader()
+    : m_file(INVALID_HANDLE_VALUE)
+    , m_mapping(nullptr)
+    , m_data(nullptr)
+    , m_size(0)
+{
+}
+
+CaptureReader::~CaptureReader()
+{
+    Close();
+}
+
+void CaptureReader::Open(const std::wstring& fileName)
+{
+    Close();
+
+    m_file = CreateFileW(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                         OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Failed to open capture file");
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(m_file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(FileHeader)))
+    {
+        Close();
+        throw std::runtime_error("Capture file is too small");
+    }
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+
+    m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mapping)
+    {
+        Close();
+        throw std::runtime_error("Failed to map capture file");
+    }
+
+    m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_data)
+    {
+        Close();
+        throw std::runtime_error("Failed to map capture file view");
+    }
+
+    const FileHeader* header = reinterpret_cast<const FileHeader*>(m_data);
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION ||
+        header->headerSize != sizeof(FileHeader))
+    {
+        Close();
+        throw std::runtime_error("Not a supported capture file");
+    }
+}
+
+void CaptureReader::Close()
+{
+    if (m_data)
+    {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+
+    if (m_mapping)
+    {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+
+    m_size = 0;
+}
+
+const RecordHeader* CaptureReader::First() const
+{
+    if (!m_data)
+        return nullptr;
+
+    const RecordHeader* record = reinterpret_cast<const RecordHeader*>(m_data + sizeof(FileHeader));
+    size_t offset = sizeof(FileHeader);
+    if (m_size - offset < sizeof(RecordHeader) || record->size < sizeof(RecordHeader) || record->size > m_size - offset)
+        return nullptr;
+
+    return record;
+}
+
+const RecordHeader* CaptureReader::Next(const RecordHeader* record) const
+{
+    const uint8_t* next = reinterpret_cast<const uint8_t*>(record) + record->size;
+    size_t offset = static_cast<size_t>(next - m_data);
+
+    // A capture cut short (e.g. the process was killed) simply ends at the last whole record
+    if (m_size - offset < sizeof(RecordHeader))
+        return nullptr;
+
+    const RecordHeader* nextRecord = reinterpret_cast<const RecordHeader*>(next);
+    if (nextRecord->size < sizeof(RecordHeader) || nextRecord->size > m_size - offset)
+        return nullptr;
+
+    return nextRecord;
+}
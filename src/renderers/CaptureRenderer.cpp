@@ -0,0 +1,200 @@
+#include "CaptureRenderer.h"
+#include <cstring>
+#include <stdexcept>
+
+using namespace CaptureFormat;
+
+namespace
+{
+    // Batched records are written out once this much data is pending
+    const size_t FLUSH_THRESHOLD = 64 * 1024;
+}
+
+CaptureWriter::CaptureWriter(const std::wstring& fileName)
+    : m_file(nullptr)
+    , m_startTime(std::chrono::steady_clock::now())
+{
+    if (_wfopen_s(&m_file, fileName.c_str(), L"wb") != 0 || !m_file)
+        throw std::runtime_error("Failed to create capture file");
+
+    FileHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.headerSize = sizeof(FileHeader);
+    fwrite(&header, sizeof(header), 1, m_file);
+
+    m_buffer.reserve(FLUSH_THRESHOLD * 2);
+}
+
+CaptureWriter::~CaptureWriter()
+{
+    if (m_file)
+    {
+        Flush();
+        fclose(m_file);
+    }
+}
+
+void CaptureWriter::WriteInitialize(UINT width, UINT height, const char* rendererName)
+{
+    std::wstring name(rendererName, rendererName + strlen(rendererName));
+
+    InitializePayload payload = {};
+    payload.width = width;
+    payload.height = height;
+    payload.nameLength = static_cast<uint32_t>(name.size());
+    WriteRecord(RecordType::Initialize, &payload, sizeof(payload), name.c_str(), name.size());
+}
+
+void CaptureWriter::WriteBeginFrame()
+{
+    WriteRecord(RecordType::BeginFrame, nullptr, 0, nullptr, 0);
+}
+
+void CaptureWriter::WriteClear(float r, float g, float b)
+{
+    ClearPayload payload = {};
+    payload.r = r;
+    payload.g = g;
+    payload.b = b;
+    WriteRecord(RecordType::Clear, &payload, sizeof(payload), nullptr, 0);
+}
+
+void CaptureWriter::WriteDrawText(const wchar_t* text, float x, float y, float fontSize,
+                                  float r, float g, float b, bool bold)
+{
+    size_t length = wcslen(text);
+
+    TextPayload payload = {};
+    payload.x = x;
+    payload.y = y;
+    payload.fontSize = fontSize;
+    payload.r = r;
+    payload.g = g;
+    payload.b = b;
+    payload.bold = bold ? 1 : 0;
+    payload.textLength = static_cast<uint32_t>(length);
+    WriteRecord(RecordType::DrawText, &payload, sizeof(payload), text, length);
+}
+
+void CaptureWriter::WriteMeasureText(const wchar_t* text, float fontSize, float width, float height)
+{
+    size_t length = wcslen(text);
+
+    TextPayload payload = {};
+    payload.x = width;
+    payload.y = height;
+    payload.fontSize = fontSize;
+    payload.textLength = static_cast<uint32_t>(length);
+    WriteRecord(RecordType::MeasureText, &payload, sizeof(payload), text, length);
+}
+
+void CaptureWriter::WriteEndFrame()
+{
+    WriteRecord(RecordType::EndFrame, nullptr, 0, nullptr, 0);
+
+    if (m_buffer.size() >= FLUSH_THRESHOLD)
+        Flush();
+}
+
+void CaptureWriter::Flush()
+{
+    if (!m_buffer.empty())
+    {
+        fwrite(m_buffer.data(), 1, m_buffer.size(), m_file);
+        m_buffer.clear();
+    }
+    fflush(m_file);
+}
+
+void CaptureWriter::WriteRecord(RecordType type, const void* payload, size_t payloadSize,
+                                const wchar_t* text, size_t textLength)
+{
+    size_t textBytes = text ? (textLength + 1) * sizeof(wchar_t) : 0;
+    size_t unpaddedSize = sizeof(RecordHeader) + payloadSize + textBytes;
+
+    RecordHeader header = {};
+    header.type = type;
+    header.size = AlignRecordSize(unpaddedSize);
+    header.timestampNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - m_startTime).count());
+
+    size_t offset = m_buffer.size();
+    m_buffer.resize(offset + header.size, 0);
+
+    uint8_t* dest = m_buffer.data() + offset;
+    std::memcpy(dest, &header, sizeof(header));
+    if (payloadSize)
+        std::memcpy(dest + sizeof(header), payload, payloadSize);
+    if (textBytes)
+        std::memcpy(dest + sizeof(header) + payloadSize, text, textBytes);
+}
+
+CaptureRenderer::CaptureRenderer(std::unique_ptr<IRenderer> inner, std::shared_ptr<CaptureWriter> writer)
+    : m_inner(std::move(inner))
+    , m_writer(std::move(writer))
+{
+}
+
+CaptureRenderer::~CaptureRenderer()
+{
+    if (m_writer)
+        m_writer->Flush();
+}
+
+void CaptureRenderer::Initialize(HWND hwnd, UINT width, UINT height)
+{
+    m_writer->WriteInitialize(width, height, m_inner->GetName());
+    m_inner->Initialize(hwnd, width, height);
+}
+
+void CaptureRenderer::InitializeSuspended(HWND hwnd, UINT width, UINT height)
+{
+    m_writer->WriteInitialize(width, height, m_inner->GetName());
+    m_inner->InitializeSuspended(hwnd, width, height);
+}
+
+void CaptureRenderer::BeginFrame()
+{
+    m_writer->WriteBeginFrame();
+    m_inner->BeginFrame();
+}
+
+void CaptureRenderer::Clear(float r, float g, float b)
+{
+    m_writer->WriteClear(r, g, b);
+    m_inner->Clear(r, g, b);
+}
+
+void CaptureRenderer::DrawText(const wchar_t* text, float x, float y, float fontSize,
+                               float r, float g, float b, bool bold)
+{
+    m_writer->WriteDrawText(text, x, y, fontSize, r, g, b, bold);
+    m_inner->DrawText(text, x, y, fontSize, r, g, b, bold);
+}
+
+void CaptureRenderer::MeasureText(const wchar_t* text, float fontSize,
+                                  float& outWidth, float& outHeight)
+{
+    // Measured after forwarding so the capture also holds the backend's answer
+    m_inner->MeasureText(text, fontSize, outWidth, outHeight);
+    m_writer->WriteMeasureText(text, fontSize, outWidth, outHeight);
+}
+
+void CaptureRenderer::EndFrame()
+{
+    m_inner->EndFrame();
+    m_writer->WriteEndFrame();
+}
+
+void CaptureRenderer::Resize(UINT width, UINT height)
+{
+    // Not recorded: replays run at the size of the capture's Initialize record
+    m_inner->Resize(width, height);
+}
+
+void CaptureRenderer::OnDestroy()
+{
+    m_inner->OnDestroy();
+    m_writer->Flush();
+}
@@ -1,6 +1,15 @@
 #include "DX12Renderer.h"
 #include "Logger.h"
+#include "StartupProfiler.h"
+#include "DirectXHelpers.h"
 #include <d3dcompiler.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <cwchar>
+#include <iterator>
 
 #pragma comment(lib, "d3d12.lib")
 #pragma comment(lib, "dxgi.lib")
@@ -17,8 +26,10 @@ DX12Renderer::DX12Renderer()
     , m_rtvDescriptorSize(0)
     , m_width(0)
     , m_height(0)
-    , m_fenceEvent(nullptr)
-    , m_fenceValue(0)
+    , m_frames(m_fence)
+    , m_fonts{ { L"arial24.spritefont", 24.0f }, { L"arial120.spritefont", 120.0f },
+               { L"arial120.digits.spritefont", 120.0f } }
+    , m_resources(std::make_shared<ResourceManager>())
 {
 }
 
@@ -28,6 +39,18 @@ DX12Renderer::~DX12Renderer()
 }
 
 void DX12Renderer::Initialize(HWND hwnd, UINT width, UINT height)
+{
+    InitializeDevice(hwnd, width, height, true);
+}
+
+void DX12Renderer::InitializeSuspended(HWND hwnd, UINT width, UINT height)
+{
+    // A flip-model swap chain must not be created on a window another backend presents
+    // to; Resume creates it once this renderer is current
+    InitializeDevice(hwnd, width, height, false);
+}
+
+void DX12Renderer::InitializeDevice(HWND hwnd, UINT width, UINT height, bool createSwapChain)
 {
     Logger::Log("DX12Renderer::Initialize - Starting");
     try
@@ -44,11 +67,20 @@ void DX12Renderer::Initialize(HWND hwnd, UINT width, UINT height)
         m_scissorRect.bottom = static_cast<LONG>(height);
 
         Logger::Log("Loading pipeline...");
-        LoadPipeline(hwnd);
+        {
+            StartupProfiler::Scope phase("LoadPipeline");
+            LoadPipeline(createSwapChain);
+        }
         Logger::Log("Loading assets...");
-        LoadAssets();
+        {
+            StartupProfiler::Scope phase("LoadAssets");
+            LoadAssets();
+        }
         Logger::Log("Initializing SpriteBatch...");
-        InitializeSpriteBatch();
+        {
+            StartupProfiler::Scope phase("InitializeSpriteBatch");
+            InitializeSpriteBatch();
+        }
         Logger::Log("DX12Renderer::Initialize - Complete");
     }
     catch (const std::exception& e)
@@ -57,7 +89,7 @@ void DX12Renderer::Initialize(HWND hwnd, UINT width, UINT height)
         throw;
     }
 }
-void DX12Renderer::LoadPipeline(HWND hwnd)
+void DX12Renderer::LoadPipeline(bool createSwapChain)
 {
     HRESULT hr;
     UINT dxgiFactoryFlags = 0;
@@ -75,13 +107,12 @@ void DX12Renderer::LoadPipeline(HWND hwnd)
 #endif
 
     Logger::Log("Creating DXGI factory...");
-    ComPtr<IDXGIFactory4> factory;
-    hr = CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&factory));
+    hr = CreateDXGIFactory2(dxgiFactoryFlags, IID_PPV_ARGS(&m_factory));
     CHECK_HR(hr, "Failed to create DXGI factory");
 
     Logger::Log("Enumerating adapters...");
     ComPtr<IDXGIAdapter1> hardwareAdapter;
-    hr = factory->EnumAdapters1(0, &hardwareAdapter);
+    hr = m_factory->EnumAdapters1(0, &hardwareAdapter);
     CHECK_HR(hr, "Failed to enumerate adapters");
 
     Logger::Log("Creating D3D12 device...");
@@ -95,6 +126,31 @@ void DX12Renderer::LoadPipeline(HWND hwnd)
     hr = m_device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&m_commandQueue));
     CHECK_HR(hr, "Failed to create command queue");
 
+    D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
+    rtvHeapDesc.NumDescriptors = FRAME_COUNT;
+    rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+    rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+    m_device->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&m_rtvHeap));
+
+    m_rtvDescriptorSize = m_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
+
+    if (createSwapChain)
+    {
+        CreateSwapChain();
+        CreateRenderTargets();
+    }
+
+    // Allocators for the deepest queue, so SetFramesInFlight never has to create them
+    for (UINT n = 0; n < MAX_FRAMES_IN_FLIGHT; n++)
+    {
+        hr = m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT,
+                                              IID_PPV_ARGS(&m_frames.GetContext(n).commandAllocator));
+        CHECK_HR(hr, "Failed to create command allocator");
+    }
+}
+
+void DX12Renderer::CreateSwapChain()
+{
     DXGI_SWAP_CHAIN_DESC1 swapChainDesc = {};
     swapChainDesc.BufferCount = FRAME_COUNT;
     swapChainDesc.Width = m_width;
@@ -105,27 +161,23 @@ void DX12Renderer::LoadPipeline(HWND hwnd)
     swapChainDesc.SampleDesc.Count = 1;
 
     ComPtr<IDXGISwapChain1> swapChain;
-    factory->CreateSwapChainForHwnd(
+    HRESULT hr = m_factory->CreateSwapChainForHwnd(
         m_commandQueue.Get(),
-        hwnd,
+        m_hwnd,
         &swapChainDesc,
         nullptr,
         nullptr,
         &swapChain
     );
+    CHECK_HR(hr, "Failed to create swap chain");
 
-    factory->MakeWindowAssociation(hwnd, DXGI_MWA_NO_ALT_ENTER);
+    m_factory->MakeWindowAssociation(m_hwnd, DXGI_MWA_NO_ALT_ENTER);
     swapChain.As(&m_swapChain);
     m_frameIndex = m_swapChain->GetCurrentBackBufferIndex();
+}
 
-    D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
-    rtvHeapDesc.NumDescriptors = FRAME_COUNT;
-    rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
-    rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-    m_device->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&m_rtvHeap));
-
-    m_rtvDescriptorSize = m_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
-
+void DX12Renderer::CreateRenderTargets()
+{
     D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle(m_rtvHeap->GetCPUDescriptorHandleForHeapStart());
 
     for (UINT n = 0; n < FRAME_COUNT; n++)
@@ -134,20 +186,18 @@ void DX12Renderer::LoadPipeline(HWND hwnd)
         m_device->CreateRenderTargetView(m_renderTargets[n].Get(), nullptr, rtvHandle);
         rtvHandle.ptr += m_rtvDescriptorSize;
     }
-
-    m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&m_commandAllocator));
 }
 
-
 void DX12Renderer::LoadAssets()
 {
-    m_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, m_commandAllocator.Get(), nullptr, IID_PPV_ARGS(&m_commandList));
+    m_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, m_frames.Current().commandAllocator.Get(),
+                                nullptr, IID_PPV_ARGS(&m_commandList));
     m_commandList->Close();
 
-    m_device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence));
-    m_fenceValue = 1;
+    HRESULT hr = m_device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence.fence));
+    CHECK_HR(hr, "Failed to create fence");
 
-    m_fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    m_fence.event = CreateEvent(nullptr, FALSE, FALSE, nullptr);
 }
 
 
@@ -159,7 +209,7 @@ void DX12Renderer::InitializeSpriteBatch()
 
     // Create descriptor heap for sprite fonts
     D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
-    heapDesc.NumDescriptors = 2; // One for each font
+    heapDesc.NumDescriptors = FONT_COUNT + OUTLINE_PAGE_COUNT; // One for each font and outline page
     heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
     heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
     HRESULT hr = m_device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&m_fontHeap));
@@ -168,65 +218,163 @@ void DX12Renderer::InitializeSpriteBatch()
     // Initialize Graphics Memory
     m_graphicsMemory = std::make_unique<GraphicsMemory>(m_device.Get());
 
-    // Create Resource Upload Batch for loading fonts
+    // Fonts load on worker threads when first used (already resident if another renderer
+    // on the same manager loaded them) and are uploaded by PollFont, so frames never wait
+    for (FontSlot& slot : m_fonts)
+        slot = FontSlot{ slot.fileName, slot.size };
+
+    // SpriteBatch's index buffer is copied ahead of the first frame on the same queue
     ResourceUploadBatch resourceUpload(m_device.Get());
     resourceUpload.Begin();
+    DirectX::RenderTargetState rtState(DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_UNKNOWN);
+    DirectX::SpriteBatchPipelineStateDescription pd(rtState);
+    m_spriteBatch = std::make_unique<SpriteBatch>(m_device.Get(), resourceUpload, pd, &m_viewport);
+    m_uploads.push_back(resourceUpload.End(m_commandQueue.Get()));
 
-    // Get descriptor handles
-    CD3DX12_CPU_DESCRIPTOR_HANDLE cpuHandle(m_fontHeap->GetCPUDescriptorHandleForHeapStart());
-    CD3DX12_GPU_DESCRIPTOR_HANDLE gpuHandle(m_fontHeap->GetGPUDescriptorHandleForHeapStart());
+    Logger::Log("SpriteBatch initialized successfully");
+}
 
-    // Load sprite fonts
-    try
-    {
-        // Small font (24pt)
-        m_font = std::make_unique<SpriteFont>(
-            m_device.Get(),
-            resourceUpload,
-            L"arial24.spritefont",
-            cpuHandle,
-            gpuHandle
-        );
-
-        // Move to next descriptor
-        UINT descriptorSize = m_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-        cpuHandle.Offset(1, descriptorSize);
-        gpuHandle.Offset(1, descriptorSize);
-
-        // Large font (120pt bold)
-        m_largeFont = std::make_unique<SpriteFont>(
-            m_device.Get(),
-            resourceUpload,
-            L"arial120.spritefont",
-            cpuHandle,
-            gpuHandle
-        );
-
-        Logger::Log("Sprite fonts loaded successfully");
-    }
-    catch (const std::exception& e)
+std::unique_ptr<DirectX::SpriteFont> DX12Renderer::CreateSpriteFont(TextureHandle handle, DirectX::ResourceUploadBatch& upload,
+                                                                    D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle,
+                                                                    D3D12_GPU_DESCRIPTOR_HANDLE gpuHandle,
+                                                                    ComPtr<ID3D12Resource>& texture)
+{
+    using namespace DirectX;
+
+    // Same upload SpriteFont does when it reads the file itself
+    const SpriteFontData& data = m_resources->GetTexture(handle);
+    CD3DX12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Tex2D(static_cast<DXGI_FORMAT>(data.textureFormat),
+                                                              data.textureWidth, data.textureHeight, 1, 1);
+    CD3DX12_HEAP_PROPERTIES heapProperties(D3D12_HEAP_TYPE_DEFAULT);
+    HRESULT hr = m_device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &desc,
+                                                   D3D12_RESOURCE_STATE_COPY_DEST, nullptr,
+                                                   IID_PPV_ARGS(texture.ReleaseAndGetAddressOf()));
+    CHECK_HR(hr, "Failed to create font texture");
+
+    D3D12_SUBRESOURCE_DATA subresource = {};
+    subresource.pData = data.GetTextureData();
+    subresource.RowPitch = static_cast<LONG_PTR>(data.textureStride);
+    subresource.SlicePitch = static_cast<LONG_PTR>(data.textureStride) * data.textureRows;
+    upload.Upload(texture.Get(), 0, &subresource, 1);
+    upload.Transition(texture.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    CreateShaderResourceView(m_device.Get(), texture.Get(), cpuHandle);
+
+    // SpriteFontGlyph matches SpriteFont::Glyph field for field
+    using Glyph = SpriteFont::Glyph;
+    static_assert(sizeof(Glyph) == sizeof(SpriteFontGlyph), "SpriteFont::Glyph size differs from SpriteFontGlyph");
+    static_assert(offsetof(Glyph, Character) == offsetof(SpriteFontGlyph, character), "Glyph character offset differs");
+    static_assert(offsetof(Glyph, Subrect) + offsetof(RECT, left) == offsetof(SpriteFontGlyph, left) &&
+                  offsetof(Glyph, Subrect) + offsetof(RECT, top) == offsetof(SpriteFontGlyph, top) &&
+                  offsetof(Glyph, Subrect) + offsetof(RECT, right) == offsetof(SpriteFontGlyph, right) &&
+                  offsetof(Glyph, Subrect) + offsetof(RECT, bottom) == offsetof(SpriteFontGlyph, bottom),
+                  "Glyph subrect layout differs");
+    static_assert(sizeof(RECT::left) == sizeof(SpriteFontGlyph::left), "Glyph subrect field size differs");
+    static_assert(offsetof(Glyph, XOffset) == offsetof(SpriteFontGlyph, xOffset) &&
+                  offsetof(Glyph, YOffset) == offsetof(SpriteFontGlyph, yOffset) &&
+                  offsetof(Glyph, XAdvance) == offsetof(SpriteFontGlyph, xAdvance),
+                  "Glyph offset and advance layout differs");
+    auto font = std::make_unique<SpriteFont>(gpuHandle, XMUINT2(data.textureWidth, data.textureHeight),
+                                             reinterpret_cast<const SpriteFont::Glyph*>(data.glyphs.data()),
+                                             data.glyphs.size(), data.lineSpacing);
+    font->SetDefaultCharacter(static_cast<wchar_t>(data.defaultCharacter));
+    return font;
+}
+
+const wchar_t* DX12Renderer::GetSpriteFontName(const wchar_t* text, float fontSize, float& outScale) const
+{
+    outScale = 1.0f;
+    if (m_resources->GetOutlineFont())
+        return nullptr;
+
+    const FontSlot& slot = m_fonts[GetFontIndex(text, fontSize)];
+    outScale = fontSize / slot.size;
+    return slot.fileName;
+}
+
+int DX12Renderer::GetFontIndex(const wchar_t* text, float fontSize) const
+{
+    if (fontSize <= LARGE_FONT_MIN_SIZE)
+        return SMALL_FONT;
+
+    bool digitsOnly = *text && text[wcsspn(text, L"0123456789")] == L'\0';
+    return digitsOnly && !m_fonts[DIGITS_FONT].failed ? DIGITS_FONT : LARGE_FONT;
+}
+
+const DX12Renderer::FontSlot* DX12Renderer::SelectFont(const wchar_t* text, float fontSize, bool forDraw)
+{
+    int index = GetFontIndex(text, fontSize);
+    FontSlot& slot = m_fonts[index];
+    std::shared_future<FontHandle>& request = forDraw ? slot.textureRequest : slot.metricsRequest;
+    if (!request.valid())
+        request = m_resources->RequestFont(slot.fileName, forDraw ? FontPart::Texture : FontPart::Metrics);
+
+    bool needsTexture = forDraw || slot.textureRequest.valid();
+    for (int candidate : { index, SMALL_FONT })
     {
-        Logger::LogError(std::string("Failed to load sprite fonts: ") + e.what());
-        throw;
+        PollFont(candidate);
+        const FontSlot& font = m_fonts[candidate];
+        if (needsTexture ? font.font != nullptr : static_cast<bool>(font.data))
+            return &font;
     }
+    return nullptr;
+}
 
-    // Create SpriteBatch (BEFORE ending resource upload)
-    DirectX::RenderTargetState rtState(DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_UNKNOWN);
-    DirectX::SpriteBatchPipelineStateDescription pd(rtState);
-    m_spriteBatch = std::make_unique<SpriteBatch>(m_device.Get(), resourceUpload, pd, &m_viewport);
+void DX12Renderer::PollFont(int index)
+{
+    using namespace DirectX;
 
-    // Upload font resources
-    auto uploadResourcesFinished = resourceUpload.End(m_commandQueue.Get());
-    uploadResourcesFinished.wait();
+    FontSlot& slot = m_fonts[index];
+    if (slot.failed || (slot.data && (slot.font || !slot.textureRequest.valid())))
+        return;
 
-    Logger::Log("SpriteBatch initialized successfully");
+    if (!slot.data)
+        slot.data = m_resources->FindFont(slot.fileName);
+    TextureHandle texture = slot.data && slot.textureRequest.valid() ? m_resources->FindFontTexture(slot.data)
+                                                                     : TextureHandle();
+    if (texture)
+    {
+        // The copy is queued ahead of every frame submitted after it, so the font can be
+        // drawn with right away; only the staging memory waits for it to finish
+        UINT descriptorSize = m_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+        CD3DX12_CPU_DESCRIPTOR_HANDLE cpuHandle(m_fontHeap->GetCPUDescriptorHandleForHeapStart(), index, descriptorSize);
+        CD3DX12_GPU_DESCRIPTOR_HANDLE gpuHandle(m_fontHeap->GetGPUDescriptorHandleForHeapStart(), index, descriptorSize);
+        ResourceUploadBatch upload(m_device.Get());
+        upload.Begin();
+        slot.font = CreateSpriteFont(texture, upload, cpuHandle, gpuHandle, slot.texture);
+        m_uploads.push_back(upload.End(m_commandQueue.Get()));
+    }
+
+    // A failed bucket stays on its fallback
+    auto checkFailed = [&](const std::shared_future<FontHandle>& request, bool resident)
+    {
+        if (resident || !request.valid() || request.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return;
+        try
+        {
+            request.get();
+        }
+        catch (const std::exception& e)
+        {
+            Logger::LogWarning(std::string("Failed to load sprite font: ") + e.what());
+            slot.failed = true;
+        }
+    };
+    checkFailed(slot.metricsRequest, static_cast<bool>(slot.data));
+    checkFailed(slot.textureRequest, slot.font != nullptr);
 }
 
+void DX12Renderer::SetResources(std::shared_ptr<ResourceManager> resources)
+{
+    if (resources)
+        m_resources = std::move(resources);
+}
 
 void DX12Renderer::BeginFrame()
 {
-    m_commandAllocator->Reset();
-    m_commandList->Reset(m_commandAllocator.Get(), nullptr);
+    // Blocks only if the GPU is still on the frame that last used this allocator
+    FrameContext& frame = m_frames.BeginFrame();
+    frame.commandAllocator->Reset();
+    m_commandList->Reset(frame.commandAllocator.Get(), nullptr);
 
     // Transition to render target
     D3D12_RESOURCE_BARRIER barrier = {};
@@ -242,6 +390,12 @@ void DX12Renderer::BeginFrame()
     D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle(m_rtvHeap->GetCPUDescriptorHandleForHeapStart());
     rtvHandle.ptr += m_frameIndex * m_rtvDescriptorSize;
     m_commandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
+
+    // Font uploads whose copies have retired no longer need their staging memory
+    m_uploads.erase(std::remove_if(m_uploads.begin(), m_uploads.end(), [](const std::future<void>& upload)
+    {
+        return upload.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }), m_uploads.end());
 }
 
 void DX12Renderer::Clear(float r, float g, float b)
@@ -269,28 +423,197 @@ void DX12Renderer::DrawText(const wchar_t* text, float x, float y, float fontSiz
     using namespace DirectX;
 
     XMVECTOR color = XMVectorSet(r, g, b, 1.0f);
+    if (GlyphCache* cache = GetOutlineCache())
+    {
+        DrawOutlineText(*cache, text, x, y, fontSize, color);
+        return;
+    }
 
-    // Choose font based on size (threshold at 60pt)
-    DirectX::SpriteFont* font = (fontSize > 60.0f) ? m_largeFont.get() : m_font.get();
-
-    font->DrawString(m_spriteBatch.get(), text, XMFLOAT2(x, y), color);
+    // Scaled about the text origin; the sprite batch's linear sampler filters the atlas
+    const FontSlot* slot = SelectFont(text, fontSize, true);
+    if (slot)
+    {
+        slot->font->DrawString(m_spriteBatch.get(), text, XMFLOAT2(x, y), color, 0.0f, XMFLOAT2(0.0f, 0.0f),
+                               fontSize / slot->size);
+    }
 }
 
 void DX12Renderer::MeasureText(const wchar_t* text, float fontSize,
                                float& outWidth, float& outHeight)
+{
+    if (std::shared_ptr<const TrueTypeFont> outline = m_resources->GetOutlineFont())
+    {
+        outline->MeasureText(text, fontSize, outWidth, outHeight);
+        return;
+    }
+
+    const FontSlot* slot = SelectFont(text, fontSize, false);
+    if (!slot)
+    {
+        outWidth = 0.0f;
+        outHeight = 0.0f;
+        return;
+    }
+    m_resources->GetFont(slot->data).glyphs.MeasureText(text, outWidth, outHeight);
+    outWidth *= fontSize / slot->size;
+    outHeight *= fontSize / slot->size;
+}
+
+GlyphCache* DX12Renderer::GetOutlineCache()
+{
+    std::shared_ptr<const TrueTypeFont> font = m_resources->GetOutlineFont();
+    if (!font)
+        return nullptr;
+
+    // A new outline font starts a new cache, whose pages replace the textures' contents
+    if (!m_outlineCache || m_outlineFont != font)
+    {
+        if (std::any_of(std::begin(m_outlinePages), std::end(m_outlinePages),
+                        [](const OutlinePage& page) { return page.queued; }))
+            FlushOutlineBatch();
+        m_outlineFont = font;
+        m_outlineCache = std::make_unique<GlyphCache>(std::make_unique<OutlineGlyphSource>(std::move(font)),
+                                                      OUTLINE_PAGE_SIZE, OUTLINE_PAGE_COUNT);
+        m_outlineCache->SetEvictionHandler([this](uint32_t page)
+        {
+            if (m_outlinePages[page].queued)
+                FlushOutlineBatch();
+        });
+        for (OutlinePage& page : m_outlinePages)
+            page.uploadedVersion = UINT64_MAX;
+    }
+    return m_outlineCache.get();
+}
+
+void DX12Renderer::DrawOutlineText(GlyphCache& cache, const wchar_t* text, float x, float y,
+                                   float fontSize, DirectX::FXMVECTOR color)
 {
     using namespace DirectX;
 
-    // Choose font based on size
-    DirectX::SpriteFont* font = (fontSize > 60.0f) ? m_largeFont.get() : m_font.get();
+    // Laid out like SoftwareRenderer: lines a cell apart, the baseline an ascent below the
+    // top. Glyphs are drawn 1:1 at whole pixels, so the sampler reads each texel as is.
+    const TrueTypeFont& font = *m_outlineFont;
+    float scale = font.GetScale(fontSize);
+    long baseline = std::lround(y + font.GetAscent() * scale);
+    float penX = 0.0f;
+    for (; *text; text++)
+    {
+        wchar_t character = *text;
+        if (character == L'\r')
+            continue;
+
+        if (character == L'\n')
+        {
+            penX = 0.0f;
+            baseline += std::lround(fontSize);
+            continue;
+        }
 
-    XMVECTOR size = font->MeasureString(text);
-    outWidth = XMVectorGetX(size);
-    outHeight = XMVectorGetY(size);
+        const CachedGlyph& glyph = cache.GetGlyph(font.FindGlyph(character), fontSize);
+        if (glyph.page != GlyphCache::NO_PAGE)
+        {
+            RECT source = { static_cast<LONG>(glyph.x), static_cast<LONG>(glyph.y),
+                            static_cast<LONG>(glyph.x + glyph.bitmap.width),
+                            static_cast<LONG>(glyph.y + glyph.bitmap.height) };
+            XMFLOAT2 position(static_cast<float>(std::lround(x + penX) + glyph.bitmap.left),
+                              static_cast<float>(baseline - glyph.bitmap.top));
+            m_spriteBatch->Draw(GetOutlinePageHandle(glyph.page), XMUINT2(OUTLINE_PAGE_SIZE, OUTLINE_PAGE_SIZE),
+                                position, &source, color);
+            m_outlinePages[glyph.page].queued = true;
+        }
+        penX += glyph.advance;
+    }
+}
+
+void DX12Renderer::UploadOutlinePages()
+{
+    using namespace DirectX;
+
+    if (!m_outlineCache)
+        return;
+
+    UINT descriptorSize = m_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    for (uint32_t index = 0; index < m_outlineCache->GetPageCount(); index++)
+    {
+        OutlinePage& page = m_outlinePages[index];
+        uint64_t version = m_outlineCache->GetPageVersion(index);
+        if (page.texture && page.uploadedVersion == version)
+            continue;
+
+        if (!page.texture)
+        {
+            CD3DX12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8_UNORM, OUTLINE_PAGE_SIZE,
+                                                                      OUTLINE_PAGE_SIZE, 1, 1);
+            CD3DX12_HEAP_PROPERTIES heapProperties(D3D12_HEAP_TYPE_DEFAULT);
+            HRESULT hr = m_device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &desc,
+                                                           D3D12_RESOURCE_STATE_COPY_DEST, nullptr,
+                                                           IID_PPV_ARGS(page.texture.ReleaseAndGetAddressOf()));
+            CHECK_HR(hr, "Failed to create glyph cache texture");
+
+            // Coverage in every channel: premultiplied white, like the sprite font atlases
+            D3D12_SHADER_RESOURCE_VIEW_DESC view = {};
+            view.Format = DXGI_FORMAT_R8_UNORM;
+            view.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+            view.Shader4ComponentMapping = D3D12_ENCODE_SHADER_4_COMPONENT_MAPPING(
+                D3D12_SHADER_COMPONENT_MAPPING_FROM_MEMORY_COMPONENT_0, D3D12_SHADER_COMPONENT_MAPPING_FROM_MEMORY_COMPONENT_0,
+                D3D12_SHADER_COMPONENT_MAPPING_FROM_MEMORY_COMPONENT_0, D3D12_SHADER_COMPONENT_MAPPING_FROM_MEMORY_COMPONENT_0);
+            view.Texture2D.MipLevels = 1;
+            CD3DX12_CPU_DESCRIPTOR_HANDLE cpuHandle(m_fontHeap->GetCPUDescriptorHandleForHeapStart(),
+                                                    FONT_COUNT + index, descriptorSize);
+            m_device->CreateShaderResourceView(page.texture.Get(), &view, cpuHandle);
+        }
+        else
+        {
+            CD3DX12_RESOURCE_BARRIER toCopy = CD3DX12_RESOURCE_BARRIER::Transition(
+                page.texture.Get(), D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_COPY_DEST);
+            m_commandList->ResourceBarrier(1, &toCopy);
+        }
+
+        // The whole page: a row is 1024 bytes, already a multiple of the pitch alignment.
+        // GraphicsMemory keeps the staging copy until the GPU has finished this frame.
+        static_assert(OUTLINE_PAGE_SIZE % D3D12_TEXTURE_DATA_PITCH_ALIGNMENT == 0, "Page rows need padding");
+        size_t bytes = static_cast<size_t>(OUTLINE_PAGE_SIZE) * OUTLINE_PAGE_SIZE;
+        GraphicsResource staging = m_graphicsMemory->Allocate(bytes, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+        memcpy(staging.Memory(), m_outlineCache->GetPagePixels(index), bytes);
+
+        D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint = {};
+        footprint.Offset = staging.ResourceOffset();
+        footprint.Footprint = { DXGI_FORMAT_R8_UNORM, OUTLINE_PAGE_SIZE, OUTLINE_PAGE_SIZE, 1, OUTLINE_PAGE_SIZE };
+        CD3DX12_TEXTURE_COPY_LOCATION destination(page.texture.Get(), 0);
+        CD3DX12_TEXTURE_COPY_LOCATION source(staging.Resource(), footprint);
+        m_commandList->CopyTextureRegion(&destination, 0, 0, 0, &source, nullptr);
+
+        CD3DX12_RESOURCE_BARRIER toShader = CD3DX12_RESOURCE_BARRIER::Transition(
+            page.texture.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+        m_commandList->ResourceBarrier(1, &toShader);
+        page.uploadedVersion = version;
+    }
+}
+
+void DX12Renderer::FlushOutlineBatch()
+{
+    // Deferred SpriteBatch records its draws at End, after the copies recorded here
+    UploadOutlinePages();
+    m_spriteBatch->End();
+    m_spriteBatch->Begin(m_commandList.Get());
+    for (OutlinePage& page : m_outlinePages)
+        page.queued = false;
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE DX12Renderer::GetOutlinePageHandle(uint32_t page) const
+{
+    UINT descriptorSize = m_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    return CD3DX12_GPU_DESCRIPTOR_HANDLE(m_fontHeap->GetGPUDescriptorHandleForHeapStart(), FONT_COUNT + page,
+                                         descriptorSize);
 }
 
 void DX12Renderer::EndFrame()
 {
+    // Glyphs rasterized this frame reach their pages ahead of the batch's draws
+    UploadOutlinePages();
+    for (OutlinePage& page : m_outlinePages)
+        page.queued = false;
+
     // End sprite batch
     m_spriteBatch->End();
 
@@ -313,48 +636,112 @@ void DX12Renderer::EndFrame()
     // Present
     m_swapChain->Present(1, 0);
 
-    // Wait for frame completion
-    WaitForPreviousFrame();
+    // Retire the frame on the GPU timeline instead of waiting for it here
+    m_commandQueue->Signal(m_fence.fence.Get(), m_frames.EndFrame());
+    m_frameIndex = m_swapChain->GetCurrentBackBufferIndex();
 
     // Update graphics memory (DirectXTK12 requirement)
     m_graphicsMemory->Commit(m_commandQueue.Get());
 }
 
-void DX12Renderer::WaitForPreviousFrame()
+void DX12Renderer::Resize(UINT width, UINT height)
+{
+    if (!m_swapChain || (width == m_width && height == m_height))
+        return;
+
+    // The GPU must be done with the back buffers before they can be released
+    WaitForGpu();
+    for (UINT n = 0; n < FRAME_COUNT; n++)
+        m_renderTargets[n].Reset();
+
+    HRESULT hr = m_swapChain->ResizeBuffers(FRAME_COUNT, width, height, DXGI_FORMAT_R8G8B8A8_UNORM, 0);
+    CHECK_HR(hr, "Failed to resize swap chain");
+
+    m_width = width;
+    m_height = height;
+    CreateRenderTargets();
+    m_frameIndex = m_swapChain->GetCurrentBackBufferIndex();
+    SetViewportSize(width, height);
+}
+
+void DX12Renderer::Suspend()
 {
-    const UINT64 fence = m_fenceValue;
-    m_commandQueue->Signal(m_fence.Get(), fence);
-    m_fenceValue++;
+    if (!m_swapChain)
+        return;
+
+    // Back buffers must be idle before the swap chain can go
+    WaitForGpu();
+    for (UINT n = 0; n < FRAME_COUNT; n++)
+        m_renderTargets[n].Reset();
+    m_swapChain.Reset();
+}
 
-    if (m_fence->GetCompletedValue() < fence)
+void DX12Renderer::Resume(UINT width, UINT height)
+{
+    if (m_swapChain || !m_device)
     {
-        m_fence->SetEventOnCompletion(fence, m_fenceEvent);
-        WaitForSingleObject(m_fenceEvent, INFINITE);
+        Resize(width, height);
+        return;
     }
 
-    m_frameIndex = m_swapChain->GetCurrentBackBufferIndex();
+    // Suspended or initialized without a swap chain: only that is missing, and the RTV
+    // heap is reused for the new back buffers
+    m_width = width;
+    m_height = height;
+    CreateSwapChain();
+    CreateRenderTargets();
+    SetViewportSize(width, height);
 }
 
-void DX12Renderer::OnDestroy()
+void DX12Renderer::SetViewportSize(UINT width, UINT height)
+{
+    m_viewport.Width = static_cast<float>(width);
+    m_viewport.Height = static_cast<float>(height);
+    m_scissorRect.right = static_cast<LONG>(width);
+    m_scissorRect.bottom = static_cast<LONG>(height);
+    m_spriteBatch->SetViewport(m_viewport);
+}
+
+void DX12Renderer::WaitForGpu()
 {
-    if (m_device)
+    m_frames.WaitIdle();
+}
+
+void DX12Renderer::GpuFence::Wait(uint64_t value)
+{
+    // Nothing can have been submitted before the fence exists
+    if (fence && fence->GetCompletedValue() < value)
     {
-        WaitForPreviousFrame();
+        fence->SetEventOnCompletion(value, event);
+        WaitForSingleObject(event, INFINITE);
     }
+}
+
+void DX12Renderer::OnDestroy()
+{
+    WaitForGpu();
 
     if (m_swapChain)
     {
         m_swapChain->SetFullscreenState(FALSE, nullptr);
     }
 
-    if (m_fenceEvent)
+    if (m_fence.event)
     {
-        CloseHandle(m_fenceEvent);
-        m_fenceEvent = nullptr;
+        CloseHandle(m_fence.event);
+        m_fence.event = nullptr;
     }
 
+    m_uploads.clear();
     m_spriteBatch.reset();
-    m_font.reset();
-    m_largeFont.reset();
+    for (FontSlot& slot : m_fonts)
+    {
+        slot.font.reset();
+        slot.texture.Reset();
+    }
+    m_outlineCache.reset();
+    m_outlineFont.reset();
+    for (OutlinePage& page : m_outlinePages)
+        page = OutlinePage();
     m_graphicsMemory.reset();
 }
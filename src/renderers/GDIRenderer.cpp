@@ -110,6 +110,21 @@ void GDIRenderer::EndFrame()
     BitBlt(m_windowDC, 0, 0, m_width, m_height, m_memoryDC, 0, 0, SRCCOPY);
 }
 
+void GDIRenderer::Resize(UINT width, UINT height)
+{
+    m_width = width;
+    m_height = height;
+
+    if (!m_memoryDC)
+        return;
+
+    // Swap in a back buffer of the new size
+    HBITMAP bitmap = CreateCompatibleBitmap(m_windowDC, width, height);
+    SelectObject(m_memoryDC, bitmap);
+    DeleteObject(m_memoryBitmap);
+    m_memoryBitmap = bitmap;
+}
+
 void GDIRenderer::OnDestroy()
 {
     if (m_memoryDC)
@@ -0,0 +1,47 @@
+#include "RendererFactory.h"
+#include "GDIRenderer.h"
+#include "DX12Renderer.h"
+#include "SoftwareRenderer.h"
+#include "Logger.h"
+
+// Create renderer based on type
+std::unique_ptr<IRenderer> CreateRenderer(RendererType type)
+{
+    switch (type)
+    {
+    case RendererType::GDI:
+        Logger::Log("Creating GDI Renderer...");
+        return std::make_unique<GDIRenderer>();
+
+    case RendererType::DirectX12:
+        Logger::Log("Creating DirectX 12 Renderer...");
+        return std::make_unique<DX12Renderer>();
+
+    case RendererType::Software:
+        Logger::Log("Creating Software Renderer...");
+        return std::make_unique<SoftwareRenderer>();
+
+    default:
+        return nullptr;
+    }
+}
+
+bool ParseRendererType(const std::string& name, RendererType& outType)
+{
+    if (name == "gdi")
+    {
+        outType = RendererType::GDI;
+        return true;
+    }
+    if (name == "dx12")
+    {
+        outType = RendererType::DirectX12;
+        return true;
+    }
+    if (name == "software")
+    {
+        outType = RendererType::Software;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,131 @@
+#include "RendererPool.h"
+#include "Logger.h"
+#include <chrono>
+#include <stdexcept>
+
+namespace
+{
+    // Suspended renderers get no presentation surface until they are resumed
+    std::unique_ptr<IRenderer> CreateInitialized(const RendererPool::Factory& factory, RendererType type,
+                                                 HWND hwnd, UINT width, UINT height,
+                                                 std::shared_ptr<ResourceManager> resources, bool suspended)
+    {
+        std::unique_ptr<IRenderer> renderer = factory(type);
+        if (!renderer)
+            throw std::runtime_error("Unknown renderer type " + std::to_string(static_cast<int>(type)));
+        renderer->SetResources(std::move(resources));
+        if (suspended)
+            renderer->InitializeSuspended(hwnd, width, height);
+        else
+            renderer->Initialize(hwnd, width, height);
+        return renderer;
+    }
+
+    // Initialization on the background thread may send messages to the window's thread,
+    // so when that is the waiting thread it keeps handling them
+    std::unique_ptr<IRenderer> WaitForPrewarm(std::future<std::unique_ptr<IRenderer>>& pending)
+    {
+        MSG msg;
+        while (pending.wait_for(std::chrono::milliseconds(1)) != std::future_status::ready)
+            PeekMessageW(&msg, nullptr, 0, 0, PM_NOREMOVE | PM_QS_SENDMESSAGE);
+        return pending.get();
+    }
+}
+
+RendererPool::RendererPool(Factory factory)
+    : m_factory(std::move(factory))
+    , m_current(-1)
+{
+}
+
+RendererPool::~RendererPool()
+{
+    Clear();
+}
+
+void RendererPool::Prewarm(const Engine& engine, RendererType type)
+{
+    Slot& slot = m_slots[static_cast<int>(type)];
+    if (static_cast<int>(type) == m_current || slot.renderer || slot.pending.valid())
+        return;
+
+    Factory factory = m_factory;
+    HWND hwnd = engine.GetWindow();
+    UINT width = engine.GetWidth();
+    UINT height = engine.GetHeight();
+    std::shared_ptr<ResourceManager> resources = engine.GetResources();
+
+    slot.pending = std::async(std::launch::async, [=]
+    {
+        return CreateInitialized(factory, type, hwnd, width, height, resources, true);
+    });
+}
+
+bool RendererPool::Switch(Engine& engine, RendererType type)
+{
+    int index = static_cast<int>(type);
+    if (index == m_current)
+        return true;
+
+    Slot& slot = m_slots[index];
+    std::unique_ptr<IRenderer> renderer = std::move(slot.renderer);
+    bool warm = renderer != nullptr;
+
+    if (!renderer && slot.pending.valid())
+    {
+        warm = slot.pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        try
+        {
+            renderer = WaitForPrewarm(slot.pending);
+        }
+        catch (const std::exception& e)
+        {
+            // Retried below, where a second failure reaches the caller
+            Logger::LogError(std::string("Background renderer initialization failed: ") + e.what());
+            warm = false;
+        }
+    }
+
+    if (!renderer)
+        renderer = CreateInitialized(m_factory, type, engine.GetWindow(), engine.GetWidth(), engine.GetHeight(),
+                                     engine.GetResources(), false);
+
+    std::unique_ptr<IRenderer> previous = engine.SwapRenderer(std::move(renderer));
+    if (previous && m_current >= 0)
+        m_slots[m_current].renderer = std::move(previous);
+    else if (previous)
+        previous->OnDestroy();
+    m_current = index;
+    return warm;
+}
+
+bool RendererPool::IsWarm(RendererType type) const
+{
+    const Slot& slot = m_slots[static_cast<int>(type)];
+    return slot.renderer || (slot.pending.valid() &&
+                             slot.pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+}
+
+void RendererPool::Clear()
+{
+    for (Slot& slot : m_slots)
+    {
+        if (slot.pending.valid())
+        {
+            try
+            {
+                slot.renderer = WaitForPrewarm(slot.pending);
+            }
+            catch (const std::exception& e)
+            {
+                Logger::Log(std::string("Discarding failed background renderer: ") + e.what());
+            }
+        }
+
+        if (slot.renderer)
+        {
+            slot.renderer->OnDestroy();
+            slot.renderer.reset();
+        }
+    }
+}
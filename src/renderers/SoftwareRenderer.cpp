@@ -0,0 +1,581 @@
+#include "SoftwareRenderer.h"
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cwchar>
+
+namespace
+{
+    uint8_t ToByte(float value)
+    {
+        return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+
+    uint32_t PackColor(uint8_t r, uint8_t g, uint8_t b)
+    {
+        return 0xFF000000u | (static_cast<uint32_t>(r) << 16) | (static_cast<uint32_t>(g) << 8) | b;
+    }
+
+    // Rounded value / 255 for value <= 255 * 255, without a divide
+    uint32_t DivideBy255(uint32_t value)
+    {
+        return (value + 128 + ((value + 128) >> 8)) >> 8;
+    }
+
+    // Premultiplied "over": color * coverage + dest * (1 - coverage)
+    uint32_t BlendPixel(uint32_t dest, uint32_t color, uint32_t coverage)
+    {
+        uint32_t inverse = 255 - coverage;
+        uint32_t r = DivideBy255(((color >> 16) & 0xFF) * coverage + ((dest >> 16) & 0xFF) * inverse);
+        uint32_t g = DivideBy255(((color >> 8) & 0xFF) * coverage + ((dest >> 8) & 0xFF) * inverse);
+        uint32_t b = DivideBy255((color & 0xFF) * coverage + (dest & 0xFF) * inverse);
+        return 0xFF000000u | (r << 16) | (g << 8) | b;
+    }
+}
+
+SoftwareRenderer::SoftwareRenderer()
+    : m_hwnd(nullptr)
+    , m_width(0)
+    , m_height(0)
+    , m_windowDC(nullptr)
+    , m_frames(m_presentFence)
+    , m_framesInFlight(2)
+    , m_target(&m_frames.Current())
+    , m_displayed(m_target)
+    , m_stopPresenting(false)
+    , m_resources(std::make_shared<ResourceManager>())
+    , m_fonts{ { L"arial24.spritefont", 24.0f }, { L"arial120.spritefont", 120.0f },
+               { L"arial120.digits.spritefont", 120.0f } }
+{
+}
+
+SoftwareRenderer::~SoftwareRenderer()
+{
+    OnDestroy();
+}
+
+void SoftwareRenderer::Initialize(HWND hwnd, UINT width, UINT height)
+{
+    m_hwnd = hwnd;
+    m_width = width;
+    m_height = height;
+
+    // Headless there is nothing to overlap with, so one framebuffer is enough
+    m_frames.SetDepth(hwnd ? m_framesInFlight : 1);
+    m_target = &m_frames.Current();
+    m_displayed = m_target;
+    PrepareFrame(*m_target);
+
+    if (hwnd)
+    {
+        m_windowDC = GetDC(hwnd);
+        StartPresentThread();
+    }
+
+    // Requested on first use; already resident if another renderer on the same manager
+    // loaded them
+    for (FontSlot& slot : m_fonts)
+        slot = FontSlot{ slot.fileName, slot.size };
+}
+
+void SoftwareRenderer::SetResources(std::shared_ptr<ResourceManager> resources)
+{
+    if (resources)
+        m_resources = std::move(resources);
+}
+
+void SoftwareRenderer::BeginFrame()
+{
+    // Waits if this framebuffer is still queued for present. Each frame in flight has its
+    // own framebuffer, so a frame that does not Clear starts from the one `depth` frames back.
+    m_target = &m_frames.BeginFrame();
+    PrepareFrame(*m_target);
+
+    if (m_outlineCache)
+        m_outlineCache->BeginFrame();
+    for (FontSlot& slot : m_fonts)
+    {
+        if (slot.scaled)
+            slot.scaled->BeginFrame();
+    }
+}
+
+void SoftwareRenderer::Clear(float r, float g, float b)
+{
+    // Vertical gradient from the color to a lighter version, like GDIRenderer
+    const int top[3] = { ToByte(r), ToByte(g), ToByte(b) };
+    const int bottom[3] = { ToByte(std::min(1.0f, r * 1.3f)), ToByte(std::min(1.0f, g * 1.3f)),
+                            ToByte(std::min(1.0f, b * 1.3f)) };
+    const int height = static_cast<int>(m_height);
+
+    for (int y = 0; y < height; y++)
+    {
+        uint8_t channel[3];
+        for (int c = 0; c < 3; c++)
+            channel[c] = static_cast<uint8_t>(top[c] + (bottom[c] - top[c]) * y / height);
+
+        uint32_t* row = m_target->pixels.data() + static_cast<size_t>(y) * m_width;
+        std::fill_n(row, m_width, PackColor(channel[0], channel[1], channel[2]));
+    }
+}
+
+void SoftwareRenderer::DrawText(const wchar_t* text, float x, float y, float fontSize,
+                                float r, float g, float b, bool bold)
+{
+    uint32_t color = PackColor(ToByte(r), ToByte(g), ToByte(b));
+    if (GlyphCache* cache = GetOutlineCache())
+    {
+        DrawOutlineText(*cache, text, x, y, fontSize, color);
+        return;
+    }
+
+    Font font = SelectFont(text, fontSize, true);
+    if (!font.atlas)
+        return;
+
+    // Same pen walk as SpriteFont::DrawString, snapped to whole pixels
+    float penX = 0.0f;
+    float penY = 0.0f;
+    for (; *text; text++)
+    {
+        wchar_t character = *text;
+        if (character == L'\r')
+            continue;
+
+        if (character == L'\n')
+        {
+            penX = 0.0f;
+            penY += font.glyphs->GetLineSpacing();
+            continue;
+        }
+
+        const SpriteFontGlyph* glyph = font.glyphs->FindGlyph(character);
+        if (!glyph)
+            continue;
+
+        penX += glyph->xOffset;
+        if (penX < 0.0f)
+            penX = 0.0f;
+
+        if (!font.scaled)
+        {
+            int destX = static_cast<int>(std::lround(x + penX));
+            int destY = static_cast<int>(std::lround(y + penY + glyph->yOffset));
+            BlitGlyph(font, *glyph, destX, destY, color);
+        }
+        else
+        {
+            // Pen positions scale about the origin, as SpriteFont::DrawString's scale does
+            const CachedGlyph& scaled = font.scaled->GetGlyph(font.glyphs->GetGlyphIndex(glyph), fontSize);
+            if (scaled.pixels)
+            {
+                int destX = static_cast<int>(std::lround(x + penX * font.scale)) + scaled.bitmap.left;
+                int destY = static_cast<int>(std::lround(y + (penY + glyph->yOffset) * font.scale)) - scaled.bitmap.top;
+                BlitCoverage(scaled, destX, destY, color);
+            }
+        }
+
+        penX += static_cast<float>(glyph->right - glyph->left) + glyph->xAdvance;
+    }
+}
+
+void SoftwareRenderer::MeasureText(const wchar_t* text, float fontSize,
+                                   float& outWidth, float& outHeight)
+{
+    // Advances only, so measuring never rasterizes
+    if (std::shared_ptr<const TrueTypeFont> outline = m_resources->GetOutlineFont())
+    {
+        outline->MeasureText(text, fontSize, outWidth, outHeight);
+        return;
+    }
+
+    Font font = SelectFont(text, fontSize, false);
+    if (!font.glyphs)
+    {
+        outWidth = 0.0f;
+        outHeight = 0.0f;
+        return;
+    }
+    font.glyphs->MeasureText(text, outWidth, outHeight);
+    outWidth *= font.scale;
+    outHeight *= font.scale;
+}
+
+void SoftwareRenderer::EndFrame()
+{
+    uint64_t fenceValue = m_frames.EndFrame();
+    m_displayed = m_target;
+
+    if (!m_presentThread.joinable())
+    {
+        m_presentFence.Signal(fenceValue);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_presentMutex);
+        m_presentQueue.push_back({ m_target, fenceValue });
+    }
+    m_presentReady.notify_one();
+}
+
+void SoftwareRenderer::Resize(UINT width, UINT height)
+{
+    // Queued presents read the old framebuffers
+    m_frames.WaitIdle();
+    m_width = width;
+    m_height = height;
+    PrepareFrame(*m_target);
+    m_displayed = m_target;
+}
+
+void SoftwareRenderer::SetFramesInFlight(UINT frames)
+{
+    m_framesInFlight = frames;
+    if (m_hwnd)
+        m_frames.SetDepth(frames);
+}
+
+void SoftwareRenderer::Suspend()
+{
+    // Framebuffers and fonts stay; only the window DC and the present thread go
+    StopPresentThread();
+
+    if (m_windowDC)
+    {
+        ReleaseDC(m_hwnd, m_windowDC);
+        m_windowDC = nullptr;
+    }
+}
+
+void SoftwareRenderer::Resume(UINT width, UINT height)
+{
+    if (m_hwnd && !m_presentThread.joinable())
+    {
+        m_windowDC = GetDC(m_hwnd);
+        StartPresentThread();
+    }
+    Resize(width, height);
+}
+
+void SoftwareRenderer::OnDestroy()
+{
+    Suspend();
+}
+
+void SoftwareRenderer::PrepareFrame(FrameContext& frame)
+{
+    const size_t size = static_cast<size_t>(m_width) * m_height;
+    if (frame.pixels.size() != size)
+        frame.pixels.assign(size, 0xFF000000u);
+}
+
+void SoftwareRenderer::StartPresentThread()
+{
+    m_stopPresenting = false;
+    m_presentThread = std::thread(&SoftwareRenderer::PresentLoop, this);
+}
+
+void SoftwareRenderer::StopPresentThread()
+{
+    if (!m_presentThread.joinable())
+        return;
+
+    // Queued frames are still presented so the fence reaches every value handed out
+    {
+        std::lock_guard<std::mutex> lock(m_presentMutex);
+        m_stopPresenting = true;
+    }
+    m_presentReady.notify_one();
+    m_presentThread.join();
+}
+
+void SoftwareRenderer::PresentLoop()
+{
+    BITMAPINFO bmi = {};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    for (;;)
+    {
+        PresentJob job;
+        {
+            std::unique_lock<std::mutex> lock(m_presentMutex);
+            m_presentReady.wait(lock, [this] { return m_stopPresenting || !m_presentQueue.empty(); });
+            if (m_presentQueue.empty())
+                return;
+            job = m_presentQueue.front();
+            m_presentQueue.pop_front();
+        }
+
+        // Resize waits for the queue to drain, so the size cannot change under a present
+        bmi.bmiHeader.biWidth = static_cast<LONG>(m_width);
+        bmi.bmiHeader.biHeight = -static_cast<LONG>(m_height); // Top-down
+        SetDIBitsToDevice(m_windowDC, 0, 0, m_width, m_height, 0, 0, 0, m_height,
+                          job.frame->pixels.data(), &bmi, DIB_RGB_COLORS);
+
+        m_presentFence.Signal(job.fenceValue);
+    }
+}
+
+const wchar_t* SoftwareRenderer::GetSpriteFontName(const wchar_t* text, float fontSize, float& outScale) const
+{
+    outScale = 1.0f;
+    if (m_resources->GetOutlineFont())
+        return nullptr;
+
+    const FontSlot& slot = m_fonts[GetFontIndex(text, fontSize)];
+    outScale = fontSize / slot.size;
+    return slot.fileName;
+}
+
+GlyphCacheStats SoftwareRenderer::GetGlyphCacheStats() const
+{
+    if (m_outlineCache && m_resources->GetOutlineFont())
+        return m_outlineCache->GetStats();
+
+    GlyphCacheStats total;
+    for (const FontSlot& slot : m_fonts)
+    {
+        if (!slot.scaled)
+            continue;
+        GlyphCacheStats stats = slot.scaled->GetStats();
+        total.hits += stats.hits;
+        total.misses += stats.misses;
+        total.uncached += stats.uncached;
+        total.evictedPages += stats.evictedPages;
+        total.evictedGlyphs += stats.evictedGlyphs;
+        total.renderedPixels += stats.renderedPixels;
+        total.renderMs += stats.renderMs;
+        total.residentGlyphs += stats.residentGlyphs;
+        total.pages += stats.pages;
+    }
+    return total;
+}
+
+GlyphCache* SoftwareRenderer::GetOutlineCache()
+{
+    std::shared_ptr<const TrueTypeFont> font = m_resources->GetOutlineFont();
+    if (!font)
+        return nullptr;
+
+    // A new outline font starts a new cache
+    if (!m_outlineCache || m_outlineFont != font)
+    {
+        m_outlineFont = font;
+        m_outlineCache = std::make_unique<GlyphCache>(std::make_unique<OutlineGlyphSource>(std::move(font)));
+    }
+    return m_outlineCache.get();
+}
+
+void SoftwareRenderer::DrawOutlineText(GlyphCache& cache, const wchar_t* text, float x, float y,
+                                       float fontSize, uint32_t color)
+{
+    // Lines are a cell apart, with the baseline an ascent below the top, as GDI lays out
+    const TrueTypeFont& font = *m_outlineFont;
+    float scale = font.GetScale(fontSize);
+    long baseline = std::lround(y + font.GetAscent() * scale);
+    float penX = 0.0f;
+    for (; *text; text++)
+    {
+        wchar_t character = *text;
+        if (character == L'\r')
+            continue;
+
+        if (character == L'\n')
+        {
+            penX = 0.0f;
+            baseline += std::lround(fontSize);
+            continue;
+        }
+
+        const CachedGlyph& glyph = cache.GetGlyph(font.FindGlyph(character), fontSize);
+        if (glyph.pixels)
+        {
+            int destX = static_cast<int>(std::lround(x + penX)) + glyph.bitmap.left;
+            int destY = static_cast<int>(baseline) - glyph.bitmap.top;
+            BlitCoverage(glyph, destX, destY, color);
+        }
+        penX += glyph.advance;
+    }
+}
+
+int SoftwareRenderer::GetFontIndex(const wchar_t* text, float fontSize) const
+{
+    if (fontSize <= LARGE_FONT_MIN_SIZE)
+        return SMALL_FONT;
+
+    bool digitsOnly = *text && text[wcsspn(text, L"0123456789")] == L'\0';
+    return digitsOnly && !m_fonts[DIGITS_FONT].failed ? DIGITS_FONT : LARGE_FONT;
+}
+
+SoftwareRenderer::Font SoftwareRenderer::SelectFont(const wchar_t* text, float fontSize, bool forDraw)
+{
+    FontSlot* bucket = &m_fonts[GetFontIndex(text, fontSize)];
+    RequestFont(*bucket, forDraw);
+    if (bucket->failed)
+    {
+        // Headless, the digits cut fails inside RequestFont; pick the full font right away
+        bucket = &m_fonts[GetFontIndex(text, fontSize)];
+        RequestFont(*bucket, forDraw);
+    }
+    FontSlot& slot = *bucket;
+
+    bool needsAtlas = forDraw || slot.coverageRequest.valid();
+    for (FontSlot* candidate : { &slot, &m_fonts[SMALL_FONT] })
+    {
+        PollFont(*candidate);
+        if (needsAtlas ? !candidate->atlas : !candidate->font)
+            continue;
+
+        Font font = { &m_resources->GetFont(candidate->font).glyphs,
+                      needsAtlas ? &m_resources->GetAtlas(candidate->atlas) : nullptr,
+                      nullptr, fontSize / candidate->size };
+        if (forDraw && font.scale != 1.0f)
+        {
+            if (!candidate->scaled)
+            {
+                candidate->scaled = std::make_unique<GlyphCache>(
+                    std::make_unique<SpriteGlyphSource>(*font.glyphs, *font.atlas, candidate->size));
+            }
+            font.scaled = candidate->scaled.get();
+        }
+        return font;
+    }
+    return Font{ nullptr, nullptr, nullptr, 1.0f };
+}
+
+void SoftwareRenderer::RequestFont(FontSlot& slot, bool forDraw)
+{
+    std::shared_future<FontHandle>& request = forDraw ? slot.coverageRequest : slot.metricsRequest;
+    if (request.valid())
+        return;
+
+    request = m_resources->RequestFont(slot.fileName, forDraw ? FontPart::Coverage : FontPart::Metrics);
+    if (m_hwnd)
+        return;
+
+    try
+    {
+        request.get();
+    }
+    catch (const std::exception& e)
+    {
+        // The digits cut is an optimization; without it the full font draws the number
+        if (&slot == &m_fonts[DIGITS_FONT])
+        {
+            Logger::LogWarning(std::string("SoftwareRenderer failed to load a sprite font: ") + e.what());
+            slot.failed = true;
+            return;
+        }
+        Logger::LogError(std::string("SoftwareRenderer failed to load a sprite font: ") + e.what());
+        throw;
+    }
+}
+
+void SoftwareRenderer::PollFont(FontSlot& slot)
+{
+    if (slot.failed || (slot.font && (slot.atlas || !slot.coverageRequest.valid())))
+        return;
+
+    // A draw request also brings in the metrics
+    if (!slot.font)
+        slot.font = m_resources->FindFont(slot.fileName);
+    if (slot.font && slot.coverageRequest.valid())
+        slot.atlas = m_resources->FindCoverageAtlas(slot.font);
+
+    // A failed bucket stays on its fallback
+    auto checkFailed = [&](const std::shared_future<FontHandle>& request, bool resident)
+    {
+        if (resident || !request.valid() || request.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return;
+        try
+        {
+            request.get();
+        }
+        catch (const std::exception& e)
+        {
+            Logger::LogWarning(std::string("SoftwareRenderer failed to load a sprite font: ") + e.what());
+            slot.failed = true;
+        }
+    };
+    checkFailed(slot.metricsRequest, static_cast<bool>(slot.font));
+    checkFailed(slot.coverageRequest, static_cast<bool>(slot.atlas));
+}
+
+void SoftwareRenderer::BlitGlyph(const Font& font, const SpriteFontGlyph& glyph,
+                                 int destX, int destY, uint32_t color)
+{
+    // Clip the glyph's atlas subrect against the framebuffer
+    int srcLeft = glyph.left;
+    int srcTop = glyph.top;
+    int width = glyph.right - glyph.left;
+    int height = glyph.bottom - glyph.top;
+
+    if (destX < 0)
+    {
+        srcLeft -= destX;
+        width += destX;
+        destX = 0;
+    }
+    if (destY < 0)
+    {
+        srcTop -= destY;
+        height += destY;
+        destY = 0;
+    }
+    width = std::min(width, static_cast<int>(m_width) - destX);
+    height = std::min(height, static_cast<int>(m_height) - destY);
+    if (width <= 0 || height <= 0)
+        return;
+
+    // Sampled in the atlas encoding; empty spans are skipped without touching the target
+    for (int row = 0; row < height; row++)
+    {
+        uint32_t* dest = m_target->pixels.data() + static_cast<size_t>(destY + row) * m_width + destX;
+        font.atlas->ForEachCovered(srcTop + row, srcLeft, srcLeft + width, [&](uint32_t x, uint32_t alpha)
+        {
+            uint32_t& pixel = dest[x - srcLeft];
+            pixel = (alpha == 255) ? color : BlendPixel(pixel, color, alpha);
+        });
+    }
+}
+
+void SoftwareRenderer::BlitCoverage(const CachedGlyph& glyph, int destX, int destY, uint32_t color)
+{
+    int srcLeft = 0;
+    int srcTop = 0;
+    int width = static_cast<int>(glyph.bitmap.width);
+    int height = static_cast<int>(glyph.bitmap.height);
+
+    if (destX < 0)
+    {
+        srcLeft -= destX;
+        width += destX;
+        destX = 0;
+    }
+    if (destY < 0)
+    {
+        srcTop -= destY;
+        height += destY;
+        destY = 0;
+    }
+    width = std::min(width, static_cast<int>(m_width) - destX);
+    height = std::min(height, static_cast<int>(m_height) - destY);
+    if (width <= 0 || height <= 0)
+        return;
+
+    for (int row = 0; row < height; row++)
+    {
+        const uint8_t* source = glyph.pixels + static_cast<size_t>(srcTop + row) * glyph.stride + srcLeft;
+        uint32_t* dest = m_target->pixels.data() + static_cast<size_t>(destY + row) * m_width + destX;
+        for (int x = 0; x < width; x++)
+        {
+            if (uint32_t alpha = source[x])
+                dest[x] = (alpha == 255) ? color : BlendPixel(dest[x], color, alpha);
+        }
+    }
+}
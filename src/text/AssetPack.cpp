@@ -0,0 +1,271 @@
+#include "AssetPack.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+using namespace AssetPackFormat;
+
+AssetPack::AssetPack()
+    : m_file(INVALID_HANDLE_VALUE)
+    , m_mapping(nullptr)
+    , m_data(nullptr)
+    , m_size(0)
+    , m_header(nullptr)
+{
+}
+
+AssetPack::~AssetPack()
+{
+    Close();
+}
+
+void AssetPack::Open(const std::wstring& fileName)
+{
+    Close();
+
+    m_file = CreateFileW(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                         OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Failed to open asset pack");
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(m_file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(FileHeader)))
+    {
+        Close();
+        throw std::runtime_error("Asset pack is too small");
+    }
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+
+    m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mapping)
+    {
+        Close();
+        throw std::runtime_error("Failed to map asset pack");
+    }
+
+    m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_data)
+    {
+        Close();
+        throw std::runtime_error("Failed to map asset pack view");
+    }
+
+    // Everything Find and GetAsset rely on is checked here, once. Offsets come from the
+    // file, so tables are measured against what is left after them rather than added to
+    // them, which could wrap.
+    auto fits = [this](uint64_t offset, uint64_t bytes) { return offset <= m_size && bytes <= m_size - offset; };
+    const FileHeader* header = reinterpret_cast<const FileHeader*>(m_data);
+    uint64_t bucketCount = header->bucketBits <= 31 ? (1ull << header->bucketBits) : 0;
+    bool valid = std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0 && header->version == VERSION &&
+                 header->headerSize == sizeof(FileHeader) && header->fileSize == m_size && bucketCount &&
+                 header->bucketsOffset % sizeof(uint32_t) == 0 && header->entriesOffset % sizeof(uint64_t) == 0 &&
+                 fits(header->bucketsOffset, (bucketCount + 1) * sizeof(uint32_t)) &&
+                 fits(header->entriesOffset, static_cast<uint64_t>(header->entryCount) * sizeof(Entry)) &&
+                 header->namesOffset % sizeof(char16_t) == 0 && header->namesOffset <= m_size;
+
+    if (valid)
+    {
+        m_header = header;
+        const uint32_t* buckets = reinterpret_cast<const uint32_t*>(m_data + header->bucketsOffset);
+        for (uint64_t bucket = 0; bucket < bucketCount && valid; bucket++)
+            valid = buckets[bucket] <= buckets[bucket + 1];
+        valid = valid && buckets[bucketCount] == header->entryCount;
+
+        const Entry* entries = GetEntries();
+        for (uint32_t i = 0; i < header->entryCount && valid; i++)
+        {
+            const Entry& entry = entries[i];
+            uint64_t nameBytes = (static_cast<uint64_t>(entry.nameOffset) + entry.nameLength + 1) * sizeof(char16_t);
+            uint32_t bucket = GetBucket(entry.hash, header->bucketBits);
+            valid = entry.offset % PAYLOAD_ALIGNMENT == 0 && fits(entry.offset, entry.size) &&
+                    fits(header->namesOffset, nameBytes) && GetNameData(i)[entry.nameLength] == u'\0' &&
+                    i >= buckets[bucket] && i < buckets[bucket + 1] && (i == 0 || entries[i - 1].hash <= entry.hash);
+        }
+    }
+
+    if (!valid)
+    {
+        Close();
+        throw std::runtime_error("Not a supported asset pack");
+    }
+}
+
+void AssetPack::Close()
+{
+    if (m_data)
+    {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+
+    if (m_mapping)
+    {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+
+    m_size = 0;
+    m_header = nullptr;
+}
+
+AssetView AssetPack::Find(const wchar_t* name) const
+{
+    if (!m_header)
+        return AssetView();
+
+    size_t length = wcslen(name);
+    uint64_t hash = HashName(name, length);
+    uint32_t bucket = GetBucket(hash, m_header->bucketBits);
+    const uint32_t* buckets = reinterpret_cast<const uint32_t*>(m_data + m_header->bucketsOffset);
+
+    const Entry* entries = GetEntries();
+    for (uint32_t i = buckets[bucket]; i < buckets[bucket + 1] && entries[i].hash <= hash; i++)
+    {
+        if (entries[i].hash == hash && entries[i].nameLength == length &&
+            std::equal(name, name + length, GetNameData(i),
+                       [](wchar_t a, char16_t b) { return static_cast<char16_t>(a) == b; }))
+            return GetAsset(i);
+    }
+    return AssetView();
+}
+
+std::wstring AssetPack::GetName(size_t index) const
+{
+    const char16_t* name = GetNameData(index);
+    return std::wstring(name, name + GetEntries()[index].nameLength);
+}
+
+AssetView AssetPack::GetAsset(size_t index) const
+{
+    const Entry& entry = GetEntries()[index];
+    AssetView view;
+    view.data = m_data + entry.offset;
+    view.size = static_cast<size_t>(entry.size);
+    return view;
+}
+
+const Entry* AssetPack::GetEntries() const
+{
+    return reinterpret_cast<const Entry*>(m_data + m_header->entriesOffset);
+}
+
+const char16_t* AssetPack::GetNameData(size_t index) const
+{
+    const char16_t* names = reinterpret_cast<const char16_t*>(m_data + m_header->namesOffset);
+    return names + GetEntries()[index].nameOffset;
+}
+
+void AssetPackWriter::Add(const std::wstring& name, std::vector<uint8_t> data)
+{
+    for (const Asset& asset : m_assets)
+    {
+        if (asset.name == name)
+            throw std::runtime_error("Duplicate asset name in pack");
+    }
+    m_assets.push_back(Asset{ name, std::move(data) });
+}
+
+void AssetPackWriter::AddFile(const std::wstring& path)
+{
+    std::filesystem::path filePath(path);
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+    if (!file)
+        throw std::runtime_error("Failed to open asset file " + filePath.string());
+
+    std::vector<uint8_t> data(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(data.data()), data.size()))
+        throw std::runtime_error("Failed to read asset file " + filePath.string());
+
+    Add(filePath.filename().wstring(), std::move(data));
+}
+
+void AssetPackWriter::Write(const std::wstring& fileName) const
+{
+    // Enough buckets for about one entry each
+    uint32_t bucketBits = 0;
+    while ((1ull << bucketBits) < m_assets.size())
+        bucketBits++;
+    uint32_t bucketCount = 1u << bucketBits;
+
+    std::vector<const Asset*> sorted;
+    for (const Asset& asset : m_assets)
+        sorted.push_back(&asset);
+    std::sort(sorted.begin(), sorted.end(), [](const Asset* a, const Asset* b)
+    {
+        uint64_t hashA = HashName(a->name.c_str(), a->name.size());
+        uint64_t hashB = HashName(b->name.c_str(), b->name.size());
+        return hashA != hashB ? hashA < hashB : a->name < b->name;
+    });
+
+    FileHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.headerSize = sizeof(FileHeader);
+    header.entryCount = static_cast<uint32_t>(sorted.size());
+    header.bucketBits = bucketBits;
+    header.bucketsOffset = sizeof(FileHeader);
+    header.entriesOffset = (header.bucketsOffset + (bucketCount + 1) * sizeof(uint32_t) + 7) & ~7ull;
+    header.namesOffset = header.entriesOffset + sorted.size() * sizeof(Entry);
+
+    std::vector<uint32_t> buckets(bucketCount + 1, 0);
+    std::vector<Entry> entries(sorted.size());
+    std::vector<char16_t> names;
+    for (size_t i = 0; i < sorted.size(); i++)
+    {
+        Entry& entry = entries[i];
+        entry.hash = HashName(sorted[i]->name.c_str(), sorted[i]->name.size());
+        entry.size = sorted[i]->data.size();
+        entry.nameOffset = static_cast<uint32_t>(names.size());
+        entry.nameLength = static_cast<uint32_t>(sorted[i]->name.size());
+        names.insert(names.end(), sorted[i]->name.begin(), sorted[i]->name.end());
+        names.push_back(u'\0');
+        buckets[GetBucket(entry.hash, bucketBits) + 1]++;
+    }
+    for (uint32_t bucket = 0; bucket < bucketCount; bucket++)
+        buckets[bucket + 1] += buckets[bucket];
+
+    uint64_t offset = header.namesOffset + names.size() * sizeof(char16_t);
+    for (Entry& entry : entries)
+    {
+        entry.offset = AlignPayloadOffset(offset);
+        offset = entry.offset + entry.size;
+    }
+    header.fileSize = offset;
+
+    std::filesystem::path filePath(fileName);
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file)
+        throw std::runtime_error("Failed to create asset pack " + filePath.string());
+
+    auto writeAt = [&](uint64_t position, const void* data, size_t size)
+    {
+        // Gaps up to the position are zero padding
+        static const char zeros[PAYLOAD_ALIGNMENT] = {};
+        for (uint64_t at = static_cast<uint64_t>(file.tellp()); at < position; )
+        {
+            size_t count = static_cast<size_t>(std::min<uint64_t>(position - at, sizeof(zeros)));
+            file.write(zeros, count);
+            at += count;
+        }
+        file.write(static_cast<const char*>(data), size);
+    };
+
+    writeAt(0, &header, sizeof(header));
+    writeAt(header.bucketsOffset, buckets.data(), buckets.size() * sizeof(uint32_t));
+    writeAt(header.entriesOffset, entries.data(), entries.size() * sizeof(Entry));
+    writeAt(header.namesOffset, names.data(), names.size() * sizeof(char16_t));
+    for (size_t i = 0; i < sorted.size(); i++)
+        writeAt(entries[i].offset, sorted[i]->data.data(), sorted[i]->data.size());
+
+    if (!file.flush())
+        throw std::runtime_error("Failed to write asset pack " + filePath.string());
+}
@@ -0,0 +1,203 @@
+#include "CoverageAtlas.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    // DXGI_FORMAT values used by MakeSpriteFont
+    const uint32_t FORMAT_R8G8B8A8_UNORM = 28;
+    const uint32_t FORMAT_BC2_UNORM = 74;
+    const uint32_t FORMAT_B8G8R8A8_UNORM = 87;
+    const uint32_t FORMAT_B4G4R4A4_UNORM = 115;
+
+    // A gap shorter than this many bytes of pixels is cheaper to store than a new run
+    const size_t RUN_COST = sizeof(CoverageAtlas::Run);
+
+    void DecodeBC2(const SpriteFontData& font, CoverageAtlas& atlas)
+    {
+        // Each 4x4 block is 64 bits of explicit 4-bit alpha followed by BC1 color.
+        // Only the alpha half carries coverage.
+        const uint32_t blocksWide = (font.textureWidth + 3) / 4;
+        const uint32_t blocksHigh = (font.textureHeight + 3) / 4;
+        if (font.textureStride < blocksWide * 16 || font.textureRows < blocksHigh)
+            throw std::runtime_error("BC2 sprite font texture is truncated");
+
+        for (uint32_t by = 0; by < blocksHigh; by++)
+        {
+            const uint8_t* block = font.GetTextureData() + static_cast<size_t>(by) * font.textureStride;
+            for (uint32_t bx = 0; bx < blocksWide; bx++, block += 16)
+            {
+                for (uint32_t row = 0; row < 4; row++)
+                {
+                    uint32_t y = by * 4 + row;
+                    if (y >= atlas.height)
+                        break;
+
+                    uint16_t bits = static_cast<uint16_t>(block[row * 2] | (block[row * 2 + 1] << 8));
+                    uint8_t* dest = atlas.data.data() + static_cast<size_t>(y) * atlas.width + bx * 4;
+                    for (uint32_t col = 0; col < 4 && bx * 4 + col < atlas.width; col++)
+                        dest[col] = static_cast<uint8_t>(((bits >> (col * 4)) & 0xF) * 17);
+                }
+            }
+        }
+    }
+
+    void DecodeUncompressed(const SpriteFontData& font, CoverageAtlas& atlas,
+                            uint32_t bytesPerPixel, uint32_t alphaByte)
+    {
+        if (font.textureStride < font.textureWidth * bytesPerPixel || font.textureRows < font.textureHeight)
+            throw std::runtime_error("Sprite font texture is truncated");
+
+        for (uint32_t y = 0; y < atlas.height; y++)
+        {
+            const uint8_t* source = font.GetTextureData() + static_cast<size_t>(y) * font.textureStride;
+            uint8_t* dest = atlas.data.data() + static_cast<size_t>(y) * atlas.width;
+            for (uint32_t x = 0; x < atlas.width; x++)
+                dest[x] = source[x * bytesPerPixel + alphaByte];
+        }
+    }
+
+    void DecodeB4G4R4A4(const SpriteFontData& font, CoverageAtlas& atlas)
+    {
+        if (font.textureStride < font.textureWidth * 2 || font.textureRows < font.textureHeight)
+            throw std::runtime_error("Sprite font texture is truncated");
+
+        for (uint32_t y = 0; y < atlas.height; y++)
+        {
+            const uint8_t* source = font.GetTextureData() + static_cast<size_t>(y) * font.textureStride;
+            uint8_t* dest = atlas.data.data() + static_cast<size_t>(y) * atlas.width;
+            for (uint32_t x = 0; x < atlas.width; x++)
+                dest[x] = static_cast<uint8_t>((source[x * 2 + 1] >> 4) * 17);
+        }
+    }
+
+    // One run per row over the whole width
+    void SetDenseRuns(CoverageAtlas& atlas)
+    {
+        atlas.rowRuns.resize(atlas.height + 1);
+        atlas.runs.resize(atlas.height);
+        for (uint32_t y = 0; y < atlas.height; y++)
+        {
+            atlas.rowRuns[y] = y;
+            atlas.runs[y] = { 0, static_cast<uint16_t>(atlas.width), y * atlas.width };
+        }
+        atlas.rowRuns[atlas.height] = atlas.height;
+    }
+
+    // First covered pixel of row[x, width), or width; eight empty pixels at a time
+    uint32_t SkipEmpty(const uint8_t* row, uint32_t x, uint32_t width)
+    {
+        for (; x + 8 <= width; x += 8)
+        {
+            uint64_t pixels;
+            std::memcpy(&pixels, row + x, sizeof(pixels));
+            if (pixels)
+                break;
+        }
+        while (x < width && row[x] == 0)
+            x++;
+        return x;
+    }
+
+    // Drop the empty spans of a dense atlas, storing 4-bit levels (expanded to 8 bits as
+    // v * 17) at half the size
+    CoverageAtlas Compact(const CoverageAtlas& dense, bool fourBit)
+    {
+        CoverageAtlas atlas;
+        atlas.width = dense.width;
+        atlas.height = dense.height;
+        atlas.bitsPerPixel = fourBit ? 4 : 8;
+        atlas.rowRuns.reserve(dense.height + 1);
+
+        const uint32_t maxGap = static_cast<uint32_t>(RUN_COST * 8 / atlas.bitsPerPixel);
+        std::vector<uint8_t> values;    // One byte per stored pixel
+        uint32_t stored = 0;
+        for (uint32_t y = 0; y < dense.height; y++)
+        {
+            atlas.rowRuns.push_back(static_cast<uint32_t>(atlas.runs.size()));
+            const uint8_t* row = dense.data.data() + static_cast<size_t>(y) * dense.width;
+
+            for (uint32_t x = SkipEmpty(row, 0, dense.width); x < dense.width; )
+            {
+                // Extend over covered pixels and over gaps too short to be worth a new run
+                uint32_t end = x + 1;
+                for (uint32_t probe = end; probe < dense.width && probe - end <= maxGap; probe++)
+                    end = row[probe] ? probe + 1 : end;
+
+                atlas.runs.push_back({ static_cast<uint16_t>(x), static_cast<uint16_t>(end - x), stored });
+                values.insert(values.end(), row + x, row + end);
+                stored += end - x;
+                x = SkipEmpty(row, end, dense.width);
+            }
+        }
+        atlas.rowRuns.push_back(static_cast<uint32_t>(atlas.runs.size()));
+
+        if (fourBit)
+        {
+            values.push_back(0);
+            atlas.data.resize(values.size() / 2);
+            for (size_t i = 0; i < atlas.data.size(); i++)
+                atlas.data[i] = static_cast<uint8_t>(values[i * 2] / 17 | (values[i * 2 + 1] / 17) << 4);
+        }
+        else
+        {
+            atlas.data = std::move(values);
+            atlas.data.shrink_to_fit();
+        }
+
+        atlas.runs.shrink_to_fit();
+        return atlas;
+    }
+}
+
+uint8_t CoverageAtlas::Sample(uint32_t x, uint32_t y) const
+{
+    uint8_t value = 0;
+    ForEachCovered(y, x, x + 1, [&](uint32_t, uint32_t alpha) { value = static_cast<uint8_t>(alpha); });
+    return value;
+}
+
+size_t CoverageAtlas::GetByteSize() const
+{
+    return data.size() + runs.size() * sizeof(Run) + rowRuns.size() * sizeof(uint32_t);
+}
+
+CoverageAtlas CoverageAtlas::FromSpriteFont(const SpriteFontData& font, CoverageEncoding encoding)
+{
+    if (font.GetTextureSize() == 0)
+        throw std::runtime_error("Sprite font was loaded without its texture");
+    if (font.textureWidth > UINT16_MAX)
+        throw std::runtime_error("Sprite font texture is too wide");
+
+    CoverageAtlas atlas;
+    atlas.width = font.textureWidth;
+    atlas.height = font.textureHeight;
+    atlas.data.assign(static_cast<size_t>(atlas.width) * atlas.height, 0);
+
+    switch (font.textureFormat)
+    {
+    case FORMAT_BC2_UNORM:
+        DecodeBC2(font, atlas);
+        break;
+
+    case FORMAT_R8G8B8A8_UNORM:
+    case FORMAT_B8G8R8A8_UNORM:
+        DecodeUncompressed(font, atlas, 4, 3);
+        break;
+
+    case FORMAT_B4G4R4A4_UNORM:
+        DecodeB4G4R4A4(font, atlas);
+        break;
+
+    default:
+        throw std::runtime_error("Unsupported sprite font texture format");
+    }
+
+    // Both carry 4-bit alpha
+    if (encoding == CoverageEncoding::Compact)
+        return Compact(atlas, font.textureFormat == FORMAT_BC2_UNORM || font.textureFormat == FORMAT_B4G4R4A4_UNORM);
+
+    SetDenseRuns(atlas);
+    return atlas;
+}
@@ -0,0 +1,36 @@
+#include "EmbeddedFont.h"
+
+#ifdef GRAPHICS_ENGINE_EMBEDDED_FONTS
+#include "Embedded_arial24.h"
+#include "Embedded_arial120.h"
+#include "Embedded_arial120_digits.h"
+#endif
+
+SpriteFontData EmbeddedFont::ToSpriteFontData(bool loadTexture) const
+{
+    SpriteFontData font;
+    font.glyphs.assign(glyphs, glyphs + glyphCount);
+    font.lineSpacing = lineSpacing;
+    font.defaultCharacter = defaultCharacter;
+    font.textureWidth = textureWidth;
+    font.textureHeight = textureHeight;
+    font.textureFormat = textureFormat;
+    font.textureStride = textureStride;
+    font.textureRows = textureRows;
+
+    // Static data: nothing to copy and nothing to keep alive
+    if (loadTexture)
+        font.mappedTexture = texture;
+    return font;
+}
+
+std::span<const EmbeddedFont* const> GetEmbeddedFonts()
+{
+#ifdef GRAPHICS_ENGINE_EMBEDDED_FONTS
+    static const EmbeddedFont* const fonts[] = { &EmbeddedFonts::arial24, &EmbeddedFonts::arial120,
+                                                 &EmbeddedFonts::arial120_digits };
+    return fonts;
+#else
+    return {};
+#endif
+}
@@ -0,0 +1,175 @@
+#include "GlyphCache.h"
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Sizes in 1/64 pixel, so 12.0 and 12.01 share glyphs but 12 and 12.5 do not
+    uint64_t MakeKey(uint16_t glyph, float fontSize)
+    {
+        uint32_t size = static_cast<uint32_t>(std::lround(fontSize * 64.0f));
+        return (static_cast<uint64_t>(glyph) << 32) | size;
+    }
+}
+
+OutlineGlyphSource::OutlineGlyphSource(std::shared_ptr<const TrueTypeFont> font)
+    : m_font(std::move(font))
+{
+    if (!m_font)
+        throw std::runtime_error("OutlineGlyphSource needs a font");
+}
+
+GlyphBitmap OutlineGlyphSource::Measure(uint16_t glyph, float fontSize, float& outAdvance)
+{
+    float scale = m_font->GetScale(fontSize);
+    m_font->GetOutline(glyph, m_outline);
+    outAdvance = m_font->GetAdvance(glyph) * scale;
+    return GlyphRasterizer::Measure(m_outline, scale);
+}
+
+void OutlineGlyphSource::Render(uint16_t glyph, float fontSize, const GlyphBitmap& bitmap,
+                                uint8_t* output, size_t stride)
+{
+    (void)glyph;
+    m_rasterizer.Rasterize(m_outline, m_font->GetScale(fontSize), bitmap, output, stride);
+}
+
+GlyphCache::GlyphCache(std::unique_ptr<GlyphSource> source, uint32_t pageSize, uint32_t maxPages)
+    : m_source(std::move(source))
+    , m_pageSize(pageSize)
+    , m_maxPages(maxPages)
+    , m_frame(1)
+{
+    if (!m_source)
+        throw std::runtime_error("GlyphCache needs a glyph source");
+    if (pageSize == 0 || maxPages == 0)
+        throw std::runtime_error("GlyphCache needs at least one non-empty page");
+}
+
+const CachedGlyph& GlyphCache::GetGlyph(uint16_t glyph, float fontSize)
+{
+    uint64_t key = MakeKey(glyph, fontSize);
+    auto it = m_glyphs.find(key);
+    if (it != m_glyphs.end())
+    {
+        m_stats.hits++;
+        if (it->second.page != NO_PAGE)
+            m_pages[it->second.page].lastUse = m_frame;
+        return it->second;
+    }
+
+    // Rendered at the size the key stands for, so near-equal sizes share one bitmap
+    Clock::time_point start = Clock::now();
+    float size = static_cast<uint32_t>(key) / 64.0f;
+    CachedGlyph result;
+    result.bitmap = m_source->Measure(glyph, size, result.advance);
+    uint32_t width = result.bitmap.width;
+    uint32_t height = result.bitmap.height;
+
+    if (width > m_pageSize || height > m_pageSize)
+    {
+        // Bigger than a page: served from scratch, never cached
+        m_scratch.resize(static_cast<size_t>(width) * height);
+        m_source->Render(glyph, size, result.bitmap, m_scratch.data(), width);
+        result.pixels = m_scratch.data();
+        result.stride = width;
+        m_scratchGlyph = result;
+
+        m_stats.uncached++;
+        m_stats.renderedPixels += static_cast<uint64_t>(width) * height;
+        m_stats.renderMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        return m_scratchGlyph;
+    }
+
+    if (width && height)
+    {
+        uint32_t x, y;
+        uint32_t page = Allocate(width, height, x, y);
+        Page& target = m_pages[page];
+        uint8_t* pixels = target.pixels.data() + static_cast<size_t>(y) * m_pageSize + x;
+        m_source->Render(glyph, size, result.bitmap, pixels, m_pageSize);
+        result.pixels = pixels;
+        result.stride = m_pageSize;
+        result.page = page;
+        result.x = x;
+        result.y = y;
+        target.keys.push_back(key);
+        target.lastUse = m_frame;
+        target.version++;
+    }
+
+    m_stats.misses++;
+    m_stats.renderedPixels += static_cast<uint64_t>(width) * height;
+    m_stats.renderMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return m_glyphs.emplace(key, result).first->second;
+}
+
+uint32_t GlyphCache::Allocate(uint32_t width, uint32_t height, uint32_t& outX, uint32_t& outY)
+{
+    for (uint32_t i = 0; i < m_pages.size(); i++)
+    {
+        if (m_pages[i].packer.Insert(width, height, outX, outY))
+            return i;
+    }
+
+    if (m_pages.size() < m_maxPages)
+    {
+        Page page;
+        page.pixels.resize(static_cast<size_t>(m_pageSize) * m_pageSize);
+        page.packer.Reset(m_pageSize, m_pageSize);
+        m_pages.push_back(std::move(page));
+        m_pages.back().packer.Insert(width, height, outX, outY);
+        return static_cast<uint32_t>(m_pages.size() - 1);
+    }
+
+    uint32_t oldest = 0;
+    for (uint32_t i = 1; i < m_pages.size(); i++)
+    {
+        if (m_pages[i].lastUse < m_pages[oldest].lastUse)
+            oldest = i;
+    }
+    EvictPage(oldest);
+    m_pages[oldest].packer.Insert(width, height, outX, outY);
+    return oldest;
+}
+
+void GlyphCache::EvictPage(uint32_t page)
+{
+    if (m_evictionHandler)
+        m_evictionHandler(page);
+
+    Page& evicted = m_pages[page];
+    for (uint64_t key : evicted.keys)
+        m_glyphs.erase(key);
+
+    m_stats.evictedPages++;
+    m_stats.evictedGlyphs += evicted.keys.size();
+    evicted.keys.clear();
+    evicted.packer.Reset(m_pageSize, m_pageSize);
+}
+
+void GlyphCache::Clear()
+{
+    m_glyphs.clear();
+    for (Page& page : m_pages)
+    {
+        page.keys.clear();
+        page.packer.Reset(m_pageSize, m_pageSize);
+    }
+}
+
+GlyphCacheStats GlyphCache::GetStats() const
+{
+    GlyphCacheStats stats = m_stats;
+    stats.residentGlyphs = m_glyphs.size();
+    stats.pages = m_pages.size();
+    return stats;
+}
+
+void GlyphCache::ResetStats()
+{
+    m_stats = GlyphCacheStats();
+}
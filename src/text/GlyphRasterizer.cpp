@@ -0,0 +1,227 @@
+#include "GlyphRasterizer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Curves whose control point deviates less than this (squared, in pixels) are lines
+    const float FLAT_DEVIATION = 0.333f;
+
+    // Higher flattens into more segments; 3 keeps curves within about 1/10 pixel
+    const float FLATTEN_TOLERANCE = 3.0f;
+}
+
+GlyphBitmap GlyphRasterizer::Measure(const GlyphOutline& outline, float scale)
+{
+    GlyphBitmap bitmap;
+    if (outline.IsEmpty())
+        return bitmap;
+
+    int32_t left = static_cast<int32_t>(std::floor(outline.xMin * scale));
+    int32_t right = static_cast<int32_t>(std::ceil(outline.xMax * scale));
+    int32_t bottom = static_cast<int32_t>(std::floor(outline.yMin * scale));
+    int32_t top = static_cast<int32_t>(std::ceil(outline.yMax * scale));
+    if (right <= left || top <= bottom)
+        return bitmap;
+
+    bitmap.left = left;
+    bitmap.top = top;
+    bitmap.width = static_cast<uint32_t>(right - left);
+    bitmap.height = static_cast<uint32_t>(top - bottom);
+    return bitmap;
+}
+
+void GlyphRasterizer::Rasterize(const GlyphOutline& outline, float scale, const GlyphBitmap& bitmap,
+                                uint8_t* output, size_t stride)
+{
+    if (!bitmap.width || !bitmap.height)
+        return;
+
+    // Edges ending on the right border spill one cell into the next row, where the
+    // running sum expects them; the slack covers the last row
+    m_width = bitmap.width;
+    m_height = bitmap.height;
+    m_accumulation.assign(static_cast<size_t>(m_width) * m_height + 4, 0.0f);
+
+    // Font units (y up) to bitmap pixels (y down), clamped against rounding at the edges
+    auto toPixel = [&](const GlyphOutline::Point& point)
+    {
+        float x = point.x * scale - static_cast<float>(bitmap.left);
+        float y = static_cast<float>(bitmap.top) - point.y * scale;
+        return Point{ std::clamp(x, 0.0f, static_cast<float>(m_width)),
+                      std::clamp(y, 0.0f, static_cast<float>(m_height)) };
+    };
+    auto midpoint = [](Point a, Point b) { return Point{ (a.x + b.x) * 0.5f, (a.y + b.y) * 0.5f }; };
+
+    uint32_t begin = 0;
+    for (uint32_t end : outline.contourEnds)
+    {
+        uint32_t count = end - begin;
+        if (count < 2)
+        {
+            begin = end;
+            continue;
+        }
+
+        // Start on an on-curve point: the first, the last, or the one implied between them
+        const GlyphOutline::Point* points = outline.points.data() + begin;
+        Point start;
+        uint32_t first = 0, last = count;
+        if (points[0].onCurve)
+        {
+            start = toPixel(points[0]);
+            first = 1;
+        }
+        else if (points[count - 1].onCurve)
+        {
+            start = toPixel(points[count - 1]);
+            last = count - 1;
+        }
+        else
+        {
+            start = midpoint(toPixel(points[0]), toPixel(points[count - 1]));
+        }
+
+        // Two off-curve points in a row imply an on-curve point between them
+        Point current = start;
+        Point control = {};
+        bool hasControl = false;
+        for (uint32_t i = first; i < last; i++)
+        {
+            Point point = toPixel(points[i]);
+            if (points[i].onCurve)
+            {
+                if (hasControl)
+                    DrawQuadratic(current, control, point);
+                else
+                    DrawLine(current, point);
+                current = point;
+                hasControl = false;
+            }
+            else
+            {
+                if (hasControl)
+                {
+                    Point implied = midpoint(control, point);
+                    DrawQuadratic(current, control, implied);
+                    current = implied;
+                }
+                control = point;
+                hasControl = true;
+            }
+        }
+        if (hasControl)
+            DrawQuadratic(current, control, start);
+        else
+            DrawLine(current, start);
+
+        begin = end;
+    }
+
+    // The running sum of signed areas is the winding coverage; overlaps saturate
+    float sum = 0.0f;
+    const float* cell = m_accumulation.data();
+    for (uint32_t y = 0; y < m_height; y++)
+    {
+        uint8_t* row = output + y * stride;
+        for (uint32_t x = 0; x < m_width; x++)
+        {
+            sum += *cell++;
+            float coverage = std::min(std::fabs(sum), 1.0f);
+            row[x] = static_cast<uint8_t>(coverage * 255.0f + 0.5f);
+        }
+    }
+}
+
+void GlyphRasterizer::DrawLine(Point from, Point to)
+{
+    if (from.y == to.y)
+        return;
+
+    // Walk down the rows; upward edges subtract
+    float direction = 1.0f;
+    if (from.y > to.y)
+    {
+        std::swap(from, to);
+        direction = -1.0f;
+    }
+
+    float dxdy = (to.x - from.x) / (to.y - from.y);
+    float x = from.x;
+    uint32_t rowEnd = std::min(m_height, static_cast<uint32_t>(std::ceil(to.y)));
+    for (uint32_t y = static_cast<uint32_t>(from.y); y < rowEnd; y++)
+    {
+        float* row = m_accumulation.data() + static_cast<size_t>(y) * m_width;
+        float dy = std::min(static_cast<float>(y + 1), to.y) - std::max(static_cast<float>(y), from.y);
+        float xNext = x + dxdy * dy;
+        float area = dy * direction;
+
+        float x0 = std::min(x, xNext);
+        float x1 = std::max(x, xNext);
+        float x0Floor = std::floor(x0);
+        float x1Ceil = std::ceil(x1);
+        int32_t x0i = static_cast<int32_t>(x0Floor);
+        int32_t x1i = static_cast<int32_t>(x1Ceil);
+
+        if (x1i <= x0i + 1)
+        {
+            // Within one column: split by the crossing's mean position
+            float middle = 0.5f * (x + xNext) - x0Floor;
+            row[x0i] += area - area * middle;
+            row[x0i + 1] += area * middle;
+        }
+        else
+        {
+            // Across columns: a triangle, trapezoids, then a triangle
+            float inverse = 1.0f / (x1 - x0);
+            float x0f = x0 - x0Floor;
+            float firstArea = 0.5f * inverse * (1.0f - x0f) * (1.0f - x0f);
+            float x1f = x1 - x1Ceil + 1.0f;
+            float lastArea = 0.5f * inverse * x1f * x1f;
+
+            row[x0i] += area * firstArea;
+            if (x1i == x0i + 2)
+            {
+                row[x0i + 1] += area * (1.0f - firstArea - lastArea);
+            }
+            else
+            {
+                float secondArea = inverse * (1.5f - x0f);
+                row[x0i + 1] += area * (secondArea - firstArea);
+                for (int32_t column = x0i + 2; column < x1i - 1; column++)
+                    row[column] += area * inverse;
+                float covered = secondArea + static_cast<float>(x1i - x0i - 3) * inverse;
+                row[x1i - 1] += area * (1.0f - covered - lastArea);
+            }
+            row[x1i] += area * lastArea;
+        }
+        x = xNext;
+    }
+}
+
+void GlyphRasterizer::DrawQuadratic(Point from, Point control, Point to)
+{
+    float deviationX = from.x - 2.0f * control.x + to.x;
+    float deviationY = from.y - 2.0f * control.y + to.y;
+    float deviation = deviationX * deviationX + deviationY * deviationY;
+    if (deviation < FLAT_DEVIATION)
+    {
+        DrawLine(from, to);
+        return;
+    }
+
+    // Flattening error falls with the square of the segment count
+    uint32_t segments = 1 + static_cast<uint32_t>(std::floor(std::sqrt(std::sqrt(FLATTEN_TOLERANCE * deviation))));
+    float step = 1.0f / static_cast<float>(segments);
+    Point previous = from;
+    for (uint32_t i = 1; i < segments; i++)
+    {
+        float t = step * static_cast<float>(i);
+        float u = 1.0f - t;
+        Point next = { u * u * from.x + 2.0f * u * t * control.x + t * t * to.x,
+                       u * u * from.y + 2.0f * u * t * control.y + t * t * to.y };
+        DrawLine(previous, next);
+        previous = next;
+    }
+    DrawLine(previous, to);
+}
@@ -0,0 +1,194 @@
+#include "GlyphScaler.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define GLYPH_SCALER_USE_SSE2 1
+#endif
+
+namespace
+{
+    // Horizontal weights sum to 256, so a filtered row holds coverage * 256 (at most
+    // 65280). Vertical weights sum to 32768 and multiply through the high half of a 16-bit
+    // product, leaving coverage * 128.
+    const uint32_t COLUMN_ONE = 256;
+    const uint32_t ROW_ONE = 32768;
+    const uint32_t ROW_SHIFT = 7;
+
+    // Pixels of margin around the scaled subrect
+    const int32_t MARGIN = 1;
+}
+
+GlyphBitmap GlyphScaler::Measure(uint32_t width, uint32_t height, float scale)
+{
+    GlyphBitmap bitmap;
+    if (!width || !height)
+        return bitmap;
+
+    bitmap.left = -MARGIN;
+    bitmap.top = MARGIN;
+    bitmap.width = static_cast<uint32_t>(std::ceil(width * scale)) + 2 * MARGIN;
+    bitmap.height = static_cast<uint32_t>(std::ceil(height * scale)) + 2 * MARGIN;
+    return bitmap;
+}
+
+void GlyphScaler::BuildFilter(uint32_t sourceSize, float scale, uint32_t destinationSize,
+                              uint32_t one, Filter& filter)
+{
+    filter.first.clear();
+    filter.taps.clear();
+    filter.weights.clear();
+
+    // A tent one destination pixel wide, but never narrower than a source pixel
+    float radius = std::max(1.0f, 1.0f / scale);
+    std::vector<float> raw;
+    std::vector<uint32_t> quantized;
+    for (uint32_t i = 0; i < destinationSize; i++)
+    {
+        filter.first.push_back(static_cast<uint32_t>(filter.taps.size()));
+
+        // Destination pixel center in source pixel coordinates
+        float center = (static_cast<float>(static_cast<int32_t>(i) - MARGIN) + 0.5f) / scale - 0.5f;
+        int32_t begin = static_cast<int32_t>(std::floor(center - radius)) + 1;
+        int32_t end = static_cast<int32_t>(std::ceil(center + radius));
+
+        // Normalized over every tap, so pixels past the subrect's edges (transparent)
+        // still take their share and edges fade out
+        raw.clear();
+        float total = 0.0f;
+        for (int32_t tap = begin; tap < end; tap++)
+        {
+            float weight = std::max(0.0f, 1.0f - std::fabs(static_cast<float>(tap) - center) / radius);
+            raw.push_back(weight);
+            total += weight;
+        }
+        if (total <= 0.0f)
+            continue;
+
+        // Rounding error goes to the largest weight so the weights sum to exactly one
+        quantized.resize(raw.size());
+        uint32_t sum = 0;
+        size_t largest = 0;
+        for (size_t k = 0; k < raw.size(); k++)
+        {
+            quantized[k] = static_cast<uint32_t>(std::lround(raw[k] / total * static_cast<float>(one)));
+            sum += quantized[k];
+            if (raw[k] > raw[largest])
+                largest = k;
+        }
+        quantized[largest] = quantized[largest] + one - sum;
+
+        for (size_t k = 0; k < raw.size(); k++)
+        {
+            int32_t tap = begin + static_cast<int32_t>(k);
+            if (tap < 0 || tap >= static_cast<int32_t>(sourceSize) || !quantized[k])
+                continue;
+            filter.taps.push_back(static_cast<uint32_t>(tap));
+            filter.weights.push_back(static_cast<uint16_t>(quantized[k]));
+        }
+    }
+    filter.first.push_back(static_cast<uint32_t>(filter.taps.size()));
+}
+
+void GlyphScaler::Scale(const CoverageAtlas& atlas, uint32_t left, uint32_t top, uint32_t width, uint32_t height,
+                        float scale, const GlyphBitmap& bitmap, uint8_t* output, size_t stride)
+{
+    const uint32_t destWidth = bitmap.width;
+    const uint32_t destHeight = bitmap.height;
+    if (!destWidth || !destHeight)
+        return;
+    if (left + width > atlas.width || top + height > atlas.height)
+        throw std::runtime_error("Glyph subrect lies outside the coverage atlas");
+
+    BuildFilter(width, scale, destWidth, COLUMN_ONE, m_columns);
+    BuildFilter(height, scale, destHeight, ROW_ONE, m_rows);
+
+    // Horizontal pass: every source row, sampled in the atlas encoding, to destination width
+    m_sourceRow.resize(width);
+    m_filtered.assign(static_cast<size_t>(height) * destWidth, 0);
+    for (uint32_t y = 0; y < height; y++)
+    {
+        std::fill(m_sourceRow.begin(), m_sourceRow.end(), 0);
+        bool covered = false;
+        atlas.ForEachCovered(top + y, left, left + width, [&](uint32_t x, uint32_t alpha)
+        {
+            m_sourceRow[x - left] = static_cast<uint8_t>(alpha);
+            covered = true;
+        });
+        if (!covered)
+            continue;
+
+        uint16_t* filtered = m_filtered.data() + static_cast<size_t>(y) * destWidth;
+        for (uint32_t x = 0; x < destWidth; x++)
+        {
+            uint32_t sum = 0;
+            for (uint32_t k = m_columns.first[x]; k < m_columns.first[x + 1]; k++)
+                sum += m_columns.weights[k] * m_sourceRow[m_columns.taps[k]];
+            filtered[x] = static_cast<uint16_t>(sum);
+        }
+    }
+
+    // Vertical pass: each destination row is a weighted sum of whole filtered rows
+    for (uint32_t y = 0; y < destHeight; y++)
+    {
+        uint8_t* row = output + y * stride;
+        const uint32_t firstTap = m_rows.first[y];
+        const uint32_t lastTap = m_rows.first[y + 1];
+        uint32_t x = 0;
+
+#ifdef GLYPH_SCALER_USE_SSE2
+        const __m128i rounding = _mm_set1_epi16(1 << (ROW_SHIFT - 1));
+        for (; x + 8 <= destWidth; x += 8)
+        {
+            __m128i sum = _mm_setzero_si128();
+            for (uint32_t k = firstTap; k < lastTap; k++)
+            {
+                const uint16_t* source = m_filtered.data() + static_cast<size_t>(m_rows.taps[k]) * destWidth + x;
+                __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+                sum = _mm_add_epi16(sum, _mm_mulhi_epu16(value, _mm_set1_epi16(static_cast<short>(m_rows.weights[k]))));
+            }
+            __m128i coverage = _mm_srli_epi16(_mm_add_epi16(sum, rounding), ROW_SHIFT);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(row + x), _mm_packus_epi16(coverage, coverage));
+        }
+#endif
+
+        // Same arithmetic as the SIMD loop, so results do not depend on the width
+        for (; x < destWidth; x++)
+        {
+            uint32_t sum = 0;
+            for (uint32_t k = firstTap; k < lastTap; k++)
+            {
+                uint32_t value = m_filtered[static_cast<size_t>(m_rows.taps[k]) * destWidth + x];
+                sum += (value * m_rows.weights[k]) >> 16;
+            }
+            row[x] = static_cast<uint8_t>(std::min<uint32_t>(255, (sum + (1 << (ROW_SHIFT - 1))) >> ROW_SHIFT));
+        }
+    }
+}
+
+SpriteGlyphSource::SpriteGlyphSource(const GlyphTable& glyphs, const CoverageAtlas& atlas, float fontSize)
+    : m_glyphs(glyphs)
+    , m_atlas(atlas)
+    , m_fontSize(fontSize)
+{
+}
+
+GlyphBitmap SpriteGlyphSource::Measure(uint16_t glyph, float fontSize, float& outAdvance)
+{
+    const SpriteFontGlyph& record = m_glyphs.GetGlyph(glyph);
+    float scale = fontSize / m_fontSize;
+    uint32_t width = static_cast<uint32_t>(record.right - record.left);
+    uint32_t height = static_cast<uint32_t>(record.bottom - record.top);
+    outAdvance = (record.xOffset + static_cast<float>(width) + record.xAdvance) * scale;
+    return GlyphScaler::Measure(width, height, scale);
+}
+
+void SpriteGlyphSource::Render(uint16_t glyph, float fontSize, const GlyphBitmap& bitmap,
+                               uint8_t* output, size_t stride)
+{
+    const SpriteFontGlyph& record = m_glyphs.GetGlyph(glyph);
+    m_scaler.Scale(m_atlas, record.left, record.top, record.right - record.left, record.bottom - record.top,
+                   fontSize / m_fontSize, bitmap, output, stride);
+}
@@ -0,0 +1,218 @@
+#include "GlyphTable.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cwctype>
+#include <stdexcept>
+
+namespace
+{
+    bool IsIntegral(float value)
+    {
+        return std::floor(value) == value && value >= -32768.0f && value <= 32767.0f;
+    }
+
+    bool FitsInt16(float value)
+    {
+        return value >= -32768.0f && value <= 32767.0f;
+    }
+}
+
+GlyphTable::GlyphTable()
+    : m_pageDirectory()
+    , m_defaultIndex(0)
+    , m_lineSpacing(0.0f)
+    , m_usePacked(false)
+{
+    Build(nullptr, 0, 0.0f, 0);
+}
+
+GlyphTable::GlyphTable(const SpriteFontData& font)
+    : GlyphTable()
+{
+    Build(font.glyphs.data(), font.glyphs.size(), font.lineSpacing, font.defaultCharacter);
+}
+
+void GlyphTable::Build(const SpriteFontGlyph* glyphs, size_t glyphCount,
+                       float lineSpacing, uint32_t defaultCharacter)
+{
+    // Index 0xFFFF is never a real glyph so the trailing null glyph always has a slot
+    if (glyphCount >= 0xFFFF)
+        throw std::runtime_error("Sprite font has too many glyphs for GlyphTable");
+
+    m_glyphs.assign(glyphs, glyphs + glyphCount);
+    m_lineSpacing = lineSpacing;
+
+    const uint16_t nullIndex = static_cast<uint16_t>(glyphCount);
+
+    // Per-glyph metrics, with one trailing null glyph that measures as nothing
+    m_packed.resize(glyphCount + 1);
+    m_metrics.resize(glyphCount + 1);
+    m_usePacked = true;
+
+    for (size_t i = 0; i < glyphCount; i++)
+    {
+        const SpriteFontGlyph& glyph = m_glyphs[i];
+        float width = static_cast<float>(glyph.right - glyph.left);
+        float height = static_cast<float>(glyph.bottom - glyph.top);
+        bool whitespace = iswspace(static_cast<wint_t>(glyph.character)) != 0;
+
+        // SpriteFont::MeasureString ignores blank whitespace glyphs entirely
+        bool skipped = whitespace && width <= 1.0f && height <= 1.0f;
+
+        GlyphMetrics& metrics = m_metrics[i];
+        metrics.xOffset = glyph.xOffset;
+        metrics.width = skipped ? -1.0f : width;
+        metrics.advance = width + glyph.xAdvance;
+        metrics.height = whitespace ? m_lineSpacing : std::max(height + glyph.yOffset, m_lineSpacing);
+
+        float extent = glyph.xOffset + width;
+        float step = glyph.xOffset + metrics.advance;
+        float packedHeight = whitespace ? 0.0f : height + glyph.yOffset;
+
+        // The packed path drops the pen clamp at x = 0, which is only exact while the
+        // pen can never move left of the origin.
+        if (!IsIntegral(glyph.xOffset) || !IsIntegral(glyph.xAdvance) || !IsIntegral(glyph.yOffset) ||
+            !IsIntegral(extent) || !IsIntegral(step) || !IsIntegral(packedHeight) ||
+            glyph.xOffset < 0.0f || step < 0.0f || packedHeight < 0.0f)
+        {
+            m_usePacked = false;
+        }
+
+        PackedAdvance& packed = m_packed[i];
+        packed.extent = skipped ? -1 : static_cast<int16_t>(FitsInt16(extent) ? extent : 0);
+        packed.step = static_cast<int16_t>(FitsInt16(step) ? step : 0);
+        packed.height = skipped ? -1 : static_cast<int16_t>(FitsInt16(packedHeight) ? packedHeight : 0);
+        packed.reserved = 0;
+    }
+
+    m_packed[nullIndex] = { -1, 0, -1, 0 };
+    m_metrics[nullIndex] = { 0.0f, -1.0f, 0.0f, 0.0f };
+
+    // Resolve the default character once so lookups never need a fallback branch
+    m_defaultIndex = nullIndex;
+    auto defaultGlyph = std::lower_bound(m_glyphs.begin(), m_glyphs.end(), defaultCharacter,
+        [](const SpriteFontGlyph& glyph, uint32_t character) { return glyph.character < character; });
+    if (defaultCharacter != 0 && defaultGlyph != m_glyphs.end() && defaultGlyph->character == defaultCharacter)
+        m_defaultIndex = static_cast<uint16_t>(defaultGlyph - m_glyphs.begin());
+
+    // Page 0 is the shared page for unmapped high bytes; real pages are allocated on demand
+    std::memset(m_pageDirectory, 0, sizeof(m_pageDirectory));
+    m_pages.assign(PAGE_SIZE, m_defaultIndex);
+
+    for (size_t i = 0; i < glyphCount; i++)
+    {
+        uint32_t code = m_glyphs[i].character;
+        if (code >= PAGE_SIZE * PAGE_COUNT)
+            continue;
+
+        uint32_t high = code >> 8;
+        if (m_pageDirectory[high] == 0)
+        {
+            m_pageDirectory[high] = static_cast<uint16_t>(m_pages.size() / PAGE_SIZE);
+            m_pages.resize(m_pages.size() + PAGE_SIZE, m_defaultIndex);
+        }
+
+        m_pages[(static_cast<uint32_t>(m_pageDirectory[high]) << 8) | (code & 0xFF)] = static_cast<uint16_t>(i);
+    }
+
+    // Carriage returns never produce output, whatever the font contains
+    if (m_pageDirectory[0] == 0)
+    {
+        m_pageDirectory[0] = static_cast<uint16_t>(m_pages.size() / PAGE_SIZE);
+        m_pages.resize(m_pages.size() + PAGE_SIZE, m_defaultIndex);
+    }
+    m_pages[(static_cast<uint32_t>(m_pageDirectory[0]) << 8) | L'\r'] = nullIndex;
+
+    for (uint32_t code = 0; code < LATIN_SIZE; code++)
+        m_latinPacked[code] = m_packed[FindIndex(static_cast<wchar_t>(code))];
+}
+
+void GlyphTable::MeasureText(const wchar_t* text, float& outWidth, float& outHeight) const
+{
+    if (m_usePacked)
+        MeasurePacked(text, outWidth, outHeight);
+    else
+        MeasureFloat(text, outWidth, outHeight);
+}
+
+void GlyphTable::MeasurePacked(const wchar_t* text, float& outWidth, float& outHeight) const
+{
+    // Integer pen and extents: the per-character dependency chain is a single add,
+    // and all table loads depend only on the text, so they pipeline freely.
+    const PackedAdvance* packed = m_packed.data();
+
+    int32_t pen = 0;
+    int32_t maxRight = 0;
+    int32_t lineHeight = -1;
+    float y = 0.0f;
+    float maxBottom = 0.0f;
+
+    for (; *text; text++)
+    {
+        wchar_t character = *text;
+        if (character == L'\n')
+        {
+            if (lineHeight >= 0)
+                maxBottom = std::max(maxBottom, y + std::max(static_cast<float>(lineHeight), m_lineSpacing));
+            pen = 0;
+            lineHeight = -1;
+            y += m_lineSpacing;
+            continue;
+        }
+
+        uint32_t code = static_cast<uint32_t>(character);
+        const PackedAdvance& glyph = code < LATIN_SIZE ? m_latinPacked[code] : packed[FindIndex(character)];
+        int32_t mask = ~(static_cast<int32_t>(glyph.extent) >> 31);
+        maxRight = std::max(maxRight, (pen + glyph.extent) & mask);
+        lineHeight = std::max(lineHeight, static_cast<int32_t>(glyph.height));
+        pen += glyph.step;
+    }
+
+    if (lineHeight >= 0)
+        maxBottom = std::max(maxBottom, y + std::max(static_cast<float>(lineHeight), m_lineSpacing));
+
+    outWidth = static_cast<float>(maxRight);
+    outHeight = maxBottom;
+}
+
+void GlyphTable::MeasureFloat(const wchar_t* text, float& outWidth, float& outHeight) const
+{
+    // Exact SpriteFont::ForEachGlyph semantics, including the clamp at the origin
+    const GlyphMetrics* metrics = m_metrics.data();
+
+    float x = 0.0f;
+    float y = 0.0f;
+    float maxRight = 0.0f;
+    float maxBottom = 0.0f;
+
+    for (; *text; text++)
+    {
+        wchar_t character = *text;
+        if (character == L'\r')
+            continue;
+
+        if (character == L'\n')
+        {
+            x = 0.0f;
+            y += m_lineSpacing;
+            continue;
+        }
+
+        const GlyphMetrics& glyph = metrics[FindIndex(character)];
+        x += glyph.xOffset;
+        if (x < 0.0f)
+            x = 0.0f;
+
+        if (glyph.width >= 0.0f)
+        {
+            maxRight = std::max(maxRight, x + glyph.width);
+            maxBottom = std::max(maxBottom, y + glyph.height);
+        }
+
+        x += glyph.advance;
+    }
+
+    outWidth = maxRight;
+    outHeight = maxBottom;
+}
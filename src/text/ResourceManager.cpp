@@ -0,0 +1,497 @@
+#include "ResourceManager.h"
+#include <chrono>
+#include <stdexcept>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    double ElapsedMs(Clock::time_point from, Clock::time_point to)
+    {
+        return std::chrono::duration<double, std::milli>(to - from).count();
+    }
+
+    // A font loaded with its texture, without the atlas pixels
+    SpriteFontData CopyMetrics(const SpriteFontData& font)
+    {
+        SpriteFontData metrics;
+        metrics.glyphs = font.glyphs;
+        metrics.lineSpacing = font.lineSpacing;
+        metrics.defaultCharacter = font.defaultCharacter;
+        metrics.textureWidth = font.textureWidth;
+        metrics.textureHeight = font.textureHeight;
+        metrics.textureFormat = font.textureFormat;
+        metrics.textureStride = font.textureStride;
+        metrics.textureRows = font.textureRows;
+        return metrics;
+    }
+}
+
+ResourceManager::~ResourceManager()
+{
+    // Workers use this manager until they finish, whoever else holds their futures.
+    // They also take m_requestMutex, so it is not held while waiting.
+    std::vector<std::shared_future<FontHandle>> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        for (const auto& requests : m_requests)
+        {
+            for (const auto& request : requests)
+                pending.push_back(request.second.future);
+        }
+    }
+
+    for (const auto& request : pending)
+        request.wait();
+}
+
+void ResourceManager::MountPack(std::shared_ptr<const AssetPack> pack)
+{
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    m_pack = std::move(pack);
+}
+
+std::shared_ptr<const AssetPack> ResourceManager::GetPack() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_pack;
+}
+
+void ResourceManager::MountEmbeddedFonts(std::span<const EmbeddedFont* const> fonts)
+{
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    m_embeddedFonts.assign(fonts.begin(), fonts.end());
+}
+
+const EmbeddedFont* ResourceManager::FindEmbeddedFont(const std::wstring& fileName) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    for (const EmbeddedFont* font : m_embeddedFonts)
+    {
+        if (fileName == font->name)
+            return font;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<const TrueTypeFont> ResourceManager::LoadOutlineFont(const wchar_t* fileName)
+{
+    std::shared_ptr<const AssetPack> pack = GetPack();
+    AssetView asset = pack ? pack->Find(fileName) : AssetView();
+
+    // Parsed from a copy: outlines are read on every cache miss, long after a pack
+    // could have been unmounted
+    std::shared_ptr<const TrueTypeFont> font = asset
+        ? std::make_shared<TrueTypeFont>(std::vector<uint8_t>(asset.data, asset.data + asset.size))
+        : TrueTypeFont::Load(fileName);
+    m_loads++;
+
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    m_outlineFont = font;
+    m_residencyVersion++;
+    return font;
+}
+
+std::shared_ptr<const TrueTypeFont> ResourceManager::GetOutlineFont() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_outlineFont;
+}
+
+FontHandle ResourceManager::LoadFont(const wchar_t* fileName, bool withTexture)
+{
+    {
+        // Copied under the lock: another thread's insert may rehash the map once it is released
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        auto it = m_fontsByName.find(fileName);
+        if (it != m_fontsByName.end())
+        {
+            m_cacheHits++;
+            FontHandle handle = it->second;
+            lock.unlock();
+            if (withTexture)
+                GetFontTexture(handle);
+            return handle;
+        }
+    }
+
+    // Embedded and packed fonts cost no read; a loose file wanted with its texture is read
+    // whole once and the metrics copied out of it
+    auto font = std::make_unique<FontResource>();
+    std::unique_ptr<SpriteFontData> texture;
+    font->fileName = fileName;
+    const EmbeddedFont* embedded = FindEmbeddedFont(font->fileName);
+    std::shared_ptr<const AssetPack> pack = embedded ? nullptr : GetPack();
+    AssetView asset = pack ? pack->Find(fileName) : AssetView();
+    if (embedded)
+    {
+        font->data = embedded->ToSpriteFontData(false);
+    }
+    else if (asset)
+    {
+        font->data = SpriteFontFile::Parse(asset.data, asset.size, false);
+    }
+    else if (withTexture)
+    {
+        texture = std::make_unique<SpriteFontData>(SpriteFontFile::Load(fileName));
+        font->data = CopyMetrics(*texture);
+    }
+    else
+    {
+        font->data = SpriteFontFile::Load(fileName, false);
+    }
+    font->glyphs = GlyphTable(font->data);
+    const bool readTexture = texture != nullptr;
+
+    FontHandle handle;
+    {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+        // Another thread may have loaded the same file meanwhile
+        auto it = m_fontsByName.find(fileName);
+        if (it != m_fontsByName.end())
+        {
+            m_cacheHits++;
+            handle = it->second;
+        }
+        else
+        {
+            handle = m_fonts.Add(std::move(font));
+            if (!handle)
+                throw std::runtime_error("Resource manager is out of font slots");
+            m_fontsByName.emplace(fileName, handle);
+            m_loads++;
+            m_residencyVersion++;
+        }
+
+        FontResource& target = **m_fonts.Get(handle);
+        if (texture && !m_textures.IsValid(target.texture))
+        {
+            target.texture = m_textures.Add(std::move(texture));
+            if (!target.texture)
+                throw std::runtime_error("Resource manager is out of texture slots");
+            m_residencyVersion++;
+        }
+    }
+
+    // Embedded and packed textures are made in memory
+    if (withTexture && !readTexture)
+        GetFontTexture(handle);
+    return handle;
+}
+
+TextureHandle ResourceManager::GetFontTexture(FontHandle handle)
+{
+    const FontResource* font;
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        const auto* entry = m_fonts.Get(handle);
+        if (!entry)
+            throw std::runtime_error("Stale or null font handle");
+        font = entry->get();
+        if (m_textures.IsValid(font->texture))
+        {
+            m_cacheHits++;
+            return font->texture;
+        }
+    }
+
+    // The file name is immutable once loaded, so the file can be read without the lock. From
+    // a pack, the texture refers to the mapping and keeps the pack open.
+    std::unique_ptr<SpriteFontData> texture;
+    if (const EmbeddedFont* embedded = FindEmbeddedFont(font->fileName))
+    {
+        texture = std::make_unique<SpriteFontData>(embedded->ToSpriteFontData(true));
+    }
+    else
+    {
+        std::shared_ptr<const AssetPack> pack = GetPack();
+        AssetView asset = pack ? pack->Find(font->fileName.c_str()) : AssetView();
+        texture = std::make_unique<SpriteFontData>(asset ? SpriteFontFile::Map(asset.data, asset.size, pack)
+                                                         : SpriteFontFile::Load(font->fileName.c_str()));
+    }
+
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    auto* entry = m_fonts.Get(handle);
+    if (!entry)
+        throw std::runtime_error("Stale or null font handle");
+    FontResource& target = **entry;
+    if (m_textures.IsValid(target.texture))
+    {
+        m_cacheHits++;
+        return target.texture;
+    }
+
+    TextureHandle textureHandle = m_textures.Add(std::move(texture));
+    if (!textureHandle)
+        throw std::runtime_error("Resource manager is out of texture slots");
+    target.texture = textureHandle;
+    m_loads++;
+    m_residencyVersion++;
+    return textureHandle;
+}
+
+AtlasHandle ResourceManager::GetCoverageAtlas(FontHandle handle)
+{
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        const auto* entry = m_fonts.Get(handle);
+        if (!entry)
+            throw std::runtime_error("Stale or null font handle");
+        if (m_atlases.IsValid((*entry)->coverage))
+        {
+            m_cacheHits++;
+            return (*entry)->coverage;
+        }
+    }
+
+    // Texture data is immutable once loaded, so it can be decoded without the lock
+    const SpriteFontData& texture = GetTexture(GetFontTexture(handle));
+    auto atlas = std::make_unique<CoverageAtlas>(CoverageAtlas::FromSpriteFont(texture, m_coverageEncoding.load()));
+
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    auto* entry = m_fonts.Get(handle);
+    if (!entry)
+        throw std::runtime_error("Stale or null font handle");
+    FontResource& target = **entry;
+    if (m_atlases.IsValid(target.coverage))
+    {
+        m_cacheHits++;
+        return target.coverage;
+    }
+
+    AtlasHandle atlasHandle = m_atlases.Add(std::move(atlas));
+    if (!atlasHandle)
+        throw std::runtime_error("Resource manager is out of atlas slots");
+    target.coverage = atlasHandle;
+    m_loads++;
+    m_residencyVersion++;
+    return atlasHandle;
+}
+
+std::shared_future<FontHandle> ResourceManager::RequestFont(const wchar_t* fileName, FontPart part)
+{
+    // Failed requests are erased to be retried. Their futures are destroyed after the
+    // lock is released: the worker may still be on its way out and needs no lock, but
+    // destroying an async future waits for it.
+    std::vector<std::shared_future<FontHandle>> failed;
+    std::lock_guard<std::mutex> lock(m_requestMutex);
+    for (auto& requests : m_requests)
+    {
+        auto found = requests.find(fileName);
+        if (found != requests.end() && HasFailed(found->second))
+        {
+            failed.push_back(std::move(found->second.future));
+            requests.erase(found);
+        }
+    }
+
+    auto& requests = m_requests[static_cast<int>(part)];
+    auto it = requests.find(fileName);
+    if (it != requests.end())
+        return it->second.future;
+
+    // Build on the nearest outstanding request for less of the font instead of reading
+    // the file twice
+    std::shared_future<FontHandle> lower;
+    for (int level = static_cast<int>(part) - 1; level >= 0 && !lower.valid(); level--)
+    {
+        auto found = m_requests[level].find(fileName);
+        if (found != m_requests[level].end())
+            lower = found->second.future;
+    }
+
+    size_t index = m_records.size();
+    m_records.push_back(AssetLoadRecord{ fileName, part });
+    Clock::time_point requested = Clock::now();
+
+    std::shared_future<FontHandle> request = std::async(std::launch::async,
+        [this, name = std::wstring(fileName), part, lower, index, requested]
+    {
+        Clock::time_point started = Clock::now();
+        {
+            std::lock_guard<std::mutex> lock(m_requestMutex);
+            m_records[index].state = AssetLoadState::Loading;
+            m_records[index].queuedMs = ElapsedMs(requested, started);
+        }
+
+        try
+        {
+            FontHandle font = lower.valid() ? lower.get() : LoadFont(name.c_str(), part != FontPart::Metrics);
+            if (lower.valid() && part != FontPart::Metrics)
+                GetFontTexture(font);
+            Clock::time_point read = Clock::now();
+            if (part == FontPart::Coverage)
+                GetCoverageAtlas(font);
+            Clock::time_point decoded = Clock::now();
+
+            std::lock_guard<std::mutex> lock(m_requestMutex);
+            AssetLoadRecord& record = m_records[index];
+            record.state = AssetLoadState::Resident;
+            record.readMs = ElapsedMs(started, read);
+            record.decodeMs = ElapsedMs(read, decoded);
+            record.totalMs = ElapsedMs(requested, decoded);
+            return font;
+        }
+        catch (const std::exception& e)
+        {
+            std::lock_guard<std::mutex> lock(m_requestMutex);
+            AssetLoadRecord& record = m_records[index];
+            record.state = AssetLoadState::Failed;
+            record.totalMs = ElapsedMs(requested, Clock::now());
+            record.error = e.what();
+            throw;
+        }
+    }).share();
+
+    requests.emplace(fileName, FontRequest{ request, index });
+    return request;
+}
+
+FontHandle ResourceManager::FindFont(const wchar_t* fileName) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    auto it = m_fontsByName.find(fileName);
+    return it != m_fontsByName.end() ? it->second : FontHandle();
+}
+
+TextureHandle ResourceManager::FindFontTexture(FontHandle handle) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    const auto* font = m_fonts.Get(handle);
+    return font ? (*font)->texture : TextureHandle();
+}
+
+AtlasHandle ResourceManager::FindCoverageAtlas(FontHandle handle) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    const auto* font = m_fonts.Get(handle);
+    return font ? (*font)->coverage : AtlasHandle();
+}
+
+AssetLoadProgress ResourceManager::GetLoadProgress() const
+{
+    std::lock_guard<std::mutex> lock(m_requestMutex);
+    AssetLoadProgress progress;
+    progress.requested = m_records.size();
+    for (const AssetLoadRecord& record : m_records)
+    {
+        if (record.state == AssetLoadState::Resident)
+            progress.resident++;
+        else if (record.state == AssetLoadState::Failed)
+            progress.failed++;
+    }
+    return progress;
+}
+
+std::vector<AssetLoadRecord> ResourceManager::GetLoadRecords() const
+{
+    std::lock_guard<std::mutex> lock(m_requestMutex);
+    return m_records;
+}
+
+const FontResource& ResourceManager::GetFont(FontHandle handle) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    const auto* font = m_fonts.Get(handle);
+    if (!font)
+        throw std::runtime_error("Stale or null font handle");
+    return **font;
+}
+
+const SpriteFontData& ResourceManager::GetTexture(TextureHandle handle) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    const auto* texture = m_textures.Get(handle);
+    if (!texture)
+        throw std::runtime_error("Stale or null texture handle");
+    return **texture;
+}
+
+const CoverageAtlas& ResourceManager::GetAtlas(AtlasHandle handle) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    const auto* atlas = m_atlases.Get(handle);
+    if (!atlas)
+        throw std::runtime_error("Stale or null atlas handle");
+    return **atlas;
+}
+
+bool ResourceManager::IsValid(FontHandle font) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_fonts.IsValid(font);
+}
+
+bool ResourceManager::IsValid(TextureHandle texture) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_textures.IsValid(texture);
+}
+
+bool ResourceManager::IsValid(AtlasHandle atlas) const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_atlases.IsValid(atlas);
+}
+
+void ResourceManager::ReleaseFont(FontHandle handle)
+{
+    // Finished requests for the font are forgotten so a later RequestFont loads it again.
+    // Destroyed after the locks: one still decoding blocks until it is done.
+    std::vector<std::shared_future<FontHandle>> requests;
+
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    const auto* font = m_fonts.Get(handle);
+    if (!font)
+        return;
+
+    {
+        std::lock_guard<std::mutex> requestLock(m_requestMutex);
+        for (auto& pending : m_requests)
+        {
+            auto it = pending.find((*font)->fileName);
+            if (it != pending.end())
+            {
+                requests.push_back(std::move(it->second.future));
+                pending.erase(it);
+            }
+        }
+    }
+
+    m_textures.Remove((*font)->texture);
+    m_atlases.Remove((*font)->coverage);
+    m_fontsByName.erase((*font)->fileName);
+    m_fonts.Remove(handle);
+}
+
+size_t ResourceManager::GetFontCount() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_fonts.GetCount();
+}
+
+size_t ResourceManager::GetTextureCount() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_textures.GetCount();
+}
+
+size_t ResourceManager::GetAtlasCount() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_atlases.GetCount();
+}
+
+size_t ResourceManager::GetResidentBytes() const
+{
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    size_t bytes = 0;
+    for (const auto& font : m_fonts)
+        bytes += font->data.glyphs.size() * sizeof(SpriteFontGlyph);
+    for (const auto& texture : m_textures)
+        bytes += texture->glyphs.size() * sizeof(SpriteFontGlyph) + texture->textureData.size();
+    for (const auto& atlas : m_atlases)
+        bytes += atlas->GetByteSize();
+    return bytes;
+}
@@ -0,0 +1,113 @@
+#include "SkylinePacker.h"
+#include <algorithm>
+
+SkylinePacker::SkylinePacker()
+    : SkylinePacker(0, 0)
+{
+}
+
+SkylinePacker::SkylinePacker(uint32_t width, uint32_t height)
+{
+    Reset(width, height);
+}
+
+void SkylinePacker::Reset(uint32_t width, uint32_t height)
+{
+    m_width = width;
+    m_height = height;
+    m_usedHeight = 0;
+    m_usedArea = 0;
+    m_skyline.clear();
+    if (width)
+        m_skyline.push_back({ 0, 0, width });
+}
+
+uint32_t SkylinePacker::Fit(size_t index, uint32_t width, uint32_t height) const
+{
+    if (m_skyline[index].x + width > m_width)
+        return UINT32_MAX;
+
+    // The rectangle rests on the highest segment it spans
+    uint32_t y = 0;
+    uint32_t remaining = width;
+    for (size_t i = index; remaining > 0; i++)
+    {
+        y = std::max(y, m_skyline[i].y);
+        if (y + height > m_height)
+            return UINT32_MAX;
+        remaining -= std::min(remaining, m_skyline[i].width);
+    }
+    return y;
+}
+
+bool SkylinePacker::Insert(uint32_t width, uint32_t height, uint32_t& outX, uint32_t& outY)
+{
+    if (width == 0 || height == 0 || width > m_width || height > m_height)
+        return false;
+
+    size_t best = m_skyline.size();
+    uint32_t bestY = UINT32_MAX;
+    uint32_t bestWaste = UINT32_MAX;
+    for (size_t i = 0; i < m_skyline.size(); i++)
+    {
+        uint32_t y = Fit(i, width, height);
+        if (y == UINT32_MAX)
+            continue;
+
+        // Width of outline left uncovered under the rectangle
+        uint32_t waste = 0;
+        uint32_t remaining = width;
+        for (size_t j = i; remaining > 0; j++)
+        {
+            uint32_t span = std::min(remaining, m_skyline[j].width);
+            waste += (y - m_skyline[j].y) * span;
+            remaining -= span;
+        }
+
+        if (y < bestY || (y == bestY && waste < bestWaste))
+        {
+            best = i;
+            bestY = y;
+            bestWaste = waste;
+        }
+    }
+
+    if (best == m_skyline.size())
+        return false;
+
+    outX = m_skyline[best].x;
+    outY = bestY;
+
+    // Raise the outline under the rectangle: one new segment replaces everything it
+    // covers, and a partly covered segment keeps its right part
+    Segment placed = { outX, bestY + height, width };
+    size_t end = best;
+    while (end < m_skyline.size() && m_skyline[end].x + m_skyline[end].width <= outX + width)
+        end++;
+    if (end < m_skyline.size() && m_skyline[end].x < outX + width)
+    {
+        uint32_t cut = outX + width - m_skyline[end].x;
+        m_skyline[end].x += cut;
+        m_skyline[end].width -= cut;
+    }
+    m_skyline.erase(m_skyline.begin() + best, m_skyline.begin() + end);
+    m_skyline.insert(m_skyline.begin() + best, placed);
+
+    // Merge neighbours at the same height
+    for (size_t i = 0; i + 1 < m_skyline.size(); )
+    {
+        if (m_skyline[i].y == m_skyline[i + 1].y)
+        {
+            m_skyline[i].width += m_skyline[i + 1].width;
+            m_skyline.erase(m_skyline.begin() + i + 1);
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    m_usedHeight = std::max(m_usedHeight, bestY + height);
+    m_usedArea += static_cast<uint64_t>(width) * height;
+    return true;
+}
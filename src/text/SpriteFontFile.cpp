@@ -0,0 +1,183 @@
+#include "SpriteFontFile.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+    const char SPRITEFONT_MAGIC[] = "DXTKfont";
+    const size_t MAGIC_SIZE = sizeof(SPRITEFONT_MAGIC) - 1;
+
+    // magic + glyph count
+    const size_t HEADER_SIZE = MAGIC_SIZE + sizeof(uint32_t);
+
+    // lineSpacing + defaultCharacter + width/height/format/stride/rows
+    const size_t TRAILER_SIZE = sizeof(float) + 6 * sizeof(uint32_t);
+
+    // Glyph counts above this are treated as a corrupt file
+    const uint32_t MAX_GLYPHS = 0x10000;
+
+    class BlobReader
+    {
+    public:
+        BlobReader(const uint8_t* data, size_t size) : m_data(data), m_size(size), m_offset(0) {}
+
+        template <typename T>
+        T Read()
+        {
+            T value;
+            ReadBytes(&value, sizeof(T));
+            return value;
+        }
+
+        void ReadBytes(void* dest, size_t count)
+        {
+            std::memcpy(dest, Skip(count), count);
+        }
+
+        // The next count bytes, in place
+        const uint8_t* Skip(size_t count)
+        {
+            if (count > m_size - m_offset)
+                throw std::runtime_error("Sprite font data is truncated");
+            const uint8_t* data = m_data + m_offset;
+            m_offset += count;
+            return data;
+        }
+
+    private:
+        const uint8_t* m_data;
+        size_t m_size;
+        size_t m_offset;
+    };
+}
+
+SpriteFontData SpriteFontFile::Load(const wchar_t* fileName, bool loadTexture)
+{
+    std::ifstream file(std::filesystem::path(fileName), std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Failed to open sprite font file");
+
+    // Read the header first to learn how large the glyph table is
+    std::vector<uint8_t> buffer(HEADER_SIZE);
+    if (!file.read(reinterpret_cast<char*>(buffer.data()), HEADER_SIZE))
+        throw std::runtime_error("Sprite font file is truncated");
+
+    uint32_t glyphCount;
+    std::memcpy(&glyphCount, buffer.data() + MAGIC_SIZE, sizeof(glyphCount));
+    if (glyphCount > MAX_GLYPHS)
+        throw std::runtime_error("Sprite font file has an invalid glyph count");
+
+    size_t metricsSize = glyphCount * sizeof(SpriteFontGlyph) + TRAILER_SIZE;
+    buffer.resize(HEADER_SIZE + metricsSize);
+    if (!file.read(reinterpret_cast<char*>(buffer.data() + HEADER_SIZE), metricsSize))
+        throw std::runtime_error("Sprite font file is truncated");
+
+    if (loadTexture)
+    {
+        uint32_t stride, rows;
+        std::memcpy(&stride, buffer.data() + buffer.size() - 2 * sizeof(uint32_t), sizeof(stride));
+        std::memcpy(&rows, buffer.data() + buffer.size() - sizeof(uint32_t), sizeof(rows));
+
+        size_t textureSize = static_cast<size_t>(stride) * rows;
+        size_t offset = buffer.size();
+        buffer.resize(offset + textureSize);
+        if (!file.read(reinterpret_cast<char*>(buffer.data() + offset), textureSize))
+            throw std::runtime_error("Sprite font texture data is truncated");
+    }
+
+    return Parse(buffer.data(), buffer.size(), loadTexture);
+}
+
+SpriteFontData SpriteFontFile::Parse(const uint8_t* data, size_t size, bool loadTexture)
+{
+    return ParseBlob(data, size, loadTexture ? TextureMode::Copy : TextureMode::Skip);
+}
+
+SpriteFontData SpriteFontFile::Map(const uint8_t* data, size_t size, std::shared_ptr<const void> storage)
+{
+    SpriteFontData font = ParseBlob(data, size, TextureMode::Reference);
+    font.storage = std::move(storage);
+    return font;
+}
+
+std::vector<uint8_t> SpriteFontFile::Serialize(const SpriteFontData& font)
+{
+    size_t textureSize = static_cast<size_t>(font.textureStride) * font.textureRows;
+    if (font.GetTextureSize() < textureSize)
+        throw std::runtime_error("Sprite font texture is smaller than its description");
+
+    std::vector<uint8_t> blob;
+    blob.reserve(HEADER_SIZE + font.glyphs.size() * sizeof(SpriteFontGlyph) + TRAILER_SIZE + textureSize);
+
+    auto append = [&blob](const void* data, size_t size)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        blob.insert(blob.end(), bytes, bytes + size);
+    };
+    auto appendValue = [&append](const auto& value) { append(&value, sizeof(value)); };
+
+    append(SPRITEFONT_MAGIC, MAGIC_SIZE);
+    appendValue(static_cast<uint32_t>(font.glyphs.size()));
+    append(font.glyphs.data(), font.glyphs.size() * sizeof(SpriteFontGlyph));
+    appendValue(font.lineSpacing);
+    appendValue(font.defaultCharacter);
+    appendValue(font.textureWidth);
+    appendValue(font.textureHeight);
+    appendValue(font.textureFormat);
+    appendValue(font.textureStride);
+    appendValue(font.textureRows);
+    append(font.GetTextureData(), textureSize);
+    return blob;
+}
+
+void SpriteFontFile::Save(const SpriteFontData& font, const wchar_t* fileName)
+{
+    std::vector<uint8_t> blob = Serialize(font);
+
+    std::filesystem::path filePath(fileName);
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file || !file.write(reinterpret_cast<const char*>(blob.data()), blob.size()) || !file.flush())
+        throw std::runtime_error("Failed to write sprite font file " + filePath.string());
+}
+
+SpriteFontData SpriteFontFile::ParseBlob(const uint8_t* data, size_t size, TextureMode texture)
+{
+    BlobReader reader(data, size);
+
+    char magic[MAGIC_SIZE];
+    reader.ReadBytes(magic, MAGIC_SIZE);
+    if (std::memcmp(magic, SPRITEFONT_MAGIC, MAGIC_SIZE) != 0)
+        throw std::runtime_error("Not a sprite font file");
+
+    uint32_t glyphCount = reader.Read<uint32_t>();
+    if (glyphCount > MAX_GLYPHS)
+        throw std::runtime_error("Sprite font file has an invalid glyph count");
+
+    SpriteFontData font;
+    font.glyphs.resize(glyphCount);
+    reader.ReadBytes(font.glyphs.data(), glyphCount * sizeof(SpriteFontGlyph));
+
+    font.lineSpacing = reader.Read<float>();
+    font.defaultCharacter = reader.Read<uint32_t>();
+
+    font.textureWidth = reader.Read<uint32_t>();
+    font.textureHeight = reader.Read<uint32_t>();
+    font.textureFormat = reader.Read<uint32_t>();
+    font.textureStride = reader.Read<uint32_t>();
+    font.textureRows = reader.Read<uint32_t>();
+
+    size_t textureSize = static_cast<size_t>(font.textureStride) * font.textureRows;
+    if (texture == TextureMode::Copy)
+    {
+        font.textureData.resize(textureSize);
+        reader.ReadBytes(font.textureData.data(), textureSize);
+    }
+    else if (texture == TextureMode::Reference)
+    {
+        font.mappedTexture = reader.Skip(textureSize);
+    }
+
+    return font;
+}
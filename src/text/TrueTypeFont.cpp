@@ -0,0 +1,510 @@
+#include "TrueTypeFont.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace
+{
+    // Simple glyph point flags
+    const uint8_t ON_CURVE = 0x01;
+    const uint8_t X_SHORT = 0x02;
+    const uint8_t Y_SHORT = 0x04;
+    const uint8_t REPEAT = 0x08;
+    const uint8_t X_SAME_OR_POSITIVE = 0x10;
+    const uint8_t Y_SAME_OR_POSITIVE = 0x20;
+
+    // Composite glyph component flags
+    const uint16_t ARGS_ARE_WORDS = 0x0001;
+    const uint16_t ARGS_ARE_XY_VALUES = 0x0002;
+    const uint16_t HAS_SCALE = 0x0008;
+    const uint16_t MORE_COMPONENTS = 0x0020;
+    const uint16_t HAS_XY_SCALE = 0x0040;
+    const uint16_t HAS_2X2 = 0x0080;
+
+    // Composites nest rarely more than two deep; this only stops reference cycles
+    const int MAX_COMPOSITE_DEPTH = 8;
+
+    // Bounds-checked big-endian reads over one glyph's data. A read past the end sets
+    // `failed` and returns 0, so a malformed glyph parses as empty instead of throwing.
+    class GlyphReader
+    {
+    public:
+        GlyphReader(const uint8_t* data, size_t size) : failed(false), m_data(data), m_size(size), m_offset(0) {}
+
+        uint8_t U8()
+        {
+            if (m_offset + 1 > m_size)
+                return Fail();
+            return m_data[m_offset++];
+        }
+
+        uint16_t U16()
+        {
+            if (m_offset + 2 > m_size)
+                return Fail();
+            uint16_t value = static_cast<uint16_t>((m_data[m_offset] << 8) | m_data[m_offset + 1]);
+            m_offset += 2;
+            return value;
+        }
+
+        int16_t S16() { return static_cast<int16_t>(U16()); }
+
+        void Skip(size_t count)
+        {
+            if (count > m_size - m_offset)
+                Fail();
+            else
+                m_offset += count;
+        }
+
+        bool failed;
+
+    private:
+        uint8_t Fail()
+        {
+            failed = true;
+            m_offset = m_size;
+            return 0;
+        }
+
+        const uint8_t* m_data;
+        size_t m_size;
+        size_t m_offset;
+    };
+
+    float F2Dot14(uint16_t value)
+    {
+        return static_cast<int16_t>(value) / 16384.0f;
+    }
+}
+
+TrueTypeFont::TrueTypeFont(std::vector<uint8_t> data)
+    : m_data(std::move(data))
+    , m_glyphCount(0)
+    , m_unitsPerEm(0)
+    , m_horizontalMetricCount(0)
+    , m_longLocations(false)
+    , m_ascent(0.0f)
+    , m_descent(0.0f)
+    , m_cellHeight(0.0f)
+    , m_latinGlyphs()
+{
+    if (m_data.size() < 12)
+        throw std::runtime_error("TrueType font is truncated");
+
+    uint32_t version = Read32(0);
+    if (version != 0x00010000 && version != 0x74727565)    // 1.0 or 'true'
+        throw std::runtime_error("Not a TrueType outline font");
+
+    Table head = FindTable("head");
+    Table maxp = FindTable("maxp");
+    Table hhea = FindTable("hhea");
+    Table cmap = FindTable("cmap");
+    m_hmtx = FindTable("hmtx");
+    m_loca = FindTable("loca");
+    m_glyf = FindTable("glyf");
+    if (!head.length || !maxp.length || !hhea.length || !cmap.length || !m_hmtx.length || !m_loca.length || !m_glyf.length)
+        throw std::runtime_error("TrueType font is missing a required table");
+    if (head.length < 54 || maxp.length < 6 || hhea.length < 36)
+        throw std::runtime_error("TrueType font header tables are truncated");
+
+    m_unitsPerEm = Read16(head.offset + 18);
+    m_longLocations = Read16(head.offset + 50) != 0;
+    m_glyphCount = Read16(maxp.offset + 4);
+    m_horizontalMetricCount = Read16(hhea.offset + 34);
+    if (m_unitsPerEm == 0 || m_glyphCount == 0 || m_horizontalMetricCount == 0 || m_horizontalMetricCount > m_glyphCount)
+        throw std::runtime_error("TrueType font has invalid header values");
+
+    // Every glyph's location must lie inside the glyf table, in order
+    size_t locationSize = m_longLocations ? 4 : 2;
+    if (m_loca.length < (m_glyphCount + 1u) * locationSize)
+        throw std::runtime_error("TrueType location table is truncated");
+    uint32_t previous = 0;
+    for (uint32_t glyph = 0; glyph <= m_glyphCount; glyph++)
+    {
+        uint32_t location = m_longLocations ? Read32(m_loca.offset + glyph * 4) : Read16(m_loca.offset + glyph * 2) * 2u;
+        if (location < previous || location > m_glyf.length)
+            throw std::runtime_error("TrueType location table is invalid");
+        previous = location;
+    }
+    if (m_hmtx.length < m_horizontalMetricCount * 4u + (m_glyphCount - m_horizontalMetricCount) * 2u)
+        throw std::runtime_error("TrueType metrics table is truncated");
+
+    // GDI sizes fonts by the Windows cell, which the OS/2 table gives; hhea otherwise
+    Table os2 = FindTable("OS/2");
+    if (os2.length >= 78)
+    {
+        m_ascent = static_cast<float>(Read16(os2.offset + 74));
+        m_descent = static_cast<float>(Read16(os2.offset + 76));
+    }
+    else
+    {
+        m_ascent = static_cast<float>(static_cast<int16_t>(Read16(hhea.offset + 4)));
+        m_descent = -static_cast<float>(static_cast<int16_t>(Read16(hhea.offset + 6)));
+    }
+    m_cellHeight = m_ascent + m_descent;
+    if (m_cellHeight <= 0.0f)
+        throw std::runtime_error("TrueType font has an empty cell");
+
+    ParseCharacterMap(cmap);
+}
+
+std::shared_ptr<TrueTypeFont> TrueTypeFont::Load(const wchar_t* fileName)
+{
+    std::ifstream file(std::filesystem::path(fileName), std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Failed to open TrueType font file");
+
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return std::make_shared<TrueTypeFont>(std::move(data));
+}
+
+uint16_t TrueTypeFont::Read16(size_t offset) const
+{
+    if (offset + 2 > m_data.size())
+        throw std::runtime_error("TrueType font is truncated");
+    return static_cast<uint16_t>((m_data[offset] << 8) | m_data[offset + 1]);
+}
+
+uint32_t TrueTypeFont::Read32(size_t offset) const
+{
+    return (static_cast<uint32_t>(Read16(offset)) << 16) | Read16(offset + 2);
+}
+
+TrueTypeFont::Table TrueTypeFont::FindTable(const char tag[4]) const
+{
+    uint16_t tableCount = Read16(4);
+    for (uint16_t i = 0; i < tableCount; i++)
+    {
+        size_t record = 12 + i * 16;
+        if (record + 16 > m_data.size())
+            break;
+        if (std::memcmp(m_data.data() + record, tag, 4) != 0)
+            continue;
+
+        Table table = { Read32(record + 8), Read32(record + 12) };
+        if (table.offset > m_data.size() || table.length > m_data.size() - table.offset)
+            throw std::runtime_error("TrueType table lies outside the file");
+        return table;
+    }
+    return Table();
+}
+
+void TrueTypeFont::ParseCharacterMap(const Table& cmap)
+{
+    // Prefer the full Unicode subtable (format 12), then the BMP one (format 4)
+    uint32_t subtable = 0;
+    int bestRank = 0;
+    uint16_t subtableCount = Read16(cmap.offset + 2);
+    for (uint16_t i = 0; i < subtableCount; i++)
+    {
+        size_t record = cmap.offset + 4 + i * 8;
+        uint16_t platform = Read16(record);
+        uint16_t encoding = Read16(record + 2);
+        uint32_t offset = Read32(record + 4);
+        if (offset + 4 > cmap.length)
+            continue;
+
+        uint16_t format = Read16(cmap.offset + offset);
+        bool unicode = platform == 0 || (platform == 3 && (encoding == 1 || encoding == 10));
+        int rank = !unicode ? 0 : format == 12 ? 2 : format == 4 ? 1 : 0;
+        if (rank > bestRank)
+        {
+            bestRank = rank;
+            subtable = cmap.offset + offset;
+        }
+    }
+    if (bestRank == 0)
+        throw std::runtime_error("TrueType font has no Unicode character map");
+
+    if (Read16(subtable) == 12)
+    {
+        uint32_t groupCount = Read32(subtable + 12);
+        if (groupCount > (cmap.offset + cmap.length - subtable) / 12)
+            throw std::runtime_error("TrueType character map is truncated");
+        for (uint32_t i = 0; i < groupCount; i++)
+        {
+            size_t group = subtable + 16 + i * 12;
+            uint32_t first = Read32(group);
+            uint32_t last = Read32(group + 4);
+            uint32_t glyph = Read32(group + 8);
+            if (first <= last)
+                m_ranges.push_back({ first, last, UINT32_MAX, static_cast<int32_t>(glyph - first) });
+        }
+    }
+    else
+    {
+        uint16_t segmentCount = Read16(subtable + 6) / 2;
+        size_t ends = subtable + 14;
+        size_t starts = ends + segmentCount * 2 + 2;
+        size_t deltas = starts + segmentCount * 2;
+        size_t rangeOffsets = deltas + segmentCount * 2;
+        for (uint16_t i = 0; i < segmentCount; i++)
+        {
+            uint32_t first = Read16(starts + i * 2);
+            uint32_t last = Read16(ends + i * 2);
+            int32_t delta = static_cast<int16_t>(Read16(deltas + i * 2));
+            uint16_t rangeOffset = Read16(rangeOffsets + i * 2);
+            if (first > last || first == 0xFFFF)
+                continue;
+
+            if (rangeOffset == 0)
+            {
+                m_ranges.push_back({ first, last, UINT32_MAX, delta });
+                continue;
+            }
+
+            // Glyphs come from the glyph index array, relative to this range offset
+            CharacterRange range = { first, last, static_cast<uint32_t>(m_rangeGlyphs.size()), delta };
+            for (uint32_t character = first; character <= last; character++)
+            {
+                size_t entry = rangeOffsets + i * 2 + rangeOffset + (character - first) * 2;
+                uint16_t glyph = entry + 2 <= cmap.offset + cmap.length ? Read16(entry) : 0;
+                m_rangeGlyphs.push_back(glyph ? static_cast<uint16_t>(glyph + delta) : 0);
+            }
+            m_ranges.push_back(range);
+        }
+    }
+
+    std::sort(m_ranges.begin(), m_ranges.end(),
+        [](const CharacterRange& a, const CharacterRange& b) { return a.first < b.first; });
+
+    for (uint32_t character = 0; character < 256; character++)
+    {
+        m_latinGlyphs[character] = 0;
+        auto range = std::upper_bound(m_ranges.begin(), m_ranges.end(), character,
+            [](uint32_t c, const CharacterRange& r) { return c < r.first; });
+        if (range == m_ranges.begin())
+            continue;
+        --range;
+        if (character > range->last)
+            continue;
+        uint32_t glyph = range->glyphOffset == UINT32_MAX ? (character + range->delta) & 0xFFFF
+                                                          : m_rangeGlyphs[range->glyphOffset + character - range->first];
+        m_latinGlyphs[character] = glyph < m_glyphCount ? static_cast<uint16_t>(glyph) : 0;
+    }
+}
+
+uint16_t TrueTypeFont::FindGlyph(uint32_t character) const
+{
+    if (character < 256)
+        return m_latinGlyphs[character];
+
+    auto range = std::upper_bound(m_ranges.begin(), m_ranges.end(), character,
+        [](uint32_t c, const CharacterRange& r) { return c < r.first; });
+    if (range == m_ranges.begin())
+        return 0;
+    --range;
+    if (character > range->last)
+        return 0;
+
+    // Format 4 deltas wrap at 16 bits; format 12 ranges never reach that far
+    uint32_t glyph = range->glyphOffset == UINT32_MAX ? (character + range->delta) & (character < 0x10000 ? 0xFFFF : 0xFFFFFFFF)
+                                                      : m_rangeGlyphs[range->glyphOffset + character - range->first];
+    return glyph < m_glyphCount ? static_cast<uint16_t>(glyph) : 0;
+}
+
+float TrueTypeFont::GetAdvance(uint16_t glyph) const
+{
+    if (glyph >= m_glyphCount)
+        glyph = 0;
+    uint16_t metric = std::min<uint16_t>(glyph, m_horizontalMetricCount - 1);
+    return static_cast<float>(Read16(m_hmtx.offset + metric * 4));
+}
+
+void TrueTypeFont::MeasureText(const wchar_t* text, float fontSize, float& outWidth, float& outHeight) const
+{
+    float scale = GetScale(fontSize);
+    float lineWidth = 0.0f;
+    int lines = 1;
+    outWidth = 0.0f;
+    for (; *text; text++)
+    {
+        wchar_t character = *text;
+        if (character == L'\r')
+            continue;
+
+        if (character == L'\n')
+        {
+            lineWidth = 0.0f;
+            lines++;
+            continue;
+        }
+
+        lineWidth += GetAdvance(FindGlyph(character)) * scale;
+        outWidth = std::max(outWidth, lineWidth);
+    }
+    outWidth = std::ceil(outWidth);
+    outHeight = static_cast<float>(lines * std::lround(fontSize));
+}
+
+bool TrueTypeFont::GetGlyphData(uint16_t glyph, uint32_t& offset, uint32_t& length) const
+{
+    if (glyph >= m_glyphCount)
+        return false;
+    uint32_t begin = m_longLocations ? Read32(m_loca.offset + glyph * 4) : Read16(m_loca.offset + glyph * 2) * 2u;
+    uint32_t end = m_longLocations ? Read32(m_loca.offset + glyph * 4 + 4) : Read16(m_loca.offset + glyph * 2 + 2) * 2u;
+    offset = m_glyf.offset + begin;
+    length = end - begin;
+    return length >= 10;
+}
+
+void TrueTypeFont::GetOutline(uint16_t glyph, GlyphOutline& outline) const
+{
+    outline.points.clear();
+    outline.contourEnds.clear();
+
+    static const float IDENTITY[6] = { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f };
+    AppendGlyph(glyph, IDENTITY, 0, outline);
+
+    if (outline.points.empty())
+    {
+        outline.contourEnds.clear();
+        outline.xMin = outline.yMin = outline.xMax = outline.yMax = 0.0f;
+        return;
+    }
+
+    outline.xMin = outline.xMax = outline.points[0].x;
+    outline.yMin = outline.yMax = outline.points[0].y;
+    for (const GlyphOutline::Point& point : outline.points)
+    {
+        outline.xMin = std::min(outline.xMin, point.x);
+        outline.xMax = std::max(outline.xMax, point.x);
+        outline.yMin = std::min(outline.yMin, point.y);
+        outline.yMax = std::max(outline.yMax, point.y);
+    }
+}
+
+void TrueTypeFont::AppendGlyph(uint16_t glyph, const float transform[6], int depth, GlyphOutline& outline) const
+{
+    uint32_t offset, length;
+    if (depth > MAX_COMPOSITE_DEPTH || !GetGlyphData(glyph, offset, length))
+        return;
+
+    GlyphReader reader(m_data.data() + offset, length);
+    int16_t contourCount = reader.S16();
+    reader.Skip(8);     // Bounding box, recomputed from the transformed points
+
+    if (contourCount >= 0)
+    {
+        std::vector<uint16_t> ends(contourCount);
+        for (uint16_t& end : ends)
+            end = reader.U16();
+        uint32_t pointCount = contourCount ? ends.back() + 1u : 0;
+        reader.Skip(reader.U16());     // Hinting instructions
+
+        std::vector<uint8_t> flags(pointCount);
+        for (uint32_t i = 0; i < pointCount && !reader.failed; )
+        {
+            uint8_t flag = reader.U8();
+            uint32_t count = (flag & REPEAT) ? reader.U8() + 1u : 1u;
+            for (; count > 0 && i < pointCount; count--)
+                flags[i++] = flag;
+        }
+
+        std::vector<int32_t> xs(pointCount), ys(pointCount);
+        int32_t value = 0;
+        for (uint32_t i = 0; i < pointCount; i++)
+        {
+            if (flags[i] & X_SHORT)
+                value += (flags[i] & X_SAME_OR_POSITIVE) ? reader.U8() : -reader.U8();
+            else if (!(flags[i] & X_SAME_OR_POSITIVE))
+                value += reader.S16();
+            xs[i] = value;
+        }
+        value = 0;
+        for (uint32_t i = 0; i < pointCount; i++)
+        {
+            if (flags[i] & Y_SHORT)
+                value += (flags[i] & Y_SAME_OR_POSITIVE) ? reader.U8() : -reader.U8();
+            else if (!(flags[i] & Y_SAME_OR_POSITIVE))
+                value += reader.S16();
+            ys[i] = value;
+        }
+        if (reader.failed)
+            return;
+
+        uint32_t base = static_cast<uint32_t>(outline.points.size());
+        uint32_t previousEnd = 0;
+        for (uint16_t end : ends)
+        {
+            // Contour ends must increase; anything else is a corrupt glyph
+            if (end + 1u <= previousEnd || end >= pointCount)
+                break;
+            outline.contourEnds.push_back(base + end + 1u);
+            previousEnd = end + 1u;
+        }
+        for (uint32_t i = 0; i < previousEnd; i++)
+        {
+            float x = static_cast<float>(xs[i]);
+            float y = static_cast<float>(ys[i]);
+            outline.points.push_back({ transform[0] * x + transform[2] * y + transform[4],
+                                       transform[1] * x + transform[3] * y + transform[5],
+                                       (flags[i] & ON_CURVE) != 0 });
+        }
+        return;
+    }
+
+    // Composite: transformed references to other glyphs
+    uint16_t flags;
+    do
+    {
+        flags = reader.U16();
+        uint16_t component = reader.U16();
+        float dx = 0.0f, dy = 0.0f;
+        if (flags & ARGS_ARE_WORDS)
+        {
+            int16_t a = reader.S16(), b = reader.S16();
+            if (flags & ARGS_ARE_XY_VALUES)
+            {
+                dx = a;
+                dy = b;
+            }
+        }
+        else
+        {
+            int8_t a = static_cast<int8_t>(reader.U8()), b = static_cast<int8_t>(reader.U8());
+            if (flags & ARGS_ARE_XY_VALUES)
+            {
+                dx = a;
+                dy = b;
+            }
+        }
+
+        // Point-matched placement (no XY values) is rare and left at the origin
+        float m[4] = { 1.0f, 0.0f, 0.0f, 1.0f };
+        if (flags & HAS_SCALE)
+        {
+            m[0] = m[3] = F2Dot14(reader.U16());
+        }
+        else if (flags & HAS_XY_SCALE)
+        {
+            m[0] = F2Dot14(reader.U16());
+            m[3] = F2Dot14(reader.U16());
+        }
+        else if (flags & HAS_2X2)
+        {
+            m[0] = F2Dot14(reader.U16());
+            m[1] = F2Dot14(reader.U16());
+            m[2] = F2Dot14(reader.U16());
+            m[3] = F2Dot14(reader.U16());
+        }
+        if (reader.failed)
+            return;
+
+        // Parent transform applied after the component's own
+        float combined[6] = {
+            transform[0] * m[0] + transform[2] * m[1],
+            transform[1] * m[0] + transform[3] * m[1],
+            transform[0] * m[2] + transform[2] * m[3],
+            transform[1] * m[2] + transform[3] * m[3],
+            transform[0] * dx + transform[2] * dy + transform[4],
+            transform[1] * dx + transform[3] * dy + transform[5],
+        };
+        AppendGlyph(component, combined, depth + 1, outline);
+    } while (flags & MORE_COMPONENTS);
+}
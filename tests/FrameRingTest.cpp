@@ -0,0 +1,143 @@
+// FrameRing driven by a CpuFence standing in for the GPU: frames block on the fence value
+// of the frame that last used their context, at every depth.
+#include "FrameRing.h"
+#include "TestCheck.h"
+#include <atomic>
+#include <future>
+#include <thread>
+
+namespace
+{
+    struct Context
+    {
+        int frames = 0;
+    };
+
+    // Record `count` frames that need no wait; returns the last fence value
+    uint64_t RecordFrames(FrameRing<Context>& ring, int count)
+    {
+        uint64_t value = 0;
+        for (int i = 0; i < count; i++)
+        {
+            ring.BeginFrame().frames++;
+            value = ring.EndFrame();
+        }
+        return value;
+    }
+
+    void TestBeginFrameWaitsForFence()
+    {
+        CpuFence fence;
+        FrameRing<Context> ring(fence, 2);
+        CHECK(RecordFrames(ring, 2) == 2);
+        CHECK(ring.GetStallCount() == 0);
+
+        // The third frame reuses the first one's context, so it waits for value 1
+        auto begin = std::async(std::launch::async, [&] { return &ring.BeginFrame(); });
+        CHECK(begin.wait_for(Test::BLOCK_WAIT) == std::future_status::timeout);
+        fence.Signal(1);
+        CHECK(begin.wait_for(Test::FINISH_WAIT) == std::future_status::ready);
+        CHECK(begin.get() == &ring.GetContext(0));
+        CHECK(ring.GetStallCount() == 1);
+        ring.EndFrame();
+    }
+
+    void TestDepth(uint32_t depth)
+    {
+        CpuFence fence;
+        FrameRing<Context> ring(fence);
+        ring.SetDepth(depth);
+        CHECK(ring.GetDepth() == depth);
+
+        // `depth` frames run ahead on distinct contexts without the consumer
+        for (uint32_t i = 0; i < depth; i++)
+        {
+            CHECK(&ring.BeginFrame() == &ring.GetContext(i));
+            CHECK(ring.EndFrame() == i + 1);
+        }
+        CHECK(ring.GetStallCount() == 0);
+
+        // One more needs the oldest frame retired
+        auto begin = std::async(std::launch::async, [&] { return &ring.BeginFrame(); });
+        CHECK(begin.wait_for(Test::BLOCK_WAIT) == std::future_status::timeout);
+        fence.Signal(1);
+        CHECK(begin.wait_for(Test::FINISH_WAIT) == std::future_status::ready);
+        CHECK(begin.get() == &ring.GetContext(0));
+        CHECK(ring.GetStallCount() == 1);
+        ring.EndFrame();
+
+        // Against a consumer thread, the CPU never gets more than `depth` frames ahead
+        const uint64_t FRAMES = 200;
+        std::atomic<uint64_t> submitted(depth + 1);
+        std::thread consumer([&]
+        {
+            for (uint64_t value = 2; value <= depth + 1 + FRAMES; value++)
+            {
+                while (submitted.load() < value)
+                    std::this_thread::yield();
+                fence.Signal(value);
+            }
+        });
+        for (uint64_t frame = depth + 1; frame < depth + 1 + FRAMES; frame++)
+        {
+            ring.BeginFrame().frames++;
+            CHECK(fence.GetCompletedValue() + depth >= frame + 1);
+            submitted.store(ring.EndFrame());
+        }
+        consumer.join();
+    }
+
+    void TestDepthIsClamped()
+    {
+        CpuFence fence;
+        FrameRing<Context> ring(fence, 0);
+        CHECK(ring.GetDepth() == 1);
+        ring.SetDepth(MAX_FRAMES_IN_FLIGHT + 1);
+        CHECK(ring.GetDepth() == MAX_FRAMES_IN_FLIGHT);
+    }
+
+    void TestSetDepthDrainsFirst()
+    {
+        CpuFence fence;
+        FrameRing<Context> ring(fence, 3);
+        RecordFrames(ring, 2);
+
+        auto setDepth = std::async(std::launch::async, [&] { ring.SetDepth(1); });
+        fence.Signal(1);
+        CHECK(setDepth.wait_for(Test::BLOCK_WAIT) == std::future_status::timeout);
+        fence.Signal(2);
+        CHECK(setDepth.wait_for(Test::FINISH_WAIT) == std::future_status::ready);
+        CHECK(ring.GetDepth() == 1);
+        CHECK(&ring.BeginFrame() == &ring.GetContext(0));
+        ring.EndFrame();
+    }
+
+    void TestWaitIdleDrainsAllFrames()
+    {
+        CpuFence fence;
+        FrameRing<Context> ring(fence, 3);
+        CHECK(RecordFrames(ring, 3) == 3);
+
+        // Retiring the older frames is not enough
+        auto waitIdle = std::async(std::launch::async, [&] { ring.WaitIdle(); });
+        fence.Signal(2);
+        CHECK(waitIdle.wait_for(Test::BLOCK_WAIT) == std::future_status::timeout);
+        fence.Signal(3);
+        CHECK(waitIdle.wait_for(Test::FINISH_WAIT) == std::future_status::ready);
+
+        // Nothing in flight: returns at once
+        ring.WaitIdle();
+        CHECK(ring.GetStallCount() == 0);
+    }
+}
+
+int main()
+{
+    TestBeginFrameWaitsForFence();
+    for (uint32_t depth = 1; depth <= MAX_FRAMES_IN_FLIGHT; depth++)
+        TestDepth(depth);
+    TestDepthIsClamped();
+    TestSetDepthDrainsFirst();
+    TestWaitIdleDrainsAllFrames();
+    return Test::Result("FrameRingTest");
+}
@@ -0,0 +1,127 @@
+// ResourcePool handles: stale handles stop resolving after Remove and after their slot is
+// reused, and removal keeps the remaining items reachable.
+#include "ResourcePool.h"
+#include "TestCheck.h"
+#include <memory>
+#include <string>
+
+namespace
+{
+    using StringPool = ResourcePool<std::string>;
+
+    void TestStaleHandleAfterRemove()
+    {
+        StringPool pool;
+        StringPool::Handle handle = pool.Add("first");
+        CHECK(handle);
+        CHECK(pool.IsValid(handle));
+        CHECK(*pool.Get(handle) == "first");
+
+        CHECK(pool.Remove(handle));
+        CHECK(!pool.IsValid(handle));
+        CHECK(pool.Get(handle) == nullptr);
+        CHECK(!pool.Remove(handle));
+        CHECK(pool.GetCount() == 0);
+    }
+
+    void TestStaleHandleAfterSlotReuse()
+    {
+        StringPool pool;
+        StringPool::Handle stale = pool.Add("old");
+        pool.Remove(stale);
+
+        // The freed slot is reused under a new generation
+        StringPool::Handle fresh = pool.Add("new");
+        CHECK(fresh.GetIndex() == stale.GetIndex());
+        CHECK(fresh.GetGeneration() != stale.GetGeneration());
+        CHECK(fresh != stale);
+        CHECK(pool.Get(stale) == nullptr);
+        CHECK(!pool.Remove(stale));
+        CHECK(pool.Get(fresh) && *pool.Get(fresh) == "new");
+    }
+
+    void TestGenerationWraps()
+    {
+        // Cycling one slot through every generation never issues 0 or revives a handle
+        StringPool pool;
+        StringPool::Handle first = pool.Add("item");
+        StringPool::Handle previous = first;
+        pool.Remove(first);
+        for (uint32_t i = 0; i < StringPool::Handle::GENERATION_MASK + 2; i++)
+        {
+            StringPool::Handle handle = pool.Add("item");
+            CHECK(handle);
+            CHECK(handle.GetIndex() == first.GetIndex());
+            CHECK(handle != previous);
+            CHECK(!pool.IsValid(previous));
+            pool.Remove(handle);
+            previous = handle;
+        }
+    }
+
+    void TestNullAndForeignHandles()
+    {
+        StringPool pool;
+        pool.Add("item");
+        CHECK(!pool.IsValid(StringPool::Handle()));
+        CHECK(pool.Get(StringPool::Handle()) == nullptr);
+
+        // An index past the slots in use
+        StringPool::Handle outOfRange;
+        outOfRange.value = (1u << StringPool::Handle::INDEX_BITS) | 5;
+        CHECK(!pool.IsValid(outOfRange));
+        CHECK(!pool.Remove(outOfRange));
+    }
+
+    void TestRemoveKeepsOthersReachable()
+    {
+        // Removal moves the last item into the hole; every other handle still resolves
+        StringPool pool;
+        StringPool::Handle handles[8];
+        for (int i = 0; i < 8; i++)
+            handles[i] = pool.Add(std::to_string(i));
+
+        for (int removed : { 0, 7, 3 })
+            CHECK(pool.Remove(handles[removed]));
+
+        CHECK(pool.GetCount() == 5);
+        for (int i = 0; i < 8; i++)
+        {
+            bool removed = i == 0 || i == 7 || i == 3;
+            CHECK(pool.IsValid(handles[i]) == !removed);
+            if (!removed)
+                CHECK(pool.Get(handles[i]) && *pool.Get(handles[i]) == std::to_string(i));
+        }
+
+        pool.Clear();
+        CHECK(pool.GetCount() == 0);
+        for (StringPool::Handle handle : handles)
+            CHECK(!pool.IsValid(handle));
+    }
+
+    void TestOwningPoolWithTag()
+    {
+        // The resource manager's layout: owned items, handles typed by the pointee
+        struct Font
+        {
+            int size;
+        };
+        ResourcePool<std::unique_ptr<Font>, Font> pool;
+        ResourceHandle<Font> handle = pool.Add(std::make_unique<Font>(Font{ 24 }));
+        CHECK((*pool.Get(handle))->size == 24);
+        pool.Remove(handle);
+        CHECK(pool.Get(pool.Add(std::make_unique<Font>(Font{ 120 }))) != nullptr);
+        CHECK(pool.Get(handle) == nullptr);
+    }
+}
+
+int main()
+{
+    TestStaleHandleAfterRemove();
+    TestStaleHandleAfterSlotReuse();
+    TestGenerationWraps();
+    TestNullAndForeignHandles();
+    TestRemoveKeepsOthersReachable();
+    TestOwningPoolWithTag();
+    return Test::Result("ResourcePoolTest");
+}
@@ -0,0 +1,244 @@
+// TaskScheduler cancellation: tasks waiting on async work, on a timer, on the next frame
+// and cancelling themselves, plus async errors surfacing at the co_await.
+#include "TaskScheduler.h"
+#include "TestCheck.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    // Records whether a task's frame was destroyed, and whether it ran past each await
+    struct Progress
+    {
+        bool started = false;
+        bool resumed = false;
+        bool destroyed = false;
+    };
+
+    // Work handed to RunAsync that blocks on a gate
+    struct GatedWork
+    {
+        std::shared_future<void> gate;
+        std::atomic<bool> started{ false };
+        std::atomic<bool> done{ false };
+
+        explicit GatedWork(std::shared_future<void> gate) : gate(std::move(gate)) {}
+
+        // Whether the worker picked it up within the wait
+        bool WaitStarted() const
+        {
+            auto deadline = std::chrono::steady_clock::now() + Test::FINISH_WAIT;
+            while (!started && std::chrono::steady_clock::now() < deadline)
+                std::this_thread::yield();
+            return started;
+        }
+    };
+
+    struct FrameGuard
+    {
+        Progress& progress;
+        ~FrameGuard() { progress.destroyed = true; }
+    };
+
+    Task WaitOnAsync(TaskScheduler& scheduler, GatedWork& gated, Progress& progress)
+    {
+        FrameGuard guard{ progress };
+        progress.started = true;
+        // A named local, not a temporary in the co_await: GCC 12 destroys those twice when
+        // the frame is destroyed at that suspension
+        std::function<void()> work = [&gated]
+        {
+            gated.started = true;
+            gated.gate.wait();
+            gated.done = true;
+        };
+        co_await scheduler.RunAsync(std::move(work));
+        progress.resumed = true;
+    }
+
+    Task WaitOnDelay(TaskScheduler& scheduler, uint64_t ticks, Progress& progress)
+    {
+        FrameGuard guard{ progress };
+        progress.started = true;
+        co_await scheduler.Delay(ticks);
+        progress.resumed = true;
+    }
+
+    Task CancelSelf(TaskScheduler& scheduler, const TaskScheduler::TaskId& self, Progress& progress)
+    {
+        FrameGuard guard{ progress };
+        progress.started = true;
+        co_await scheduler.NextFrame();
+        scheduler.Cancel(self);
+        co_await scheduler.NextFrame();
+        progress.resumed = true;
+    }
+
+    Task CatchAsyncError(TaskScheduler& scheduler, std::string& message)
+    {
+        try
+        {
+            co_await scheduler.RunAsync([] { throw std::runtime_error("async failure"); });
+        }
+        catch (const std::exception& e)
+        {
+            message = e.what();
+        }
+    }
+
+    // Run frames until the task is gone or the wait runs out
+    bool RunUntilFinished(TaskScheduler& scheduler, TaskScheduler::TaskId id)
+    {
+        auto deadline = std::chrono::steady_clock::now() + Test::FINISH_WAIT;
+        while (scheduler.IsAlive(id) && std::chrono::steady_clock::now() < deadline)
+        {
+            scheduler.RunFrame();
+            std::this_thread::yield();
+        }
+        return !scheduler.IsAlive(id);
+    }
+
+    void TestCancelWhileAsyncWorkRuns()
+    {
+        TimerWheel timers;
+        TaskScheduler scheduler(timers);
+        std::promise<void> gate;
+        GatedWork gated(gate.get_future().share());
+        Progress progress;
+        TaskScheduler::TaskId id = scheduler.Spawn(WaitOnAsync(scheduler, gated, progress));
+        CHECK(progress.started);
+
+        // The work still points into the frame, so it outlives the cancel
+        CHECK(gated.WaitStarted());
+        CHECK(scheduler.Cancel(id));
+        CHECK(scheduler.IsAlive(id));
+        scheduler.RunFrame();
+        CHECK(!progress.destroyed);
+
+        gate.set_value();
+        CHECK(RunUntilFinished(scheduler, id));
+        CHECK(gated.done);
+        CHECK(progress.destroyed);
+        CHECK(!progress.resumed);
+        CHECK(scheduler.GetTaskCount() == 0);
+        CHECK(!scheduler.Cancel(id));
+    }
+
+    void TestCancelWhileAsyncWorkQueued()
+    {
+        // The second task's work waits behind the first one's on the single worker
+        TimerWheel timers;
+        TaskScheduler scheduler(timers);
+        std::promise<void> gate;
+        std::shared_future<void> shared = gate.get_future().share();
+        GatedWork firstWork(shared);
+        GatedWork secondWork(shared);
+        Progress first;
+        Progress second;
+        TaskScheduler::TaskId firstId = scheduler.Spawn(WaitOnAsync(scheduler, firstWork, first));
+        TaskScheduler::TaskId secondId = scheduler.Spawn(WaitOnAsync(scheduler, secondWork, second));
+
+        CHECK(firstWork.WaitStarted());
+        CHECK(!secondWork.started);
+        CHECK(scheduler.Cancel(secondId));
+        CHECK(!second.destroyed);
+        gate.set_value();
+        CHECK(RunUntilFinished(scheduler, firstId));
+        CHECK(RunUntilFinished(scheduler, secondId));
+        CHECK(first.resumed);
+        CHECK(!second.resumed);
+        CHECK(second.destroyed);
+        CHECK(secondWork.done);
+    }
+
+    void TestCancelWhileDelayed()
+    {
+        TimerWheel timers;
+        TaskScheduler scheduler(timers);
+        Progress progress;
+        TaskScheduler::TaskId id = scheduler.Spawn(WaitOnDelay(scheduler, 10, progress));
+        CHECK(timers.GetActiveCount() == 1);
+
+        // Nothing is in flight, so the frame goes at once along with its timer
+        CHECK(scheduler.Cancel(id));
+        CHECK(progress.destroyed);
+        CHECK(!scheduler.IsAlive(id));
+        CHECK(timers.GetActiveCount() == 0);
+        timers.Advance(20);
+        CHECK(!progress.resumed);
+    }
+
+    void TestDelayResumes()
+    {
+        TimerWheel timers;
+        TaskScheduler scheduler(timers);
+        Progress progress;
+        TaskScheduler::TaskId id = scheduler.Spawn(WaitOnDelay(scheduler, 10, progress));
+        timers.Advance(9);
+        CHECK(!progress.resumed);
+        timers.Advance(1);
+        CHECK(progress.resumed);
+        CHECK(progress.destroyed);
+        CHECK(!scheduler.IsAlive(id));
+    }
+
+    void TestCancelSelf()
+    {
+        TimerWheel timers;
+        TaskScheduler scheduler(timers);
+        Progress progress;
+        TaskScheduler::TaskId id = TaskScheduler::INVALID_TASK;
+        id = scheduler.Spawn(CancelSelf(scheduler, id, progress));
+
+        // Destroyed at the suspension that follows the cancel, not inside it
+        scheduler.RunFrame();
+        CHECK(progress.destroyed);
+        CHECK(!progress.resumed);
+        CHECK(!scheduler.IsAlive(id));
+        scheduler.RunFrame();
+    }
+
+    void TestAsyncErrorReachesAwait()
+    {
+        TimerWheel timers;
+        TaskScheduler scheduler(timers);
+        std::string message;
+        TaskScheduler::TaskId id = scheduler.Spawn(CatchAsyncError(scheduler, message));
+        CHECK(RunUntilFinished(scheduler, id));
+        CHECK(message == "async failure");
+    }
+
+    void TestDestroyWithPendingWork()
+    {
+        // The destructor lets running work finish before freeing the frame it points into
+        Progress progress;
+        std::promise<void> gate;
+        GatedWork gated(gate.get_future().share());
+        {
+            TimerWheel timers;
+            TaskScheduler scheduler(timers);
+            scheduler.Spawn(WaitOnAsync(scheduler, gated, progress));
+            CHECK(gated.WaitStarted());
+            gate.set_value();
+        }
+        CHECK(gated.done);
+        CHECK(progress.destroyed);
+        CHECK(!progress.resumed);
+    }
+}
+
+int main()
+{
+    TestCancelWhileAsyncWorkRuns();
+    TestCancelWhileAsyncWorkQueued();
+    TestCancelWhileDelayed();
+    TestDelayResumes();
+    TestCancelSelf();
+    TestAsyncErrorReachesAwait();
+    TestDestroyWithPendingWork();
+    return Test::Result("TaskSchedulerTest");
+}
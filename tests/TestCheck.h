@@ -0,0 +1,40 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+
+// Minimal checks for the unit test executables. A failed CHECK prints the expression and
+// carries on; main returns Test::Result so CTest sees the failure.
+namespace Test
+{
+    // How long a call must stay blocked to count as waiting, and how long one that was
+    // released may take to return
+    const std::chrono::milliseconds BLOCK_WAIT(50);
+    const std::chrono::milliseconds FINISH_WAIT(5000);
+
+    inline int& GetFailureCount()
+    {
+        static int failures = 0;
+        return failures;
+    }
+
+    inline void Check(bool passed, const char* expression, const char* file, int line)
+    {
+        if (passed)
+            return;
+        printf("%s(%d): check failed: %s\n", file, line, expression);
+        GetFailureCount()++;
+    }
+
+    inline int Result(const char* name)
+    {
+        if (GetFailureCount() == 0)
+        {
+            printf("%s: all checks passed\n", name);
+            return 0;
+        }
+        printf("%s: %d checks failed\n", name, GetFailureCount());
+        return 1;
+    }
+}
+
+#define CHECK(expression) Test::Check(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
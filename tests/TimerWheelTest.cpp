@@ -0,0 +1,145 @@
+// TimerWheel deadlines across the level boundaries (256 and 65536 ticks and beyond), from
+// start ticks on either side of a wrap, and timers cancelling or rescheduling themselves.
+#include "TimerWheel.h"
+#include "TestCheck.h"
+#include <iterator>
+#include <vector>
+
+namespace
+{
+    // Delays around every level boundary the wheel cascades across
+    const uint64_t DELAYS[] = {
+        1, 2, 255, 256, 257, 511, 512, 1000,
+        65535, 65536, 65537, 65536 + 255, 65536 + 256, 131071, 131072, 200000,
+        16777215, 16777216, 16777217,
+    };
+
+    // Ticks to advance before scheduling, so deadlines straddle the wraps differently
+    const uint64_t START_TICKS[] = { 0, 1, 200, 255, 256, 65530, 65535, 65536 + 300 };
+
+    void TestDeadlinesAcrossLevels()
+    {
+        for (uint64_t start : START_TICKS)
+        {
+            TimerWheel wheel;
+            wheel.Advance(start);
+
+            const size_t count = std::size(DELAYS);
+            std::vector<uint64_t> fired(count, 0);
+            std::vector<int> firings(count, 0);
+            for (size_t i = 0; i < count; i++)
+            {
+                wheel.Schedule(DELAYS[i], [&wheel, &fired, &firings, i]
+                {
+                    fired[i] = wheel.GetCurrentTick();
+                    firings[i]++;
+                });
+            }
+
+            wheel.Advance(16777217 + 10);
+            for (size_t i = 0; i < count; i++)
+            {
+                CHECK(firings[i] == 1);
+                CHECK(fired[i] == start + DELAYS[i]);
+                if (fired[i] != start + DELAYS[i])
+                    printf("  start %llu, delay %llu fired at %llu\n", static_cast<unsigned long long>(start),
+                           static_cast<unsigned long long>(DELAYS[i]), static_cast<unsigned long long>(fired[i]));
+            }
+            CHECK(wheel.GetActiveCount() == 0);
+        }
+    }
+
+    void TestPeriodicAcrossLevels()
+    {
+        // Periods that keep the next deadline in a higher level, re-filed on every cascade
+        for (uint64_t period : { 255ull, 256ull, 300ull, 65536ull, 70000ull })
+        {
+            TimerWheel wheel;
+            wheel.Advance(100);
+            std::vector<uint64_t> fired;
+            wheel.SchedulePeriodic(period, [&] { fired.push_back(wheel.GetCurrentTick()); });
+
+            wheel.Advance(period * 5);
+            CHECK(fired.size() == 5);
+            for (size_t i = 0; i < fired.size(); i++)
+                CHECK(fired[i] == 100 + period * (i + 1));
+        }
+    }
+
+    void TestSelfCancel()
+    {
+        TimerWheel wheel;
+
+        // A periodic timer cancelling itself from its callback stops after that firing
+        int periodicFirings = 0;
+        TimerWheel::TimerId periodic = TimerWheel::INVALID_TIMER;
+        periodic = wheel.SchedulePeriodic(300, [&]
+        {
+            if (++periodicFirings == 3)
+                CHECK(wheel.Cancel(periodic));
+        });
+
+        // A one-shot timer is still live while its callback runs
+        bool oneShotCancelled = false;
+        TimerWheel::TimerId oneShot = TimerWheel::INVALID_TIMER;
+        oneShot = wheel.Schedule(65536 + 5, [&] { oneShotCancelled = wheel.Cancel(oneShot); });
+
+        wheel.Advance(300 * 10);
+        CHECK(periodicFirings == 3);
+        CHECK(!wheel.Cancel(periodic));
+
+        wheel.Advance(65536);
+        CHECK(oneShotCancelled);
+        CHECK(!wheel.Cancel(oneShot));
+        CHECK(wheel.GetActiveCount() == 0);
+
+        // The freed nodes are reused without reviving the old ids
+        int reusedFirings = 0;
+        TimerWheel::TimerId reused = wheel.Schedule(1, [&] { reusedFirings++; });
+        CHECK(reused != periodic && reused != oneShot);
+        CHECK(!wheel.Cancel(periodic));
+        wheel.Advance(1);
+        CHECK(reusedFirings == 1);
+    }
+
+    void TestCancelFromAnotherCallback()
+    {
+        // Due in the same tick: whichever runs first cancels the other, so exactly one fires
+        TimerWheel wheel;
+        int firings = 0;
+        TimerWheel::TimerId first = TimerWheel::INVALID_TIMER;
+        TimerWheel::TimerId second = TimerWheel::INVALID_TIMER;
+        first = wheel.Schedule(70000, [&] { firings++; wheel.Cancel(second); });
+        second = wheel.Schedule(70000, [&] { firings++; wheel.Cancel(first); });
+
+        wheel.Advance(70000);
+        CHECK(firings == 1);
+        CHECK(wheel.GetActiveCount() == 0);
+    }
+
+    void TestScheduleFromCallback()
+    {
+        // A callback scheduling a timer that lands back in a higher level
+        TimerWheel wheel;
+        std::vector<uint64_t> fired;
+        wheel.Schedule(250, [&]
+        {
+            fired.push_back(wheel.GetCurrentTick());
+            wheel.Schedule(65536, [&] { fired.push_back(wheel.GetCurrentTick()); });
+        });
+
+        wheel.Advance(250 + 65536);
+        CHECK(fired.size() == 2);
+        CHECK(fired.size() == 2 && fired[0] == 250 && fired[1] == 250 + 65536);
+    }
+}
+
+int main()
+{
+    TestDeadlinesAcrossLevels();
+    TestPeriodicAcrossLevels();
+    TestSelfCancel();
+    TestCancelFromAnotherCallback();
+    TestScheduleFromCallback();
+    return Test::Result("TimerWheelTest");
+}
@@ -0,0 +1,85 @@
+// AssetPacker - builds a single memory-mapped asset pack (.gepack) from loose asset files
+//
+// Usage: AssetPacker --out=<pack.gepack> <file>...
+//        AssetPacker --list <pack.gepack>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "AssetPack.h"
+
+namespace
+{
+    std::string GetOption(const std::string& arg, const std::string& prefix)
+    {
+        return arg.compare(0, prefix.size(), prefix) == 0 ? arg.substr(prefix.size()) : std::string();
+    }
+
+    void PrintUsage()
+    {
+        printf("Usage: AssetPacker --out=<pack.gepack> <file>...\n"
+               "       AssetPacker --list <pack.gepack>\n");
+    }
+
+    void ListPack(const std::wstring& fileName)
+    {
+        AssetPack pack;
+        pack.Open(fileName);
+
+        printf("%zu assets, %zu bytes\n", pack.GetEntryCount(), pack.GetSize());
+        for (size_t i = 0; i < pack.GetEntryCount(); i++)
+            printf("  %-40ls %10zu bytes\n", pack.GetName(i).c_str(), pack.GetAsset(i).size);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::string outPath;
+    std::vector<std::string> inputs;
+    bool list = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        std::string value;
+        if (!(value = GetOption(arg, "--out=")).empty())
+            outPath = value;
+        else if (arg == "--list")
+            list = true;
+        else if (arg.compare(0, 2, "--") == 0)
+        {
+            printf("Unknown option: %s\n", arg.c_str());
+            return 2;
+        }
+        else
+            inputs.push_back(arg);
+    }
+
+    if (list ? inputs.size() != 1 : outPath.empty() || inputs.empty())
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    try
+    {
+        if (list)
+        {
+            ListPack(std::filesystem::path(inputs[0]).wstring());
+            return 0;
+        }
+
+        AssetPackWriter writer;
+        for (const std::string& input : inputs)
+            writer.AddFile(std::filesystem::path(input).wstring());
+        writer.Write(std::filesystem::path(outPath).wstring());
+        printf("Packed %zu assets into %s\n", writer.GetCount(), outPath.c_str());
+    }
+    catch (const std::exception& e)
+    {
+        printf("AssetPacker failed: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,205 @@
+#include "JsonValue.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    class Parser
+    {
+    public:
+        explicit Parser(const std::string& text)
+            : m_text(text)
+            , m_pos(0)
+        {
+        }
+
+        JsonValue ParseDocument()
+        {
+            JsonValue value = ParseValue();
+            SkipWhitespace();
+            if (m_pos != m_text.size())
+                Fail("trailing characters");
+            return value;
+        }
+
+    private:
+        [[noreturn]] void Fail(const char* message) const
+        {
+            throw std::runtime_error(std::string("JSON parse error at offset ") +
+                                     std::to_string(m_pos) + ": " + message);
+        }
+
+        void SkipWhitespace()
+        {
+            while (m_pos < m_text.size() && (m_text[m_pos] == ' ' || m_text[m_pos] == '\t' ||
+                                             m_text[m_pos] == '\n' || m_text[m_pos] == '\r'))
+                m_pos++;
+        }
+
+        bool Consume(char c)
+        {
+            SkipWhitespace();
+            if (m_pos < m_text.size() && m_text[m_pos] == c)
+            {
+                m_pos++;
+                return true;
+            }
+            return false;
+        }
+
+        void Expect(char c)
+        {
+            if (!Consume(c))
+                Fail((std::string("expected '") + c + "'").c_str());
+        }
+
+        bool ConsumeLiteral(const char* literal)
+        {
+            size_t length = strlen(literal);
+            if (m_text.compare(m_pos, length, literal) != 0)
+                return false;
+            m_pos += length;
+            return true;
+        }
+
+        JsonValue ParseValue()
+        {
+            SkipWhitespace();
+            if (m_pos >= m_text.size())
+                Fail("unexpected end of input");
+
+            JsonValue value;
+            char c = m_text[m_pos];
+            if (c == '{')
+            {
+                m_pos++;
+                value.type = JsonValue::Type::Object;
+                if (Consume('}'))
+                    return value;
+                do
+                {
+                    SkipWhitespace();
+                    std::string key = ParseString();
+                    Expect(':');
+                    value.object[key] = ParseValue();
+                } while (Consume(','));
+                Expect('}');
+            }
+            else if (c == '[')
+            {
+                m_pos++;
+                value.type = JsonValue::Type::Array;
+                if (Consume(']'))
+                    return value;
+                do
+                {
+                    value.array.push_back(ParseValue());
+                } while (Consume(','));
+                Expect(']');
+            }
+            else if (c == '"')
+            {
+                value.type = JsonValue::Type::String;
+                value.string = ParseString();
+            }
+            else if (ConsumeLiteral("true"))
+            {
+                value.type = JsonValue::Type::Bool;
+                value.boolean = true;
+            }
+            else if (ConsumeLiteral("false"))
+            {
+                value.type = JsonValue::Type::Bool;
+            }
+            else if (ConsumeLiteral("null"))
+            {
+            }
+            else
+            {
+                const char* start = m_text.c_str() + m_pos;
+                char* end = nullptr;
+                value.type = JsonValue::Type::Number;
+                value.number = strtod(start, &end);
+                if (end == start)
+                    Fail("unexpected character");
+                m_pos += end - start;
+            }
+            return value;
+        }
+
+        std::string ParseString()
+        {
+            if (m_pos >= m_text.size() || m_text[m_pos] != '"')
+                Fail("expected string");
+            m_pos++;
+
+            std::string result;
+            while (m_pos < m_text.size() && m_text[m_pos] != '"')
+            {
+                char c = m_text[m_pos++];
+                if (c != '\\')
+                {
+                    result += c;
+                    continue;
+                }
+                if (m_pos >= m_text.size())
+                    break;
+
+                char escape = m_text[m_pos++];
+                switch (escape)
+                {
+                case 'n': result += '\n'; break;
+                case 't': result += '\t'; break;
+                case 'r': result += '\r'; break;
+                case 'b': result += '\b'; break;
+                case 'f': result += '\f'; break;
+                case 'u':
+                    // Benchmark names are ASCII; keep other code points as '?'
+                    if (m_pos + 4 > m_text.size())
+                        Fail("truncated \\u escape");
+                    {
+                        unsigned long code = strtoul(m_text.substr(m_pos, 4).c_str(), nullptr, 16);
+                        result += code < 0x80 ? static_cast<char>(code) : '?';
+                    }
+                    m_pos += 4;
+                    break;
+                default: result += escape; break;
+                }
+            }
+            if (m_pos >= m_text.size())
+                Fail("unterminated string");
+            m_pos++;
+            return result;
+        }
+
+        const std::string& m_text;
+        size_t m_pos;
+    };
+}
+
+const JsonValue* JsonValue::Find(const std::string& key) const
+{
+    if (type != Type::Object)
+        return nullptr;
+    auto it = object.find(key);
+    return it != object.end() ? &it->second : nullptr;
+}
+
+JsonValue JsonValue::Parse(const std::string& text)
+{
+    return Parser(text).ParseDocument();
+}
+
+JsonValue JsonValue::Load(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        throw std::runtime_error("Failed to open " + path);
+
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return Parse(contents.str());
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+
+// Small JSON document model, enough to read GraphicsEngineBench result files
+struct JsonValue
+{
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::map<std::string, JsonValue> object;
+
+    // Member lookup; returns nullptr if this is not an object or the key is absent
+    const JsonValue* Find(const std::string& key) const;
+
+    // Parse a complete document. Throws std::runtime_error with the offset on bad input.
+    static JsonValue Parse(const std::string& text);
+
+    // Read and parse a file. Throws std::runtime_error on failure.
+    static JsonValue Load(const std::string& path);
+};
@@ -0,0 +1,124 @@
+#include "Statistics.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+namespace Statistics
+{
+    double Median(std::vector<double> values)
+    {
+        if (values.empty())
+            return 0.0;
+
+        std::sort(values.begin(), values.end());
+        size_t n = values.size();
+        return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2.0;
+    }
+
+    double RelativeStdDev(const std::vector<double>& values)
+    {
+        if (values.size() < 2)
+            return 0.0;
+
+        double mean = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+        double variance = 0.0;
+        for (double value : values)
+            variance += (value - mean) * (value - mean);
+        variance /= values.size() - 1;
+        return mean > 0.0 ? std::sqrt(variance) / mean : 0.0;
+    }
+
+    double MannWhitneyPValue(const std::vector<double>& a, const std::vector<double>& b)
+    {
+        const size_t n1 = a.size();
+        const size_t n2 = b.size();
+        if (n1 == 0 || n2 == 0)
+            return 1.0;
+
+        // Rank the pooled samples, giving ties their average rank
+        std::vector<std::pair<double, int>> pooled;
+        pooled.reserve(n1 + n2);
+        for (double value : a)
+            pooled.push_back({ value, 0 });
+        for (double value : b)
+            pooled.push_back({ value, 1 });
+        std::sort(pooled.begin(), pooled.end());
+
+        const double n = static_cast<double>(n1 + n2);
+        double rankSumA = 0.0;
+        double tieTerm = 0.0;
+        for (size_t i = 0; i < pooled.size();)
+        {
+            size_t j = i;
+            while (j < pooled.size() && pooled[j].first == pooled[i].first)
+                j++;
+
+            double averageRank = (i + 1 + j) / 2.0;
+            for (size_t k = i; k < j; k++)
+            {
+                if (pooled[k].second == 0)
+                    rankSumA += averageRank;
+            }
+
+            double tied = static_cast<double>(j - i);
+            tieTerm += tied * tied * tied - tied;
+            i = j;
+        }
+
+        const double u = rankSumA - n1 * (n1 + 1) / 2.0;
+        const double meanU = n1 * n2 / 2.0;
+        const double varianceU = n1 * n2 / 12.0 * ((n + 1.0) - tieTerm / (n * (n - 1.0)));
+        if (varianceU <= 0.0)
+            return 1.0;
+
+        // Continuity-corrected z score, two-sided
+        double z = (std::abs(u - meanU) - 0.5) / std::sqrt(varianceU);
+        if (z < 0.0)
+            z = 0.0;
+        return std::erfc(z / std::sqrt(2.0));
+    }
+
+    double MannWhitneyMinPValue(size_t sizeA, size_t sizeB)
+    {
+        std::vector<double> a(sizeA), b(sizeB);
+        std::iota(a.begin(), a.end(), 0.0);
+        std::iota(b.begin(), b.end(), static_cast<double>(sizeA));
+        return MannWhitneyPValue(a, b);
+    }
+
+    Interval BootstrapMedianChange(const std::vector<double>& a, const std::vector<double>& b,
+                                   int resamples, double confidence, uint32_t seed)
+    {
+        if (a.empty() || b.empty() || resamples <= 0)
+            return { 0.0, 0.0 };
+
+        std::mt19937 rng(seed);
+        std::vector<double> resampleA(a.size()), resampleB(b.size());
+        std::vector<double> changes;
+        changes.reserve(resamples);
+
+        for (int i = 0; i < resamples; i++)
+        {
+            // Scaled integer draws instead of uniform_int_distribution, whose output
+            // differs between standard libraries
+            for (double& value : resampleA)
+                value = a[static_cast<size_t>((static_cast<uint64_t>(rng()) * a.size()) >> 32)];
+            for (double& value : resampleB)
+                value = b[static_cast<size_t>((static_cast<uint64_t>(rng()) * b.size()) >> 32)];
+
+            double baseline = Median(resampleA);
+            if (baseline > 0.0)
+                changes.push_back(Median(resampleB) / baseline - 1.0);
+        }
+
+        if (changes.empty())
+            return { 0.0, 0.0 };
+
+        std::sort(changes.begin(), changes.end());
+        double tail = (1.0 - confidence) / 2.0;
+        size_t lowIndex = static_cast<size_t>(tail * (changes.size() - 1));
+        size_t highIndex = static_cast<size_t>((1.0 - tail) * (changes.size() - 1) + 0.5);
+        return { changes[lowIndex], changes[std::min(highIndex, changes.size() - 1)] };
+    }
+}
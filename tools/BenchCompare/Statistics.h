@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Two-sample statistics for comparing benchmark timings
+namespace Statistics
+{
+    double Median(std::vector<double> values);
+
+    // Coefficient of variation (sample stddev / mean)
+    double RelativeStdDev(const std::vector<double>& values);
+
+    // Two-sided Mann-Whitney U test (normal approximation with tie correction).
+    // Returns the p-value for "both samples come from the same distribution".
+    double MannWhitneyPValue(const std::vector<double>& a, const std::vector<double>& b);
+
+    // Smallest p-value the Mann-Whitney test can produce for these sample sizes
+    double MannWhitneyMinPValue(size_t sizeA, size_t sizeB);
+
+    struct Interval
+    {
+        double low;
+        double high;
+    };
+
+    // Percentile bootstrap confidence interval of median(b) / median(a) - 1.
+    // Deterministic for a given seed so reruns of a comparison agree.
+    Interval BootstrapMedianChange(const std::vector<double>& a, const std::vector<double>& b,
+                                   int resamples, double confidence, uint32_t seed = 12345);
+}
@@ -0,0 +1,215 @@
+// BenchCompare - compares two GraphicsEngineBench JSON result files.
+//
+// Usage: BenchCompare <baseline.json> <candidate.json> [--threshold=PERCENT] [--alpha=P]
+//                     [--confidence=C] [--resamples=N] [--noise=PERCENT] [--filter=TEXT]
+//
+// For every benchmark present in both files the per-repetition samples are compared with
+// a Mann-Whitney U test and a bootstrap confidence interval of the median change. A change
+// is only reported as a regression or improvement when it is statistically significant
+// and larger than the threshold (default 3%). Exits with 1 if any benchmark regressed.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "JsonValue.h"
+#include "Statistics.h"
+
+namespace
+{
+    struct Options
+    {
+        double threshold = 0.03;    // Relative change that counts as a regression
+        double alpha = 0.05;        // Significance level for the Mann-Whitney test
+        double confidence = 0.95;   // Bootstrap interval coverage
+        int resamples = 2000;
+        double noise = 0.05;        // Relative stddev above which a run is reported as noisy
+        std::string filter;
+    };
+
+    struct Benchmark
+    {
+        std::string name;
+        std::vector<double> samples;
+    };
+
+    // Benchmarks in file order with their per-repetition samples
+    std::vector<Benchmark> LoadResults(const std::string& path)
+    {
+        JsonValue document = JsonValue::Load(path);
+        const JsonValue* benchmarks = document.Find("benchmarks");
+        if (!benchmarks || benchmarks->type != JsonValue::Type::Array)
+            throw std::runtime_error(path + " has no \"benchmarks\" array");
+
+        std::vector<Benchmark> results;
+        for (const JsonValue& entry : benchmarks->array)
+        {
+            const JsonValue* name = entry.Find("name");
+            const JsonValue* samples = entry.Find("samples_ns");
+            if (!name || name->type != JsonValue::Type::String ||
+                !samples || samples->type != JsonValue::Type::Array)
+                throw std::runtime_error(path + " has a benchmark without name or samples_ns");
+
+            Benchmark benchmark;
+            benchmark.name = name->string;
+            for (const JsonValue& sample : samples->array)
+                benchmark.samples.push_back(sample.number);
+            results.push_back(std::move(benchmark));
+        }
+        return results;
+    }
+
+    std::string FormatTime(double ns)
+    {
+        char buffer[32];
+        if (ns >= 1e6)
+            snprintf(buffer, sizeof(buffer), "%.3f ms", ns / 1e6);
+        else if (ns >= 1e3)
+            snprintf(buffer, sizeof(buffer), "%.3f us", ns / 1e3);
+        else
+            snprintf(buffer, sizeof(buffer), "%.1f ns", ns);
+        return buffer;
+    }
+
+    std::string GetOption(const std::string& arg, const std::string& prefix)
+    {
+        return arg.compare(0, prefix.size(), prefix) == 0 ? arg.substr(prefix.size()) : std::string();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        printf("Usage: BenchCompare <baseline.json> <candidate.json> [--threshold=PERCENT] [--alpha=P]\n"
+               "                    [--confidence=C] [--resamples=N] [--noise=PERCENT] [--filter=TEXT]\n");
+        return 2;
+    }
+
+    Options options;
+    for (int i = 3; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        std::string value;
+        if (!(value = GetOption(arg, "--threshold=")).empty())
+            options.threshold = atof(value.c_str()) / 100.0;
+        else if (!(value = GetOption(arg, "--alpha=")).empty())
+            options.alpha = atof(value.c_str());
+        else if (!(value = GetOption(arg, "--confidence=")).empty())
+            options.confidence = std::clamp(atof(value.c_str()), 0.5, 0.999);
+        else if (!(value = GetOption(arg, "--resamples=")).empty())
+            options.resamples = std::max(100, atoi(value.c_str()));
+        else if (!(value = GetOption(arg, "--noise=")).empty())
+            options.noise = atof(value.c_str()) / 100.0;
+        else if (!(value = GetOption(arg, "--filter=")).empty())
+            options.filter = value;
+        else
+        {
+            printf("Unknown option: %s\n", arg.c_str());
+            return 2;
+        }
+    }
+
+    std::vector<Benchmark> baseline, candidate;
+    try
+    {
+        baseline = LoadResults(argv[1]);
+        candidate = LoadResults(argv[2]);
+    }
+    catch (const std::exception& e)
+    {
+        printf("Error: %s\n", e.what());
+        return 2;
+    }
+
+    std::map<std::string, const Benchmark*> candidateByName;
+    for (const Benchmark& benchmark : candidate)
+        candidateByName[benchmark.name] = &benchmark;
+
+    int regressions = 0;
+    int improvements = 0;
+    int compared = 0;
+    std::vector<std::string> underpowered;
+
+    printf("%-52s %12s %12s %8s %18s %8s  %s\n", "Benchmark", "Baseline", "Candidate",
+           "Change", "CI", "p", "Verdict");
+
+    for (const Benchmark& before : baseline)
+    {
+        if (!options.filter.empty() && before.name.find(options.filter) == std::string::npos)
+            continue;
+
+        auto match = candidateByName.find(before.name);
+        if (match == candidateByName.end())
+        {
+            printf("%-52s %12s\n", before.name.c_str(), "(missing in candidate)");
+            continue;
+        }
+
+        const Benchmark& after = *match->second;
+        candidateByName.erase(match);
+        compared++;
+
+        double medianBefore = Statistics::Median(before.samples);
+        double medianAfter = Statistics::Median(after.samples);
+        double change = medianBefore > 0.0 ? medianAfter / medianBefore - 1.0 : 0.0;
+        double p = Statistics::MannWhitneyPValue(before.samples, after.samples);
+        Statistics::Interval interval = Statistics::BootstrapMedianChange(
+            before.samples, after.samples, options.resamples, options.confidence);
+        double noise = std::max(Statistics::RelativeStdDev(before.samples),
+                                Statistics::RelativeStdDev(after.samples));
+
+        if (Statistics::MannWhitneyMinPValue(before.samples.size(), after.samples.size()) >= options.alpha)
+            underpowered.push_back(before.name);
+
+        // Significant only if the rank test rejects and the interval excludes zero
+        bool significant = p < options.alpha && (interval.low > 0.0 || interval.high < 0.0);
+        const char* verdict;
+        if (significant && change > options.threshold)
+        {
+            verdict = "REGRESSION";
+            regressions++;
+        }
+        else if (significant && change < -options.threshold)
+        {
+            verdict = "improved";
+            improvements++;
+        }
+        else if (significant)
+            verdict = "below threshold";
+        else if (interval.high - interval.low > 2.0 * options.threshold || noise > options.noise)
+            verdict = "noisy";      // Too much spread to resolve a change of threshold size
+        else
+            verdict = "no change";
+
+        char changeText[16], intervalText[32];
+        snprintf(changeText, sizeof(changeText), "%+.1f%%", change * 100.0);
+        snprintf(intervalText, sizeof(intervalText), "[%+.1f%%, %+.1f%%]",
+                 interval.low * 100.0, interval.high * 100.0);
+
+        printf("%-52s %12s %12s %8s %18s %8.4f  %s\n", before.name.c_str(),
+               FormatTime(medianBefore).c_str(), FormatTime(medianAfter).c_str(),
+               changeText, intervalText, p, verdict);
+    }
+
+    for (const auto& entry : candidateByName)
+    {
+        if (options.filter.empty() || entry.first.find(options.filter) != std::string::npos)
+            printf("%-52s %12s\n", entry.first.c_str(), "(new in candidate)");
+    }
+
+    printf("\n%d compared, %d regressions, %d improvements (threshold %.1f%%, alpha %.3f, %.0f%% CI)\n",
+           compared, regressions, improvements, options.threshold * 100.0, options.alpha,
+           options.confidence * 100.0);
+
+    if (!underpowered.empty())
+    {
+        printf("Warning: %zu benchmarks have too few samples for the test to reach p < %.3f; "
+               "rerun GraphicsEngineBench with more --repetitions\n", underpowered.size(), options.alpha);
+    }
+
+    return regressions > 0 ? 1 : 0;
+}
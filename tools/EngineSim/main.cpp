@@ -0,0 +1,137 @@
+// EngineSim - runs the Engine against a VirtualClock as fast as the CPU allows.
+//
+// Usage: EngineSim [--frames=N] [--step-ms=MS] [--seed=N] [--render=none|changed|all]
+//                  [--width=W] [--height=H]
+//
+// Every frame advances engine time by a fixed step and calls Update(); rendering goes to a
+// headless software renderer. For a given seed and step the sequence of random numbers is
+// fully deterministic, and its checksum is printed so soak runs can be compared.
+#include <windows.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include "Clock.h"
+#include "Engine.h"
+#include "SoftwareRenderer.h"
+
+namespace
+{
+    enum class RenderMode
+    {
+        None,       // Update only
+        Changed,    // Render after updates that changed the number
+        All,        // Render every frame
+    };
+
+    std::string GetOption(const std::string& arg, const std::string& prefix)
+    {
+        return arg.compare(0, prefix.size(), prefix) == 0 ? arg.substr(prefix.size()) : std::string();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    uint64_t frames = 1000000;
+    double stepMs = 1000.0 / 60.0;
+    uint32_t seed = 1;
+    RenderMode renderMode = RenderMode::Changed;
+    UINT width = 1280;
+    UINT height = 720;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        std::string value;
+        if (!(value = GetOption(arg, "--frames=")).empty())
+            frames = strtoull(value.c_str(), nullptr, 10);
+        else if (!(value = GetOption(arg, "--step-ms=")).empty())
+            stepMs = atof(value.c_str());
+        else if (!(value = GetOption(arg, "--seed=")).empty())
+            seed = static_cast<uint32_t>(strtoul(value.c_str(), nullptr, 10));
+        else if (!(value = GetOption(arg, "--width=")).empty())
+            width = static_cast<UINT>(atoi(value.c_str()));
+        else if (!(value = GetOption(arg, "--height=")).empty())
+            height = static_cast<UINT>(atoi(value.c_str()));
+        else if (arg == "--render=none")
+            renderMode = RenderMode::None;
+        else if (arg == "--render=changed")
+            renderMode = RenderMode::Changed;
+        else if (arg == "--render=all")
+            renderMode = RenderMode::All;
+        else
+        {
+            printf("Unknown option: %s\n", arg.c_str());
+            return 2;
+        }
+    }
+
+    if (stepMs <= 0.0 || width == 0 || height == 0)
+    {
+        printf("Step, width and height must be positive\n");
+        return 2;
+    }
+
+    auto clock = std::make_shared<VirtualClock>();
+    const IClock::Duration step = std::chrono::duration_cast<IClock::Duration>(
+        std::chrono::duration<double, std::milli>(stepMs));
+
+    try
+    {
+        Engine engine(width, height, clock);
+        engine.SetSeed(seed);
+        engine.Initialize(nullptr, std::make_unique<SoftwareRenderer>());
+        engine.Render();
+
+        // FNV-1a over the number sequence
+        uint64_t checksum = 1469598103934665603ull;
+        uint64_t rendered = 1;
+        auto start = std::chrono::steady_clock::now();
+
+        for (uint64_t frame = 0; frame < frames; frame++)
+        {
+            clock->Advance(step);
+
+            uint64_t updatesBefore = engine.GetUpdateCount();
+            engine.Update();
+            bool changed = engine.GetUpdateCount() != updatesBefore;
+
+            if (changed)
+            {
+                checksum = (checksum ^ static_cast<uint64_t>(engine.GetRandomNumber())) * 1099511628211ull;
+            }
+
+            if (renderMode == RenderMode::All || (renderMode == RenderMode::Changed && changed))
+            {
+                engine.Render();
+                rendered++;
+            }
+        }
+
+        double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double engineSeconds = std::chrono::duration<double>(clock->Now()).count();
+
+        printf("Frames:       %llu (%.3f ms steps)\n", static_cast<unsigned long long>(frames), stepMs);
+        printf("Engine time:  %.1f s\n", engineSeconds);
+        printf("Wall time:    %.3f s (%.0fx real time, %.0f frames/s)\n", wallSeconds,
+               wallSeconds > 0.0 ? engineSeconds / wallSeconds : 0.0,
+               wallSeconds > 0.0 ? frames / wallSeconds : 0.0);
+        printf("Updates:      %llu (%llu fixed steps, %.3f s dropped by the catch-up cap)\n",
+               static_cast<unsigned long long>(engine.GetUpdateCount()),
+               static_cast<unsigned long long>(engine.GetStepCount()),
+               std::chrono::duration<double>(engine.GetDroppedTime()).count());
+        printf("Rendered:     %llu frames\n", static_cast<unsigned long long>(rendered));
+        printf("Final number: %d\n", engine.GetRandomNumber());
+        printf("Checksum:     %016llx\n", static_cast<unsigned long long>(checksum));
+
+        engine.OnDestroy();
+    }
+    catch (const std::exception& e)
+    {
+        printf("Simulation failed: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
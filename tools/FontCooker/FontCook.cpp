@@ -0,0 +1,251 @@
+#include "FontCook.h"
+#include "CoverageAtlas.h"
+#include "SkylinePacker.h"
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <stdexcept>
+
+namespace
+{
+    // DXGI_FORMAT values used by MakeSpriteFont
+    const uint32_t FORMAT_R8G8B8A8_UNORM = 28;
+    const uint32_t FORMAT_BC2_UNORM = 74;
+    const uint32_t FORMAT_B8G8R8A8_UNORM = 87;
+    const uint32_t FORMAT_B4G4R4A4_UNORM = 115;
+
+    // D3D12_REQ_TEXTURE2D_U_OR_V_DIMENSION
+    const uint32_t MAX_TEXTURE_SIZE = 16384;
+
+    uint32_t AlignUp(uint32_t value, uint32_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    uint32_t ToNibble(uint8_t alpha)
+    {
+        return (alpha + 8) / 17;
+    }
+
+    struct Placement
+    {
+        uint32_t x;
+        uint32_t y;
+    };
+
+    // Pack the glyphs (in order) at one atlas width; false if they do not fit
+    bool PackAtWidth(const std::vector<SpriteFontGlyph>& glyphs, const std::vector<size_t>& order,
+                     uint32_t width, uint32_t padding, std::vector<Placement>& placements, uint32_t& usedHeight)
+    {
+        // The atlas has a border of padding on the left and top; each glyph reserves the
+        // padding to its right and below
+        SkylinePacker packer(width - padding, MAX_TEXTURE_SIZE - padding);
+        placements.resize(glyphs.size());
+        for (size_t index : order)
+        {
+            const SpriteFontGlyph& glyph = glyphs[index];
+            if (glyph.right == glyph.left || glyph.bottom == glyph.top)
+            {
+                placements[index] = { padding, padding };
+                continue;
+            }
+
+            uint32_t x, y;
+            if (!packer.Insert(glyph.right - glyph.left + padding, glyph.bottom - glyph.top + padding, x, y))
+                return false;
+            placements[index] = { x + padding, y + padding };
+        }
+        usedHeight = packer.GetUsedHeight() + padding;
+        return true;
+    }
+
+    // Encode an 8-bit coverage image in a sprite font texture format, as white with
+    // premultiplied alpha like MakeSpriteFont writes it
+    void EncodeTexture(const std::vector<uint8_t>& coverage, SpriteFontData& font)
+    {
+        const uint32_t width = font.textureWidth;
+        const uint32_t height = font.textureHeight;
+        auto at = [&](uint32_t x, uint32_t y) { return coverage[static_cast<size_t>(y) * width + x]; };
+
+        switch (font.textureFormat)
+        {
+        case FORMAT_BC2_UNORM:
+        {
+            // 4-bit explicit alpha, then BC1 color between white and black. The color
+            // index is the palette entry nearest the alpha: 0 = white, 1 = black,
+            // 2 = two thirds, 3 = one third.
+            static const uint32_t COLOR_INDEX[4] = { 1, 3, 2, 0 };
+            const uint32_t blocksWide = width / 4;
+            font.textureStride = blocksWide * 16;
+            font.textureRows = height / 4;
+            font.textureData.assign(static_cast<size_t>(font.textureStride) * font.textureRows, 0);
+
+            for (uint32_t by = 0; by < font.textureRows; by++)
+            {
+                uint8_t* block = font.textureData.data() + static_cast<size_t>(by) * font.textureStride;
+                for (uint32_t bx = 0; bx < blocksWide; bx++, block += 16)
+                {
+                    uint64_t alphaBits = 0;
+                    uint32_t colorBits = 0;
+                    for (uint32_t pixel = 0; pixel < 16; pixel++)
+                    {
+                        uint32_t nibble = ToNibble(at(bx * 4 + pixel % 4, by * 4 + pixel / 4));
+                        alphaBits |= static_cast<uint64_t>(nibble) << (pixel * 4);
+                        colorBits |= COLOR_INDEX[(nibble * 3 + 7) / 15] << (pixel * 2);
+                    }
+                    for (uint32_t i = 0; i < 8; i++)
+                        block[i] = static_cast<uint8_t>(alphaBits >> (i * 8));
+                    block[8] = 0xFF;
+                    block[9] = 0xFF;
+                    for (uint32_t i = 0; i < 4; i++)
+                        block[12 + i] = static_cast<uint8_t>(colorBits >> (i * 8));
+                }
+            }
+            break;
+        }
+
+        case FORMAT_R8G8B8A8_UNORM:
+        case FORMAT_B8G8R8A8_UNORM:
+            font.textureStride = width * 4;
+            font.textureRows = height;
+            font.textureData.resize(static_cast<size_t>(font.textureStride) * height);
+            for (size_t i = 0; i < coverage.size(); i++)
+                std::fill_n(font.textureData.data() + i * 4, 4, coverage[i]);
+            break;
+
+        case FORMAT_B4G4R4A4_UNORM:
+            font.textureStride = width * 2;
+            font.textureRows = height;
+            font.textureData.resize(static_cast<size_t>(font.textureStride) * height);
+            for (size_t i = 0; i < coverage.size(); i++)
+            {
+                uint8_t nibble = static_cast<uint8_t>(ToNibble(coverage[i]));
+                font.textureData[i * 2] = static_cast<uint8_t>(nibble | (nibble << 4));
+                font.textureData[i * 2 + 1] = font.textureData[i * 2];
+            }
+            break;
+
+        default:
+            throw std::runtime_error("Unsupported sprite font texture format");
+        }
+    }
+}
+
+SpriteFontData CookFont(const SpriteFontData& source, const CookOptions& options)
+{
+    // Decoding first also rejects fonts without a texture or in an unknown format
+    CoverageAtlas atlas = CoverageAtlas::FromSpriteFont(source, CoverageEncoding::Dense);
+
+    SpriteFontData font;
+    font.lineSpacing = source.lineSpacing;
+    font.defaultCharacter = source.defaultCharacter;
+    font.textureFormat = source.textureFormat;
+
+    std::vector<uint32_t> characters = options.characters;
+    if (!characters.empty() && source.defaultCharacter)
+        characters.push_back(source.defaultCharacter);
+    std::sort(characters.begin(), characters.end());
+    characters.erase(std::unique(characters.begin(), characters.end()), characters.end());
+
+    if (characters.empty())
+    {
+        font.glyphs = source.glyphs;
+    }
+    else
+    {
+        for (uint32_t character : characters)
+        {
+            auto glyph = std::lower_bound(source.glyphs.begin(), source.glyphs.end(), character,
+                [](const SpriteFontGlyph& g, uint32_t c) { return g.character < c; });
+            if (glyph == source.glyphs.end() || glyph->character != character)
+            {
+                char message[64];
+                snprintf(message, sizeof(message), "Font has no glyph for U+%04X", character);
+                throw std::runtime_error(message);
+            }
+            font.glyphs.push_back(*glyph);
+        }
+    }
+
+    for (const SpriteFontGlyph& glyph : font.glyphs)
+    {
+        if (glyph.left < 0 || glyph.top < 0 || glyph.right < glyph.left || glyph.bottom < glyph.top ||
+            static_cast<uint32_t>(glyph.right) > source.textureWidth ||
+            static_cast<uint32_t>(glyph.bottom) > source.textureHeight)
+            throw std::runtime_error("Sprite font glyph lies outside its texture");
+    }
+
+    // Tallest first, then widest, so each skyline row fills with glyphs of similar height
+    std::vector<size_t> order(font.glyphs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+    {
+        const SpriteFontGlyph& ga = font.glyphs[a];
+        const SpriteFontGlyph& gb = font.glyphs[b];
+        int32_t ha = ga.bottom - ga.top, hb = gb.bottom - gb.top;
+        if (ha != hb)
+            return ha > hb;
+        return ga.right - ga.left > gb.right - gb.left;
+    });
+
+    // BC2 textures are whole 4x4 blocks
+    const uint32_t alignment = font.textureFormat == FORMAT_BC2_UNORM ? 4 : 1;
+    const uint32_t padding = options.padding;
+
+    uint32_t widest = 0, totalWidth = 0;
+    for (const SpriteFontGlyph& glyph : font.glyphs)
+    {
+        widest = std::max<uint32_t>(widest, glyph.right - glyph.left);
+        totalWidth += glyph.right - glyph.left + padding;
+    }
+
+    // Try every width from the widest glyph to a single row and keep the smallest area,
+    // the squarer atlas on a tie
+    std::vector<Placement> placements, bestPlacements;
+    uint32_t bestWidth = 0, bestHeight = 0;
+    uint64_t bestArea = UINT64_MAX;
+    uint32_t lastWidth = std::min(AlignUp(totalWidth + padding, alignment), MAX_TEXTURE_SIZE);
+    for (uint32_t width = AlignUp(std::max(widest + 2 * padding, 1u), alignment); width <= lastWidth; width += alignment)
+    {
+        uint32_t usedHeight;
+        if (!PackAtWidth(font.glyphs, order, width, padding, placements, usedHeight))
+            continue;
+
+        uint32_t height = AlignUp(std::max(usedHeight, 1u), alignment);
+        uint64_t area = static_cast<uint64_t>(width) * height;
+        if (area < bestArea || (area == bestArea && std::max(width, height) < std::max(bestWidth, bestHeight)))
+        {
+            bestArea = area;
+            bestWidth = width;
+            bestHeight = height;
+            bestPlacements.swap(placements);
+        }
+    }
+    if (bestArea == UINT64_MAX)
+        throw std::runtime_error("Glyphs do not fit in the largest texture");
+
+    font.textureWidth = bestWidth;
+    font.textureHeight = bestHeight;
+
+    // Move every glyph's coverage to its new place
+    std::vector<uint8_t> coverage(static_cast<size_t>(bestWidth) * bestHeight, 0);
+    for (size_t i = 0; i < font.glyphs.size(); i++)
+    {
+        SpriteFontGlyph& glyph = font.glyphs[i];
+        uint32_t width = glyph.right - glyph.left;
+        uint32_t height = glyph.bottom - glyph.top;
+        for (uint32_t row = 0; row < height; row++)
+        {
+            const uint8_t* from = atlas.data.data() + static_cast<size_t>(glyph.top + row) * atlas.width + glyph.left;
+            std::copy_n(from, width, coverage.data() + static_cast<size_t>(bestPlacements[i].y + row) * bestWidth + bestPlacements[i].x);
+        }
+
+        glyph.left = static_cast<int32_t>(bestPlacements[i].x);
+        glyph.top = static_cast<int32_t>(bestPlacements[i].y);
+        glyph.right = glyph.left + static_cast<int32_t>(width);
+        glyph.bottom = glyph.top + static_cast<int32_t>(height);
+    }
+
+    EncodeTexture(coverage, font);
+    return font;
+}
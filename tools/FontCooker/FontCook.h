@@ -0,0 +1,16 @@
+#pragma once
+#include "SpriteFontFile.h"
+#include <cstdint>
+#include <vector>
+
+struct CookOptions
+{
+    std::vector<uint32_t> characters;   // Glyphs to keep; empty keeps them all
+    uint32_t padding = 1;               // Empty pixels between glyphs and around the atlas
+};
+
+// Keep the requested glyphs of a font loaded with its texture and repack them into the
+// smallest atlas the skyline packer finds over the candidate widths. Metrics are copied
+// unchanged and the texture keeps the source format. The default character is kept
+// when the font has one. Throws std::runtime_error for a character the font lacks.
+SpriteFontData CookFont(const SpriteFontData& source, const CookOptions& options);
@@ -0,0 +1,99 @@
+#include "FontHeader.h"
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+    // Atlases are read a cache line at a time
+    const int TEXTURE_ALIGNMENT = 64;
+    const size_t BYTES_PER_LINE = 32;
+
+    // Shortest form that reads back as the same float
+    std::string FormatFloat(float value)
+    {
+        char text[32];
+        snprintf(text, sizeof(text), "%.9g", value);
+        std::string result = text;
+        if (result.find_first_of(".e") == std::string::npos)
+            result += ".0";
+        return result + "f";
+    }
+}
+
+std::string MakeFontSymbol(const std::string& fileName)
+{
+    std::string symbol = std::filesystem::path(fileName).stem().string();
+    for (char& c : symbol)
+    {
+        if (!isalnum(static_cast<unsigned char>(c)))
+            c = '_';
+    }
+    if (symbol.empty() || isdigit(static_cast<unsigned char>(symbol[0])))
+        symbol = "_" + symbol;
+    return symbol;
+}
+
+void WriteFontHeader(const SpriteFontData& font, const std::string& assetName,
+                     const std::string& symbol, const std::wstring& fileName)
+{
+    size_t textureSize = static_cast<size_t>(font.textureStride) * font.textureRows;
+    if (font.GetTextureSize() < textureSize)
+        throw std::runtime_error("Sprite font was loaded without its texture");
+
+    // The name goes into a string literal as is
+    for (char c : assetName)
+    {
+        if (c < 0x20 || c > 0x7E || c == '"' || c == '\\')
+            throw std::runtime_error("Asset name must be printable ASCII without quotes or backslashes");
+    }
+
+    std::filesystem::path filePath(fileName);
+    std::ofstream file(filePath, std::ios::trunc);
+    if (!file)
+        throw std::runtime_error("Failed to create font header " + filePath.string());
+
+    char line[256];
+    file << "// Generated by FontCooker from " << assetName << " - do not edit\n"
+         << "#pragma once\n"
+         << "#include \"EmbeddedFont.h\"\n\n"
+         << "namespace EmbeddedFonts\n{\n";
+
+    // Character, subrect, then offsets and advance, as in SpriteFontGlyph
+    file << "    inline constexpr SpriteFontGlyph " << symbol << "_glyphs[] =\n    {\n";
+    for (const SpriteFontGlyph& glyph : font.glyphs)
+    {
+        snprintf(line, sizeof(line), "        { %u, %d, %d, %d, %d, %s, %s, %s },\n",
+                 glyph.character, glyph.left, glyph.top, glyph.right, glyph.bottom,
+                 FormatFloat(glyph.xOffset).c_str(), FormatFloat(glyph.yOffset).c_str(),
+                 FormatFloat(glyph.xAdvance).c_str());
+        file << line;
+    }
+    file << "    };\n\n";
+
+    file << "    alignas(" << TEXTURE_ALIGNMENT << ") inline constexpr uint8_t " << symbol << "_texture[] =\n    {";
+    const uint8_t* texture = font.GetTextureData();
+    for (size_t i = 0; i < textureSize; i++)
+    {
+        snprintf(line, sizeof(line), i % BYTES_PER_LINE ? "%u," : "\n        %u,", texture[i]);
+        file << line;
+    }
+    file << "\n    };\n\n";
+
+    file << "    inline constexpr EmbeddedFont " << symbol << " =\n    {\n"
+         << "        L\"" << assetName << "\",\n"
+         << "        " << symbol << "_glyphs,\n"
+         << "        " << font.glyphs.size() << ",\n"
+         << "        " << FormatFloat(font.lineSpacing) << ",\n"
+         << "        " << font.defaultCharacter << ",\n"
+         << "        " << font.textureWidth << ", " << font.textureHeight << ", " << font.textureFormat << ", "
+         << font.textureStride << ", " << font.textureRows << ",\n"
+         << "        " << symbol << "_texture,\n"
+         << "    };\n"
+         << "}\n";
+
+    if (!file.flush())
+        throw std::runtime_error("Failed to write font header " + filePath.string());
+}
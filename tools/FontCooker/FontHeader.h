@@ -0,0 +1,12 @@
+#pragma once
+#include "SpriteFontFile.h"
+#include <string>
+
+// Write a C++ header embedding a font loaded with its texture: glyph records and atlas
+// bytes as constexpr tables and an EmbeddedFont named EmbeddedFonts::<symbol> that stands
+// in for the asset `assetName`. Throws std::runtime_error on I/O errors.
+void WriteFontHeader(const SpriteFontData& font, const std::string& assetName,
+                     const std::string& symbol, const std::wstring& fileName);
+
+// A C++ identifier from a file name: its stem, with anything else replaced by '_'
+std::string MakeFontSymbol(const std::string& fileName);
@@ -0,0 +1,141 @@
+// FontCooker - offline cooking of .spritefont assets: keeps the glyph subset a deployment
+// needs and repacks the atlas around just those glyphs, optionally as a C++ header that
+// compiles the font into the binary
+//
+// Usage: FontCooker [--out=<cooked.spritefont>] [--header=<font.h>] [options] <font.spritefont>
+//   --chars    Characters to keep, as UTF-8 text (default: all); the default character
+//              is always kept
+//   --padding  Empty pixels between glyphs (default: 1)
+//   --symbol   Name of the EmbeddedFont in the header (default: the input file stem)
+//   --name     Asset name the embedded font stands in for (default: the input file name)
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "FontCook.h"
+#include "FontHeader.h"
+
+namespace
+{
+    std::string GetOption(const std::string& arg, const std::string& prefix)
+    {
+        return arg.compare(0, prefix.size(), prefix) == 0 ? arg.substr(prefix.size()) : std::string();
+    }
+
+    void PrintUsage()
+    {
+        printf("Usage: FontCooker [--out=<cooked.spritefont>] [--header=<font.h>] [--chars=<text>]\n"
+               "                  [--padding=<pixels>] [--symbol=<name>] [--name=<asset>] <font.spritefont>\n");
+    }
+
+    // Code points of UTF-8 text; false on malformed input
+    bool DecodeUtf8(const std::string& text, std::vector<uint32_t>& characters)
+    {
+        for (size_t i = 0; i < text.size(); )
+        {
+            uint8_t lead = static_cast<uint8_t>(text[i]);
+            uint32_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 0;
+            if (length == 0 || i + length > text.size())
+                return false;
+
+            uint32_t code = length == 1 ? lead : lead & (0x7F >> length);
+            for (uint32_t k = 1; k < length; k++)
+            {
+                uint8_t next = static_cast<uint8_t>(text[i + k]);
+                if ((next & 0xC0) != 0x80)
+                    return false;
+                code = (code << 6) | (next & 0x3F);
+            }
+            characters.push_back(code);
+            i += length;
+        }
+        return true;
+    }
+
+    size_t GetFileSize(const std::string& path)
+    {
+        std::error_code error;
+        uintmax_t size = std::filesystem::file_size(path, error);
+        return error ? 0 : static_cast<size_t>(size);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::string outPath;
+    std::string headerPath;
+    std::string symbol;
+    std::string assetName;
+    std::vector<std::string> inputs;
+    CookOptions options;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        std::string value;
+        if (!(value = GetOption(arg, "--out=")).empty())
+            outPath = value;
+        else if (!(value = GetOption(arg, "--header=")).empty())
+            headerPath = value;
+        else if (!(value = GetOption(arg, "--symbol=")).empty())
+            symbol = value;
+        else if (!(value = GetOption(arg, "--name=")).empty())
+            assetName = value;
+        else if (!(value = GetOption(arg, "--chars=")).empty())
+        {
+            if (!DecodeUtf8(value, options.characters))
+            {
+                printf("--chars is not valid UTF-8\n");
+                return 2;
+            }
+        }
+        else if (!(value = GetOption(arg, "--padding=")).empty())
+            options.padding = static_cast<uint32_t>(std::max(0, atoi(value.c_str())));
+        else if (arg.compare(0, 2, "--") == 0)
+        {
+            printf("Unknown option: %s\n", arg.c_str());
+            return 2;
+        }
+        else
+            inputs.push_back(arg);
+    }
+
+    if ((outPath.empty() && headerPath.empty()) || inputs.size() != 1)
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    try
+    {
+        SpriteFontData source = SpriteFontFile::Load(std::filesystem::path(inputs[0]).wstring().c_str());
+        SpriteFontData cooked = CookFont(source, options);
+        printf("Cooked %s: %zu of %zu glyphs, atlas %ux%u -> %ux%u\n",
+               inputs[0].c_str(), cooked.glyphs.size(), source.glyphs.size(),
+               source.textureWidth, source.textureHeight, cooked.textureWidth, cooked.textureHeight);
+
+        if (!outPath.empty())
+        {
+            SpriteFontFile::Save(cooked, std::filesystem::path(outPath).wstring().c_str());
+            printf("Wrote %s: %zu -> %zu bytes\n", outPath.c_str(), GetFileSize(inputs[0]), GetFileSize(outPath));
+        }
+
+        if (!headerPath.empty())
+        {
+            if (assetName.empty())
+                assetName = std::filesystem::path(inputs[0]).filename().string();
+            WriteFontHeader(cooked, assetName, symbol.empty() ? MakeFontSymbol(inputs[0]) : symbol,
+                            std::filesystem::path(headerPath).wstring());
+            printf("Wrote %s\n", headerPath.c_str());
+        }
+    }
+    catch (const std::exception& e)
+    {
+        printf("FontCooker failed: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include "Image.h"
+#include <windows.h>
+#include <wincodec.h>
+#include <wrl/client.h>
+#include <filesystem>
+
+using Microsoft::WRL::ComPtr;
+
+namespace
+{
+    // The calling thread's WIC factory, created with COM on first use; null if either fails
+    IWICImagingFactory* GetFactory()
+    {
+        thread_local ComPtr<IWICImagingFactory> factory;
+        if (!factory)
+        {
+            HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+            if (FAILED(hr) && hr != RPC_E_CHANGED_MODE)
+                return nullptr;
+            CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&factory));
+        }
+        return factory.Get();
+    }
+}
+
+bool LoadPng(const std::string& path, Image& outImage)
+{
+    IWICImagingFactory* factory = GetFactory();
+    if (!factory)
+        return false;
+
+    std::wstring fileName = std::filesystem::path(path).wstring();
+    ComPtr<IWICBitmapDecoder> decoder;
+    HRESULT hr = factory->CreateDecoderFromFilename(fileName.c_str(), nullptr, GENERIC_READ,
+                                                    WICDecodeMetadataCacheOnDemand, &decoder);
+
+    GUID container = {};
+    if (SUCCEEDED(hr))
+        hr = decoder->GetContainerFormat(&container);
+    if (SUCCEEDED(hr) && container != GUID_ContainerFormatPng)
+        hr = WINCODEC_ERR_COMPONENTNOTFOUND;
+
+    ComPtr<IWICBitmapFrameDecode> frame;
+    if (SUCCEEDED(hr))
+        hr = decoder->GetFrame(0, &frame);
+
+    // Whatever the file's pixel format, read as 8-bit BGRA: 0xAARRGGBB in memory order
+    ComPtr<IWICFormatConverter> converter;
+    if (SUCCEEDED(hr))
+        hr = factory->CreateFormatConverter(&converter);
+    if (SUCCEEDED(hr))
+    {
+        hr = converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppBGRA, WICBitmapDitherTypeNone,
+                                   nullptr, 0.0, WICBitmapPaletteTypeCustom);
+    }
+
+    UINT width = 0;
+    UINT height = 0;
+    if (SUCCEEDED(hr))
+        hr = converter->GetSize(&width, &height);
+
+    Image image;
+    if (SUCCEEDED(hr))
+    {
+        image.width = width;
+        image.height = height;
+        image.pixels.resize(static_cast<size_t>(width) * height);
+        hr = converter->CopyPixels(nullptr, width * 4, static_cast<UINT>(image.pixels.size() * 4),
+                                   reinterpret_cast<BYTE*>(image.pixels.data()));
+    }
+    if (FAILED(hr))
+        return false;
+
+    // Alpha is dropped
+    for (uint32_t& pixel : image.pixels)
+        pixel |= 0xFF000000u;
+    outImage = std::move(image);
+    return true;
+}
+
+bool SavePng(const std::string& path, const Image& image)
+{
+    IWICImagingFactory* factory = GetFactory();
+    if (!factory)
+        return false;
+
+    // 8-bit BGR rows, which the PNG encoder writes as RGB without converting
+    const UINT stride = image.width * 3;
+    std::vector<BYTE> rows(static_cast<size_t>(stride) * image.height);
+    for (size_t i = 0; i < image.pixels.size(); i++)
+    {
+        rows[i * 3] = static_cast<BYTE>(image.pixels[i]);
+        rows[i * 3 + 1] = static_cast<BYTE>(image.pixels[i] >> 8);
+        rows[i * 3 + 2] = static_cast<BYTE>(image.pixels[i] >> 16);
+    }
+
+    std::wstring fileName = std::filesystem::path(path).wstring();
+    ComPtr<IWICStream> stream;
+    HRESULT hr = factory->CreateStream(&stream);
+    if (SUCCEEDED(hr))
+        hr = stream->InitializeFromFilename(fileName.c_str(), GENERIC_WRITE);
+
+    ComPtr<IWICBitmapEncoder> encoder;
+    if (SUCCEEDED(hr))
+        hr = factory->CreateEncoder(GUID_ContainerFormatPng, nullptr, &encoder);
+    if (SUCCEEDED(hr))
+        hr = encoder->Initialize(stream.Get(), WICBitmapEncoderNoCache);
+
+    ComPtr<IWICBitmapFrameEncode> frame;
+    if (SUCCEEDED(hr))
+        hr = encoder->CreateNewFrame(&frame, nullptr);
+    if (SUCCEEDED(hr))
+        hr = frame->Initialize(nullptr);
+    if (SUCCEEDED(hr))
+        hr = frame->SetSize(image.width, image.height);
+
+    WICPixelFormatGUID format = GUID_WICPixelFormat24bppBGR;
+    if (SUCCEEDED(hr))
+        hr = frame->SetPixelFormat(&format);
+    if (SUCCEEDED(hr) && format != GUID_WICPixelFormat24bppBGR)
+        hr = WINCODEC_ERR_UNSUPPORTEDPIXELFORMAT;
+
+    if (SUCCEEDED(hr))
+        hr = frame->WritePixels(image.height, stride, static_cast<UINT>(rows.size()), rows.data());
+    if (SUCCEEDED(hr))
+        hr = frame->Commit();
+    if (SUCCEEDED(hr))
+        hr = encoder->Commit();
+    return SUCCEEDED(hr);
+}
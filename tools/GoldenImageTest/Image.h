@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 32-bit 0xAARRGGBB image, top-down, tightly packed
+struct Image
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint32_t> pixels;
+};
+
+// PNG I/O through WIC; return false on I/O or format errors. Loads any PNG (alpha is
+// dropped), saves 8-bit RGB.
+bool LoadPng(const std::string& path, Image& outImage);
+bool SavePng(const std::string& path, const Image& image);
@@ -0,0 +1,127 @@
+#include "ImageDiff.h"
+#include <algorithm>
+#include <cstdlib>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define GOLDEN_USE_SSE2 1
+#endif
+
+namespace
+{
+    // Luma-weighted difference (BT.601 weights) plus a quarter of the chroma error;
+    // the eye is far more sensitive to brightness than to hue shifts.
+    uint32_t PerceptualDelta(uint32_t a, uint32_t b)
+    {
+        int dr = static_cast<int>((a >> 16) & 0xFF) - static_cast<int>((b >> 16) & 0xFF);
+        int dg = static_cast<int>((a >> 8) & 0xFF) - static_cast<int>((b >> 8) & 0xFF);
+        int db = static_cast<int>(a & 0xFF) - static_cast<int>(b & 0xFF);
+
+        int dy = (77 * dr + 150 * dg + 29 * db) / 256;
+        int dcb = db - dy;
+        int dcr = dr - dy;
+        return static_cast<uint32_t>(std::abs(dy) + (std::abs(dcb) + std::abs(dcr)) / 4);
+    }
+
+    uint32_t MaxChannelDelta(uint32_t a, uint32_t b)
+    {
+        uint32_t result = 0;
+        for (int shift = 0; shift < 24; shift += 8)
+        {
+            int delta = static_cast<int>((a >> shift) & 0xFF) - static_cast<int>((b >> shift) & 0xFF);
+            result = std::max(result, static_cast<uint32_t>(std::abs(delta)));
+        }
+        return result;
+    }
+
+    // Scalar bookkeeping for one differing pixel
+    void AccumulatePixel(uint32_t expected, uint32_t actual, const DiffOptions& options, DiffResult& result)
+    {
+        uint32_t channelDelta = MaxChannelDelta(expected, actual);
+        uint32_t perceptual = PerceptualDelta(expected, actual);
+
+        result.maxChannelDelta = std::max(result.maxChannelDelta, channelDelta);
+        result.maxPerceptualDelta = std::max(result.maxPerceptualDelta, perceptual);
+        if (channelDelta > options.channelTolerance)
+            result.pixelsOverTolerance++;
+        if (perceptual > options.perceptualThreshold)
+            result.perceptualFailures++;
+    }
+}
+
+DiffResult CompareImages(const Image& expected, const Image& actual, const DiffOptions& options)
+{
+    DiffResult result;
+    if (expected.width != actual.width || expected.height != actual.height)
+    {
+        result.sizeMismatch = true;
+        result.passed = false;
+        return result;
+    }
+
+    const uint32_t* a = expected.pixels.data();
+    const uint32_t* b = actual.pixels.data();
+    const size_t count = expected.pixels.size();
+    size_t i = 0;
+
+#ifdef GOLDEN_USE_SSE2
+    // Alpha is ignored; only color channels take part in the comparison
+    const __m128i colorMask = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i zero = _mm_setzero_si128();
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        __m128i absDiff = _mm_and_si128(_mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va)), colorMask);
+
+        // Fast path: all four pixels identical
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(absDiff, zero)) == 0xFFFF)
+            continue;
+
+        for (size_t j = i; j < i + 4; j++)
+        {
+            if (((a[j] ^ b[j]) & 0x00FFFFFF) != 0)
+                AccumulatePixel(a[j], b[j], options, result);
+        }
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        if (((a[i] ^ b[i]) & 0x00FFFFFF) != 0)
+            AccumulatePixel(a[i], b[i], options, result);
+    }
+
+    uint64_t allowed = static_cast<uint64_t>(options.maxFailingFraction * static_cast<double>(count));
+    result.passed = result.pixelsOverTolerance <= allowed && result.perceptualFailures <= allowed;
+    return result;
+}
+
+Image MakeDiffHeatmap(const Image& expected, const Image& actual)
+{
+    Image heatmap;
+    heatmap.width = std::min(expected.width, actual.width);
+    heatmap.height = std::min(expected.height, actual.height);
+    heatmap.pixels.assign(static_cast<size_t>(heatmap.width) * heatmap.height, 0xFF000000u);
+
+    for (uint32_t y = 0; y < heatmap.height; y++)
+    {
+        for (uint32_t x = 0; x < heatmap.width; x++)
+        {
+            uint32_t delta = PerceptualDelta(expected.pixels[static_cast<size_t>(y) * expected.width + x],
+                                             actual.pixels[static_cast<size_t>(y) * actual.width + x]);
+            if (delta == 0)
+                continue;
+
+            // Scale so even a 1-level difference is clearly visible
+            uint32_t heat = std::min<uint32_t>(765, 64 + delta * 8);
+            uint32_t r = std::min<uint32_t>(255, heat);
+            uint32_t g = heat > 255 ? std::min<uint32_t>(255, heat - 255) : 0;
+            uint32_t b = heat > 510 ? heat - 510 : 0;
+            heatmap.pixels[static_cast<size_t>(y) * heatmap.width + x] = 0xFF000000u | (r << 16) | (g << 8) | b;
+        }
+    }
+
+    return heatmap;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include "Image.h"
+
+struct DiffOptions
+{
+    // Largest per-channel difference that still counts as a match
+    uint8_t channelTolerance = 0;
+
+    // Largest perceptual (luma-weighted) difference that still counts as a match
+    uint32_t perceptualThreshold = 0;
+
+    // Fraction of pixels allowed to exceed the thresholds before the comparison fails
+    double maxFailingFraction = 0.0;
+};
+
+struct DiffResult
+{
+    bool sizeMismatch = false;
+    uint64_t pixelsOverTolerance = 0;   // Any channel differs by more than channelTolerance
+    uint64_t perceptualFailures = 0;    // Perceptual delta above perceptualThreshold
+    uint32_t maxChannelDelta = 0;
+    uint32_t maxPerceptualDelta = 0;
+    bool passed = true;
+};
+
+// Compare two images. The tolerance pass runs four pixels per SSE2 step; the
+// perceptual metric is only evaluated for pixels that differ at all, so identical
+// images cost one vectorized sweep.
+DiffResult CompareImages(const Image& expected, const Image& actual, const DiffOptions& options);
+
+// Heatmap of perceptual differences: black where identical, red to yellow to white
+// as the difference grows.
+Image MakeDiffHeatmap(const Image& expected, const Image& actual);
@@ -0,0 +1,241 @@
+// GoldenImageTest - renders fixed seeds and scenes through the headless software
+// renderer and compares them against stored reference images.
+//
+// Usage: GoldenImageTest [--update] [--scene=NAME] [--golden-dir=DIR] [--output-dir=DIR]
+//                        [--tolerance=N] [--perceptual=N] [--max-failing=FRACTION]
+//
+// --update rewrites the references from the current output. On failure the actual
+// image and a diff heatmap are written to the output directory.
+#include <windows.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Engine.h"
+#include "DisplayList.h"
+#include "SoftwareRenderer.h"
+#include "Image.h"
+#include "ImageDiff.h"
+
+#ifndef GOLDEN_IMAGE_DIR
+#define GOLDEN_IMAGE_DIR "tests/golden"
+#endif
+
+namespace
+{
+    struct Scene
+    {
+        std::string name;
+        std::function<Image()> render;
+    };
+
+    Image ReadFramebuffer(const SoftwareRenderer& renderer)
+    {
+        Image image;
+        image.width = renderer.GetWidth();
+        image.height = renderer.GetHeight();
+        image.pixels.assign(renderer.GetPixels(),
+                            renderer.GetPixels() + static_cast<size_t>(image.width) * image.height);
+        return image;
+    }
+
+    // One full Engine frame for a fixed RNG seed
+    Image RenderEngineFrame(uint32_t seed, UINT width, UINT height)
+    {
+        auto renderer = std::make_unique<SoftwareRenderer>();
+        SoftwareRenderer* software = renderer.get();
+
+        Engine engine(width, height);
+        engine.SetSeed(seed);
+        engine.Initialize(nullptr, std::move(renderer));
+        engine.Render();
+
+        Image image = ReadFramebuffer(*software);
+        engine.OnDestroy();
+        return image;
+    }
+
+    // Every printable ASCII glyph in both font sizes, including multi-line text
+    Image RenderGlyphSheet(UINT width, UINT height)
+    {
+        SoftwareRenderer renderer;
+        renderer.Initialize(nullptr, width, height);
+
+        std::wstring ascii;
+        for (wchar_t c = 32; c < 127; c++)
+            ascii += c;
+
+        DisplayList list;
+        list.AddClear(0.2f, 0.2f, 0.25f);
+        list.AddText(ascii.substr(0, 48).c_str(), 10.0f, 10.0f, 24.0f, 1.0f, 1.0f, 1.0f);
+        list.AddText(ascii.substr(48).c_str(), 10.0f, 50.0f, 24.0f, 0.5f, 1.0f, 0.5f);
+        list.AddText(L"Line one\nLine two\r\nLine three", 10.0f, 100.0f, 24.0f, 1.0f, 0.8f, 0.3f);
+        list.AddText(L"0123456789", 10.0f, 230.0f, 120.0f, 1.0f, 1.0f, 0.39f, true);
+        list.AddText(L"AaBbWwQq@&", 10.0f, 420.0f, 120.0f, 0.3f, 0.7f, 1.0f);
+        list.AddText(L"Clipped at the right edge of the frame", width - 200.0f, 600.0f, 24.0f, 1.0f, 1.0f, 1.0f);
+        list.Replay(renderer);
+
+        Image image = ReadFramebuffer(renderer);
+        renderer.OnDestroy();
+        return image;
+    }
+
+    // Sizes between and beyond the two sprite fonts, scaled from the nearest larger atlas
+    Image RenderScaledText(UINT width, UINT height)
+    {
+        SoftwareRenderer renderer;
+        renderer.Initialize(nullptr, width, height);
+
+        DisplayList list;
+        list.AddClear(0.2f, 0.2f, 0.25f);
+        float y = 10.0f;
+        for (float size : { 10.0f, 14.0f, 20.0f, 32.0f, 48.0f, 72.0f })
+        {
+            list.AddText(L"Sphinx of black quartz, judge my vow 0123456789", 10.0f, y, size, 1.0f, 1.0f, 1.0f);
+            y += size * 1.25f;
+        }
+        list.AddText(L"Ag&8", 10.0f, y, 180.0f, 0.3f, 0.7f, 1.0f);
+        list.AddText(L"Multi\nline 17pt", 700.0f, y, 17.0f, 1.0f, 0.8f, 0.3f);
+        list.Replay(renderer);
+
+        Image image = ReadFramebuffer(renderer);
+        renderer.OnDestroy();
+        return image;
+    }
+
+    std::vector<Scene> BuildScenes()
+    {
+        return {
+            { "engine_seed1_720p", [] { return RenderEngineFrame(1, 1280, 720); } },
+            { "engine_seed42_720p", [] { return RenderEngineFrame(42, 1280, 720); } },
+            { "engine_seed9001_1080p", [] { return RenderEngineFrame(9001, 1920, 1080); } },
+            { "engine_seed7_small", [] { return RenderEngineFrame(7, 480, 270); } },
+            { "glyph_sheet_720p", [] { return RenderGlyphSheet(1280, 720); } },
+            { "scaled_text_720p", [] { return RenderScaledText(1280, 720); } },
+        };
+    }
+
+    std::string GetOption(const std::string& arg, const std::string& prefix)
+    {
+        return arg.compare(0, prefix.size(), prefix) == 0 ? arg.substr(prefix.size()) : std::string();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    bool update = false;
+    std::string onlyScene;
+    std::filesystem::path goldenDir = GOLDEN_IMAGE_DIR;
+    std::filesystem::path outputDir = "golden_output";
+    DiffOptions options;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        std::string value;
+        if (arg == "--update")
+            update = true;
+        else if (!(value = GetOption(arg, "--scene=")).empty())
+            onlyScene = value;
+        else if (!(value = GetOption(arg, "--golden-dir=")).empty())
+            goldenDir = value;
+        else if (!(value = GetOption(arg, "--output-dir=")).empty())
+            outputDir = value;
+        else if (!(value = GetOption(arg, "--tolerance=")).empty())
+            options.channelTolerance = static_cast<uint8_t>(atoi(value.c_str()));
+        else if (!(value = GetOption(arg, "--perceptual=")).empty())
+            options.perceptualThreshold = static_cast<uint32_t>(atoi(value.c_str()));
+        else if (!(value = GetOption(arg, "--max-failing=")).empty())
+            options.maxFailingFraction = atof(value.c_str());
+        else
+        {
+            printf("Unknown option: %s\n", arg.c_str());
+            return 2;
+        }
+    }
+
+    int failures = 0;
+    int run = 0;
+
+    try
+    {
+        for (const Scene& scene : BuildScenes())
+        {
+            if (!onlyScene.empty() && scene.name != onlyScene)
+                continue;
+            run++;
+
+            auto start = std::chrono::steady_clock::now();
+            Image actual = scene.render();
+            auto rendered = std::chrono::steady_clock::now();
+
+            std::filesystem::path referencePath = goldenDir / (scene.name + ".png");
+
+            if (update)
+            {
+                std::filesystem::create_directories(goldenDir);
+                if (!SavePng(referencePath.string(), actual))
+                {
+                    printf("[FAIL]   %s: could not write %s\n", scene.name.c_str(), referencePath.string().c_str());
+                    failures++;
+                    continue;
+                }
+                printf("[UPDATE] %s\n", scene.name.c_str());
+                continue;
+            }
+
+            Image expected;
+            if (!LoadPng(referencePath.string(), expected))
+            {
+                printf("[FAIL]   %s: missing reference %s (run with --update)\n",
+                       scene.name.c_str(), referencePath.string().c_str());
+                failures++;
+                continue;
+            }
+
+            DiffResult diff = CompareImages(expected, actual, options);
+            auto compared = std::chrono::steady_clock::now();
+
+            double renderMs = std::chrono::duration<double, std::milli>(rendered - start).count();
+            double compareMs = std::chrono::duration<double, std::milli>(compared - rendered).count();
+
+            if (diff.passed)
+            {
+                printf("[PASS]   %s (render %.2f ms, compare %.2f ms)\n", scene.name.c_str(), renderMs, compareMs);
+                continue;
+            }
+
+            failures++;
+            if (diff.sizeMismatch)
+            {
+                printf("[FAIL]   %s: size %ux%u, expected %ux%u\n", scene.name.c_str(),
+                       actual.width, actual.height, expected.width, expected.height);
+            }
+            else
+            {
+                printf("[FAIL]   %s: %llu pixels over tolerance, %llu perceptual failures "
+                       "(max channel delta %u, max perceptual delta %u)\n", scene.name.c_str(),
+                       static_cast<unsigned long long>(diff.pixelsOverTolerance),
+                       static_cast<unsigned long long>(diff.perceptualFailures),
+                       diff.maxChannelDelta, diff.maxPerceptualDelta);
+            }
+
+            std::filesystem::create_directories(outputDir);
+            SavePng((outputDir / (scene.name + "_actual.png")).string(), actual);
+            if (!diff.sizeMismatch)
+                SavePng((outputDir / (scene.name + "_diff.png")).string(), MakeDiffHeatmap(expected, actual));
+        }
+    }
+    catch (const std::exception& e)
+    {
+        printf("GoldenImageTest failed: %s\n", e.what());
+        return 2;
+    }
+
+    printf("%d of %d scenes passed\n", run - failures, run);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <thread>
+
+namespace
+{
+    double ElapsedNs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::string EscapeJson(const std::string& text)
+    {
+        std::string result;
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+                result += '\\';
+            result += c;
+        }
+        return result;
+    }
+
+    double Median(std::vector<double> values)
+    {
+        std::sort(values.begin(), values.end());
+        size_t n = values.size();
+        return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2.0;
+    }
+}
+
+BenchmarkRunner::BenchmarkRunner(const BenchmarkOptions& options)
+    : m_options(options)
+{
+}
+
+bool BenchmarkRunner::Run(const std::string& name, std::vector<std::pair<std::string, std::string>> params,
+                          double itemsPerIteration, const Body& body)
+{
+    std::string fullName = name;
+    for (const auto& param : params)
+        fullName += "/" + param.first + ":" + param.second;
+
+    if (!m_options.filter.empty() && fullName.find(m_options.filter) == std::string::npos)
+        return false;
+
+    // Warm caches and lazily created state, then grow the iteration count until a
+    // sample is long enough to swamp timer resolution.
+    body(1);
+    const double minSampleNs = m_options.minSampleMs * 1e6;
+    uint64_t iterations = 1;
+    for (;;)
+    {
+        auto start = std::chrono::steady_clock::now();
+        body(iterations);
+        double elapsed = ElapsedNs(start);
+        if (elapsed >= minSampleNs || iterations >= (1ull << 40))
+            break;
+
+        double scale = elapsed > 0.0 ? minSampleNs * 1.2 / elapsed : 10.0;
+        iterations = static_cast<uint64_t>(std::ceil(iterations * std::clamp(scale, 1.5, 10.0)));
+    }
+
+    BenchmarkResult result;
+    result.name = fullName;
+    result.params = std::move(params);
+    result.iterationsPerSample = iterations;
+    result.itemsPerIteration = itemsPerIteration;
+
+    for (int rep = 0; rep < m_options.repetitions; rep++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        body(iterations);
+        result.samplesNs.push_back(ElapsedNs(start) / static_cast<double>(iterations));
+    }
+
+    double median = Median(result.samplesNs);
+    printf("%-60s %14.1f ns  %12.3f M items/s\n", fullName.c_str(), median,
+           median > 0.0 ? itemsPerIteration * 1e3 / median : 0.0);
+    fflush(stdout);
+
+    m_results.push_back(std::move(result));
+    return true;
+}
+
+void BenchmarkRunner::AddCounter(const std::string& name, double value)
+{
+    if (m_results.empty())
+        return;
+
+    m_results.back().counters.emplace_back(name, value);
+    printf("%-60s %14.0f %s\n", "", value, name.c_str());
+    fflush(stdout);
+}
+
+bool BenchmarkRunner::WriteJson(const std::string& path) const
+{
+    std::ofstream file(path);
+    if (!file)
+        return false;
+
+    char date[32] = {};
+    std::time_t now = std::time(nullptr);
+    std::tm local = {};
+    localtime_s(&local, &now);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", &local);
+
+    file << "{\n";
+    file << "  \"context\": {\n";
+    file << "    \"date\": \"" << date << "\",\n";
+    file << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+#if defined(NDEBUG)
+    file << "    \"build_type\": \"release\",\n";
+#else
+    file << "    \"build_type\": \"debug\",\n";
+#endif
+    file << "    \"repetitions\": " << m_options.repetitions << "\n";
+    file << "  },\n";
+    file << "  \"benchmarks\": [\n";
+
+    for (size_t i = 0; i < m_results.size(); i++)
+    {
+        const BenchmarkResult& result = m_results[i];
+
+        double sum = 0.0;
+        for (double sample : result.samplesNs)
+            sum += sample;
+        double mean = sum / result.samplesNs.size();
+        double variance = 0.0;
+        for (double sample : result.samplesNs)
+            variance += (sample - mean) * (sample - mean);
+        double stddev = result.samplesNs.size() > 1 ? std::sqrt(variance / (result.samplesNs.size() - 1)) : 0.0;
+        double median = Median(result.samplesNs);
+
+        file << "    {\n";
+        file << "      \"name\": \"" << EscapeJson(result.name) << "\",\n";
+        for (const auto& param : result.params)
+            file << "      \"" << EscapeJson(param.first) << "\": \"" << EscapeJson(param.second) << "\",\n";
+        for (const auto& counter : result.counters)
+        {
+            // Full precision: counters such as byte counts are exact integers
+            char value[32];
+            snprintf(value, sizeof(value), "%.15g", counter.second);
+            file << "      \"" << EscapeJson(counter.first) << "\": " << value << ",\n";
+        }
+        file << "      \"iterations\": " << result.iterationsPerSample << ",\n";
+        file << "      \"median_ns\": " << median << ",\n";
+        file << "      \"mean_ns\": " << mean << ",\n";
+        file << "      \"stddev_ns\": " << stddev << ",\n";
+        file << "      \"min_ns\": " << *std::min_element(result.samplesNs.begin(), result.samplesNs.end()) << ",\n";
+        file << "      \"items_per_second\": " << (median > 0.0 ? result.itemsPerIteration * 1e9 / median : 0.0) << ",\n";
+        file << "      \"samples_ns\": [";
+        for (size_t s = 0; s < result.samplesNs.size(); s++)
+            file << (s ? ", " : "") << result.samplesNs[s];
+        file << "]\n";
+        file << "    }" << (i + 1 < m_results.size() ? "," : "") << "\n";
+    }
+
+    file << "  ]\n";
+    file << "}\n";
+    return static_cast<bool>(file);
+}
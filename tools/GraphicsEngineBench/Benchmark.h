@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Minimal benchmark harness: each benchmark body runs a requested number of
+// iterations; the runner calibrates the count so one sample takes at least
+// minSampleMs, then records several samples for later statistical comparison.
+struct BenchmarkResult
+{
+    std::string name;
+    std::vector<std::pair<std::string, std::string>> params;    // e.g. resolution, threads, scene
+    uint64_t iterationsPerSample = 0;
+    double itemsPerIteration = 1.0;                             // Work units per iteration (chars, pixels, frames)
+    std::vector<double> samplesNs;                              // Mean nanoseconds per iteration, one per sample
+    std::vector<std::pair<std::string, double>> counters;       // Other measurements, e.g. resident bytes
+};
+
+struct BenchmarkOptions
+{
+    std::string filter;         // Substring that benchmark names must contain
+    int repetitions = 10;
+    double minSampleMs = 20.0;
+};
+
+class BenchmarkRunner
+{
+public:
+    explicit BenchmarkRunner(const BenchmarkOptions& options);
+
+    using Body = std::function<void(uint64_t iterations)>;
+
+    // Run one benchmark unless the filter excludes it; returns false if it did
+    bool Run(const std::string& name, std::vector<std::pair<std::string, std::string>> params,
+             double itemsPerIteration, const Body& body);
+
+    // Attach a measurement to the benchmark that ran last
+    void AddCounter(const std::string& name, double value);
+
+    const std::vector<BenchmarkResult>& GetResults() const { return m_results; }
+
+    // Write all results as JSON; returns false on I/O failure
+    bool WriteJson(const std::string& path) const;
+
+private:
+    BenchmarkOptions m_options;
+    std::vector<BenchmarkResult> m_results;
+};
+
+// Keep the optimizer from discarding a computed value or hoisting the work that
+// produced it out of the benchmark loop (acts as a compiler memory barrier)
+template <typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(_MSC_VER)
+    static volatile const void* sink;
+    sink = &value;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "r,m"(value) : "memory");
+#endif
+}
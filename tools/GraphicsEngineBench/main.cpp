@@ -0,0 +1,958 @@
+// GraphicsEngineBench - microbenchmarks for the text and frame pipeline, run through the
+// headless software renderer so results do not depend on a window or GPU.
+//
+// Usage: GraphicsEngineBench [--out=FILE] [--filter=TEXT] [--repetitions=N] [--min-time-ms=N]
+//                            [--resolutions=720p,1080p,4k,8k] [--max-threads=N] [--ttf=FILE]
+//
+// Every benchmark records one sample per repetition (mean ns per iteration) and the
+// results are written as JSON (default bench_results.json) for before/after comparison.
+// Run from a directory containing arial24.spritefont and arial120.spritefont. The outline
+// font benchmarks run only with --ttf.
+#include <windows.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Benchmark.h"
+#include "Clock.h"
+#include "CommandLine.h"
+#include "Engine.h"
+#include "DisplayList.h"
+#include "Fence.h"
+#include "FrameRing.h"
+#include "ParallelRecorder.h"
+#include "ResourcePool.h"
+#include "ResourceManager.h"
+#include "GlyphTable.h"
+#include "CoverageAtlas.h"
+#include "GlyphCache.h"
+#include "GlyphScaler.h"
+#include "SpriteFontFile.h"
+#include "SoftwareRenderer.h"
+#include "TimerWheel.h"
+
+namespace
+{
+    struct Resolution
+    {
+        const char* name;
+        UINT width;
+        UINT height;
+    };
+
+    const Resolution ALL_RESOLUTIONS[] = {
+        { "720p", 1280, 720 },
+        { "1080p", 1920, 1080 },
+        { "4k", 3840, 2160 },
+        { "8k", 7680, 4320 },
+    };
+
+    // Framebuffers for all threads of one benchmark must fit in this budget
+    const size_t FRAMEBUFFER_BUDGET = size_t(1) << 30;
+
+    const wchar_t* LABEL_TEXT = L"Random Number Generator";
+    const wchar_t* LONG_TEXT = L"The quick brown fox jumps over the lazy dog 0123456789 (ASCII!)";
+
+    // Mostly ASCII with some Latin-1 and characters outside the fonts' range
+    std::wstring MakeLookupText()
+    {
+        std::wstring text;
+        for (wchar_t c = 32; c < 127; c++)
+            text += c;
+        text += L"\u00E9\u00FC\u00C5\u00DF\u20AC\u4E2D\u0416";
+        for (wchar_t c = 32; c < 127; c++)
+            text += c;
+        return text;
+    }
+
+    // Run body(iterations) on `threads` threads at once. Threads start together and the
+    // call returns when all have finished, so wall time covers the slowest thread.
+    void RunOnThreads(int threads, uint64_t iterations, const std::function<void(int, uint64_t)>& body)
+    {
+        if (threads == 1)
+        {
+            body(0, iterations);
+            return;
+        }
+
+        std::atomic<int> ready(0);
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (int t = 0; t < threads; t++)
+        {
+            workers.emplace_back([&, t]
+            {
+                ready.fetch_add(1);
+                while (ready.load() < threads)
+                    std::this_thread::yield();
+                body(t, iterations);
+            });
+        }
+        for (std::thread& worker : workers)
+            worker.join();
+    }
+
+    std::vector<std::unique_ptr<SoftwareRenderer>> CreateRenderers(int count, const Resolution& resolution)
+    {
+        std::vector<std::unique_ptr<SoftwareRenderer>> renderers;
+        for (int i = 0; i < count; i++)
+        {
+            renderers.push_back(std::make_unique<SoftwareRenderer>());
+            renderers.back()->Initialize(nullptr, resolution.width, resolution.height);
+        }
+        return renderers;
+    }
+
+    // A status-screen style layout: a grid of small labels plus a few large numbers
+    void BuildDashboardScene(DisplayList& list, const Resolution& resolution)
+    {
+        list.Reset();
+        list.AddClear(0.2f, 0.25f, 0.35f);
+
+        for (float y = 20.0f; y + 40.0f < resolution.height; y += 40.0f)
+        {
+            for (float x = 20.0f; x + 300.0f < resolution.width; x += 320.0f)
+                list.AddText(L"Frame time: 16.67 ms", x, y, 24.0f, 0.9f, 0.9f, 0.9f);
+        }
+
+        for (int i = 0; i < 4; i++)
+        {
+            list.AddText(std::to_wstring(1234 * (i + 1)).c_str(), 100.0f + i * 400.0f,
+                         resolution.height / 2.0f, 120.0f, 1.0f, 1.0f, 0.39f, true);
+        }
+    }
+
+    struct Settings
+    {
+        std::string outputPath = "bench_results.json";
+        std::vector<Resolution> resolutions;
+        std::vector<int> threadCounts;
+        std::string outlineFontPath;        // --ttf; outline benchmarks are skipped without it
+    };
+
+    void RunGlyphBenchmarks(BenchmarkRunner& runner, const Settings& settings,
+                            const GlyphTable& smallFont, const GlyphTable& largeFont)
+    {
+        const std::wstring lookupText = MakeLookupText();
+
+        for (int threads : settings.threadCounts)
+        {
+            std::string threadName = std::to_string(threads);
+
+            runner.Run("glyph_lookup", { { "threads", threadName } },
+                       static_cast<double>(lookupText.size()) * threads, [&](uint64_t iterations)
+            {
+                RunOnThreads(threads, iterations, [&](int, uint64_t count)
+                {
+                    for (uint64_t i = 0; i < count; i++)
+                    {
+                        uintptr_t checksum = 0;
+                        for (wchar_t c : lookupText)
+                            checksum += reinterpret_cast<uintptr_t>(smallFont.FindGlyph(c));
+                        DoNotOptimize(checksum);
+                    }
+                });
+            });
+
+            const struct { const char* name; const GlyphTable* font; } fonts[] = {
+                { "24pt", &smallFont },
+                { "120pt", &largeFont },
+            };
+            const struct { const char* name; const wchar_t* text; } texts[] = {
+                { "label", LABEL_TEXT },
+                { "long", LONG_TEXT },
+            };
+            for (const auto& font : fonts)
+            {
+                for (const auto& text : texts)
+                {
+                    runner.Run("measure_text", { { "font", font.name }, { "text", text.name }, { "threads", threadName } },
+                               static_cast<double>(wcslen(text.text)) * threads, [&](uint64_t iterations)
+                    {
+                        RunOnThreads(threads, iterations, [&](int, uint64_t count)
+                        {
+                            float width = 0.0f, height = 0.0f;
+                            for (uint64_t i = 0; i < count; i++)
+                            {
+                                font.font->MeasureText(text.text, width, height);
+                                DoNotOptimize(width);
+                            }
+                        });
+                    });
+                }
+            }
+        }
+    }
+
+    void RunRasterBenchmarks(BenchmarkRunner& runner, const Settings& settings)
+    {
+        const std::wstring number = L"8888";
+        const size_t longLength = wcslen(LONG_TEXT);
+
+        for (const Resolution& resolution : settings.resolutions)
+        {
+            const size_t framebufferBytes = static_cast<size_t>(resolution.width) * resolution.height * 4;
+            const double pixels = static_cast<double>(resolution.width) * resolution.height;
+
+            for (int threads : settings.threadCounts)
+            {
+                if (framebufferBytes * threads > FRAMEBUFFER_BUDGET)
+                {
+                    printf("Skipping %s with %d threads: framebuffers exceed the memory budget\n",
+                           resolution.name, threads);
+                    continue;
+                }
+
+                auto renderers = CreateRenderers(threads, resolution);
+                std::vector<std::pair<std::string, std::string>> params = {
+                    { "resolution", resolution.name }, { "threads", std::to_string(threads) } };
+
+                runner.Run("clear", params, pixels * threads, [&](uint64_t iterations)
+                {
+                    RunOnThreads(threads, iterations, [&](int t, uint64_t count)
+                    {
+                        for (uint64_t i = 0; i < count; i++)
+                            renderers[t]->Clear(0.3f, 0.4f, 0.6f);
+                    });
+                });
+
+                auto textParams = params;
+                textParams.insert(textParams.begin(), { "font", "24pt" });
+                runner.Run("draw_text", textParams, static_cast<double>(longLength) * threads, [&](uint64_t iterations)
+                {
+                    RunOnThreads(threads, iterations, [&](int t, uint64_t count)
+                    {
+                        for (uint64_t i = 0; i < count; i++)
+                            renderers[t]->DrawText(LONG_TEXT, 40.0f, 30.0f, 24.0f, 1.0f, 1.0f, 1.0f);
+                    });
+                });
+
+                textParams[0].second = "120pt";
+                runner.Run("draw_text", textParams, static_cast<double>(number.size()) * threads, [&](uint64_t iterations)
+                {
+                    RunOnThreads(threads, iterations, [&](int t, uint64_t count)
+                    {
+                        for (uint64_t i = 0; i < count; i++)
+                            renderers[t]->DrawText(number.c_str(), 100.0f, 200.0f, 120.0f, 1.0f, 1.0f, 0.39f, true);
+                    });
+                });
+
+                for (auto& renderer : renderers)
+                    renderer->OnDestroy();
+            }
+        }
+    }
+
+    void RunFrameBenchmarks(BenchmarkRunner& runner, const Settings& settings)
+    {
+        for (const Resolution& resolution : settings.resolutions)
+        {
+            const size_t framebufferBytes = static_cast<size_t>(resolution.width) * resolution.height * 4;
+
+            for (int threads : settings.threadCounts)
+            {
+                if (framebufferBytes * threads > FRAMEBUFFER_BUDGET)
+                    continue;
+
+                auto params = [&](const char* scene) -> std::vector<std::pair<std::string, std::string>>
+                {
+                    return { { "scene", scene }, { "resolution", resolution.name },
+                             { "threads", std::to_string(threads) } };
+                };
+
+                // Engine scene: retained replay, and a full rebuild (layout + measure) per frame
+                std::vector<std::unique_ptr<Engine>> engines;
+                for (int t = 0; t < threads; t++)
+                {
+                    engines.push_back(std::make_unique<Engine>(resolution.width, resolution.height));
+                    engines.back()->SetSeed(1);
+                    engines.back()->Initialize(nullptr, std::make_unique<SoftwareRenderer>());
+                }
+
+                runner.Run("frame", params("engine"), threads, [&](uint64_t iterations)
+                {
+                    RunOnThreads(threads, iterations, [&](int t, uint64_t count)
+                    {
+                        for (uint64_t i = 0; i < count; i++)
+                            engines[t]->Render();
+                    });
+                });
+
+                runner.Run("frame", params("engine_rebuild"), threads, [&](uint64_t iterations)
+                {
+                    RunOnThreads(threads, iterations, [&](int t, uint64_t count)
+                    {
+                        for (uint64_t i = 0; i < count; i++)
+                        {
+                            engines[t]->SetSeed(static_cast<uint32_t>(i));
+                            engines[t]->Render();
+                        }
+                    });
+                });
+
+                for (auto& engine : engines)
+                    engine->OnDestroy();
+                engines.clear();
+
+                // Text-heavy scene replayed from a display list
+                auto renderers = CreateRenderers(threads, resolution);
+                DisplayList dashboard;
+                BuildDashboardScene(dashboard, resolution);
+
+                runner.Run("frame", params("dashboard"), threads, [&](uint64_t iterations)
+                {
+                    RunOnThreads(threads, iterations, [&](int t, uint64_t count)
+                    {
+                        for (uint64_t i = 0; i < count; i++)
+                            renderers[t]->DrawDisplayList(dashboard);
+                    });
+                });
+
+                for (auto& renderer : renderers)
+                    renderer->OnDestroy();
+            }
+        }
+    }
+
+    // Dense label grid, one job per row: each label is formatted, measured and right-aligned
+    // in its cell. Recording only; the merged list is not rendered.
+    void RecordLabelRow(const GlyphTable& font, const Resolution& resolution, size_t row, DisplayList& list)
+    {
+        const float cellWidth = 160.0f;
+        const float y = 8.0f + row * 24.0f;
+        wchar_t text[32];
+        for (float x = 0.0f; x + cellWidth <= resolution.width; x += cellWidth)
+        {
+            // "S<sensor>: <value>.<hundredths>", formatted by hand: swprintf takes a locale
+            // lock in some C runtimes, which would serialize the threads
+            unsigned sensor = static_cast<unsigned>(row * 1000 + x / cellWidth);
+            unsigned hundredths = (sensor % 977) * 37;
+            wchar_t* end = text + 32;
+            wchar_t* p = end;
+            *--p = L'\0';
+            for (int digit = 0; digit < 3 || hundredths; digit++)
+            {
+                if (digit == 2)
+                    *--p = L'.';
+                *--p = static_cast<wchar_t>(L'0' + hundredths % 10);
+                hundredths /= 10;
+            }
+            *--p = L' ';
+            *--p = L':';
+            do
+            {
+                *--p = static_cast<wchar_t>(L'0' + sensor % 10);
+                sensor /= 10;
+            } while (sensor);
+            *--p = L'S';
+
+            float width, height;
+            font.MeasureText(p, width, height);
+            list.AddText(p, x + cellWidth - 8.0f - width, y, 24.0f, 0.9f, 0.9f, 0.9f);
+        }
+    }
+
+    void RunRecordingBenchmarks(BenchmarkRunner& runner, const Settings& settings, const GlyphTable& smallFont)
+    {
+        for (const Resolution& resolution : settings.resolutions)
+        {
+            const size_t rows = (resolution.height - 8) / 24;
+            const size_t labelsPerRow = resolution.width / 160;
+
+            for (int threads : settings.threadCounts)
+            {
+                ParallelRecorder recorder(threads);
+                DisplayList list;
+                auto record = [&](size_t row, DisplayList& buffer) { RecordLabelRow(smallFont, resolution, row, buffer); };
+
+                runner.Run("record", { { "scene", "labels" }, { "resolution", resolution.name },
+                                       { "threads", std::to_string(threads) } },
+                           static_cast<double>(rows * labelsPerRow), [&](uint64_t iterations)
+                {
+                    for (uint64_t i = 0; i < iterations; i++)
+                    {
+                        recorder.Record(list, rows, record);
+                        DoNotOptimize(list);
+                    }
+                });
+            }
+        }
+    }
+
+    void SpinFor(std::chrono::microseconds duration)
+    {
+        auto end = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < end)
+        {
+        }
+    }
+
+    // FrameRing against a CpuFence: the caller spends 100 us recording each frame and a
+    // consumer thread (standing in for the GPU or present thread) 100 us completing it.
+    // Depth 1 serializes the two; deeper queues overlap them given a free core.
+    void RunPipelineBenchmarks(BenchmarkRunner& runner)
+    {
+        const std::chrono::microseconds work(100);
+
+        for (uint32_t depth = 1; depth <= MAX_FRAMES_IN_FLIGHT; depth++)
+        {
+            runner.Run("frames_in_flight", { { "depth", std::to_string(depth) } }, 1, [&](uint64_t iterations)
+            {
+                CpuFence fence;
+                FrameRing<int> ring(fence, depth);
+
+                std::mutex mutex;
+                std::condition_variable submitted;
+                std::deque<uint64_t> queue;
+                bool done = false;
+
+                std::thread consumer([&]
+                {
+                    for (;;)
+                    {
+                        uint64_t value;
+                        {
+                            std::unique_lock<std::mutex> lock(mutex);
+                            submitted.wait(lock, [&] { return done || !queue.empty(); });
+                            if (queue.empty())
+                                return;
+                            value = queue.front();
+                            queue.pop_front();
+                        }
+                        SpinFor(work);
+                        fence.Signal(value);
+                    }
+                });
+
+                for (uint64_t i = 0; i < iterations; i++)
+                {
+                    ring.BeginFrame();
+                    SpinFor(work);
+                    uint64_t value = ring.EndFrame();
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        queue.push_back(value);
+                    }
+                    submitted.notify_one();
+                }
+
+                ring.WaitIdle();
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    done = true;
+                }
+                submitted.notify_one();
+                consumer.join();
+            });
+        }
+    }
+
+    // Engine update logic on a virtual clock at 60 Hz steps, without rendering
+    void RunSimulationBenchmarks(BenchmarkRunner& runner, const Settings& settings)
+    {
+        const IClock::Duration step = std::chrono::microseconds(16667);
+
+        for (int threads : settings.threadCounts)
+        {
+            std::vector<std::shared_ptr<VirtualClock>> clocks;
+            std::vector<std::unique_ptr<Engine>> engines;
+            for (int t = 0; t < threads; t++)
+            {
+                clocks.push_back(std::make_shared<VirtualClock>());
+                engines.push_back(std::make_unique<Engine>(1280, 720, clocks.back()));
+                engines.back()->SetSeed(1);
+            }
+
+            runner.Run("engine_update", { { "threads", std::to_string(threads) } }, threads, [&](uint64_t iterations)
+            {
+                RunOnThreads(threads, iterations, [&](int t, uint64_t count)
+                {
+                    for (uint64_t i = 0; i < count; i++)
+                    {
+                        clocks[t]->Advance(step);
+                        engines[t]->Update();
+                    }
+                });
+            });
+        }
+    }
+
+    // Timer wheel with many periodic timers of mixed periods (1 tick to ~1 minute at 60 Hz).
+    // advance: one tick, cost scales with the timers that fire; reschedule: cancel + insert.
+    void RunTimerBenchmarks(BenchmarkRunner& runner)
+    {
+        for (size_t timerCount : { size_t(1000), size_t(10000), size_t(100000) })
+        {
+            TimerWheel wheel;
+            std::vector<TimerWheel::TimerId> ids;
+            uint64_t fired = 0;
+            uint32_t state = 1;
+            for (size_t i = 0; i < timerCount; i++)
+            {
+                state = state * 1664525u + 1013904223u;
+                ids.push_back(wheel.SchedulePeriodic(1 + (state >> 8) % 3600, [&fired] { fired++; }));
+            }
+
+            const std::string count = std::to_string(timerCount);
+            runner.Run("timer_wheel", { { "op", "advance" }, { "timers", count } }, 1, [&](uint64_t iterations)
+            {
+                wheel.Advance(iterations);
+                DoNotOptimize(fired);
+            });
+
+            size_t next = 0;
+            runner.Run("timer_wheel", { { "op", "reschedule" }, { "timers", count } }, 1, [&](uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; i++)
+                {
+                    TimerWheel::TimerId& id = ids[next];
+                    next = (next + 1) % ids.size();
+                    wheel.Cancel(id);
+                    id = wheel.SchedulePeriodic(1 + (i % 3600), [&fired] { fired++; });
+                }
+                DoNotOptimize(ids);
+            });
+        }
+    }
+
+    // The application's scene (title, number, message) laid out like Engine::BuildScene;
+    // drawn too unless measureOnly
+    void DrawScene(IRenderer& renderer, bool measureOnly)
+    {
+        struct Line { const wchar_t* text; float size; };
+        const Line lines[] = { { LABEL_TEXT, 24.0f }, { L"42", 120.0f }, { L"Updates every 5 seconds", 20.0f } };
+
+        if (!measureOnly)
+        {
+            renderer.BeginFrame();
+            renderer.Clear(0.1f, 0.2f, 0.4f);
+        }
+
+        float y = 100.0f;
+        for (const Line& line : lines)
+        {
+            float width, height;
+            renderer.MeasureText(line.text, line.size, width, height);
+            if (!measureOnly)
+                renderer.DrawText(line.text, (1280.0f - width) / 2.0f, y, line.size, 1.0f, 1.0f, 1.0f);
+            y += height + 40.0f;
+        }
+
+        if (!measureOnly)
+            renderer.EndFrame();
+    }
+
+    // Renderer switch to the first frame with fonts loaded from disk every time (a
+    // standalone renderer with its own ResourceManager) versus Engine::SwitchRenderer
+    // reusing the resident fonts, and raw handle resolution in a generational pool
+    void RunResourceBenchmarks(BenchmarkRunner& runner)
+    {
+        runner.Run("renderer_switch", { { "resources", "private" } }, 1, [&](uint64_t iterations)
+        {
+            for (uint64_t i = 0; i < iterations; i++)
+            {
+                SoftwareRenderer renderer;
+                renderer.Initialize(nullptr, 1280, 720);
+                DrawScene(renderer, false);
+                renderer.OnDestroy();
+            }
+        });
+
+        Engine engine(1280, 720);
+        engine.Initialize(nullptr, std::make_unique<SoftwareRenderer>());
+        runner.Run("renderer_switch", { { "resources", "shared" } }, 1, [&](uint64_t iterations)
+        {
+            for (uint64_t i = 0; i < iterations; i++)
+            {
+                engine.SwitchRenderer(std::make_unique<SoftwareRenderer>());
+                engine.Render();
+            }
+        });
+        engine.OnDestroy();
+
+        for (size_t count : { size_t(1000), size_t(100000) })
+        {
+            ResourcePool<uint64_t> pool;
+            std::vector<ResourcePool<uint64_t>::Handle> handles;
+            for (size_t i = 0; i < count; i++)
+                handles.push_back(pool.Add(i));
+
+            // Shuffled lookup order so the slot reads are not a linear scan
+            uint32_t state = 1;
+            for (size_t i = handles.size() - 1; i > 0; i--)
+            {
+                state = state * 1664525u + 1013904223u;
+                std::swap(handles[i], handles[(state >> 8) % (i + 1)]);
+            }
+
+            runner.Run("resource_lookup", { { "handles", std::to_string(count) } }, 1, [&](uint64_t iterations)
+            {
+                uint64_t sum = 0;
+                size_t next = 0;
+                for (uint64_t i = 0; i < iterations; i++)
+                {
+                    sum += *pool.Get(handles[next]);
+                    if (++next == handles.size())
+                        next = 0;
+                }
+                DoNotOptimize(sum);
+            });
+        }
+    }
+
+    // Cold start: a fresh ResourceManager (nothing resident) through renderer Initialize
+    // and the first frame, or only the scene layout as headless measuring tools do. Eager
+    // loads every font with its atlas up front, as renderers did before loading on first
+    // use; lazy lets the renderer request what the workload touches. fonts:pack reads
+    // them from a mapped asset pack instead of loose files. Each run also records the
+    // font bytes left resident.
+    void RunStartupBenchmarks(BenchmarkRunner& runner)
+    {
+        const wchar_t* fontFiles[] = { L"arial24.spritefont", L"arial120.spritefont" };
+        const wchar_t* packFile = L"bench_assets.gepack";
+
+        AssetPackWriter writer;
+        for (const wchar_t* fileName : fontFiles)
+            writer.AddFile(fileName);
+        writer.Write(packFile);
+
+        for (bool packed : { false, true })
+        {
+            for (bool eager : { true, false })
+            {
+                for (bool measureOnly : { false, true })
+                {
+                    std::vector<std::pair<std::string, std::string>> params = {
+                        { "loading", eager ? "eager" : "lazy" },
+                        { "workload", measureOnly ? "measure" : "frame" } };
+                    if (packed)
+                        params.push_back({ "fonts", "pack" });
+
+                    size_t residentBytes = 0;
+                    bool ran = runner.Run("startup", params, 1, [&](uint64_t iterations)
+                    {
+                        for (uint64_t i = 0; i < iterations; i++)
+                        {
+                            auto resources = std::make_shared<ResourceManager>();
+                            if (packed)
+                            {
+                                auto pack = std::make_shared<AssetPack>();
+                                pack->Open(packFile);
+                                resources->MountPack(std::move(pack));
+                            }
+
+                            if (eager)
+                            {
+                                for (const wchar_t* fileName : fontFiles)
+                                    resources->GetCoverageAtlas(resources->LoadFont(fileName, true));
+                            }
+
+                            SoftwareRenderer renderer;
+                            renderer.SetResources(resources);
+                            renderer.Initialize(nullptr, 1280, 720);
+                            DrawScene(renderer, measureOnly);
+                            residentBytes = resources->GetResidentBytes();
+                            renderer.OnDestroy();
+                        }
+                    });
+                    if (ran)
+                        runner.AddCounter("resident_bytes", static_cast<double>(residentBytes));
+                }
+            }
+        }
+
+        std::filesystem::remove(packFile);
+    }
+
+    // Coverage atlas encodings: decode time from the loaded texture and the atlas size,
+    // then glyph blit throughput sampling each encoding, per font
+    void RunAtlasBenchmarks(BenchmarkRunner& runner)
+    {
+        struct AtlasFont
+        {
+            const char* name;
+            const wchar_t* fileName;
+            float size;
+            const wchar_t* text;
+        };
+        const AtlasFont fonts[] = {
+            { "24pt", L"arial24.spritefont", 24.0f, LONG_TEXT },
+            { "120pt", L"arial120.spritefont", 120.0f, L"8888" },
+        };
+
+        for (const AtlasFont& font : fonts)
+        {
+            SpriteFontData texture = SpriteFontFile::Load(font.fileName);
+            const double pixels = static_cast<double>(texture.textureWidth) * texture.textureHeight;
+
+            for (CoverageEncoding encoding : { CoverageEncoding::Dense, CoverageEncoding::Compact })
+            {
+                const char* encodingName = encoding == CoverageEncoding::Dense ? "dense" : "compact";
+
+                size_t atlasBytes = 0;
+                bool ran = runner.Run("atlas_decode", { { "font", font.name }, { "encoding", encodingName } }, pixels,
+                                      [&](uint64_t iterations)
+                {
+                    for (uint64_t i = 0; i < iterations; i++)
+                    {
+                        CoverageAtlas atlas = CoverageAtlas::FromSpriteFont(texture, encoding);
+                        atlasBytes = atlas.GetByteSize();
+                        DoNotOptimize(atlas.data.data());
+                    }
+                });
+                if (ran)
+                    runner.AddCounter("atlas_bytes", static_cast<double>(atlasBytes));
+
+                auto resources = std::make_shared<ResourceManager>();
+                resources->SetCoverageEncoding(encoding);
+                SoftwareRenderer renderer;
+                renderer.SetResources(resources);
+                renderer.Initialize(nullptr, 1280, 720);
+                renderer.DrawText(font.text, 40.0f, 200.0f, font.size, 1.0f, 1.0f, 1.0f);
+
+                runner.Run("atlas_blit", { { "font", font.name }, { "encoding", encodingName } },
+                           static_cast<double>(wcslen(font.text)), [&](uint64_t iterations)
+                {
+                    for (uint64_t i = 0; i < iterations; i++)
+                        renderer.DrawText(font.text, 40.0f, 200.0f, font.size, 1.0f, 1.0f, 1.0f);
+                });
+                renderer.OnDestroy();
+            }
+        }
+
+        // Sizes between and beyond the fonts: scaling each glyph of the text from the nearest
+        // larger atlas, then drawing through the scaled glyph cache once it is warm
+        struct ScaledSize
+        {
+            float size;
+            const wchar_t* fileName;
+            float fontSize;
+        };
+        const ScaledSize sizes[] = {
+            { 12.0f, L"arial24.spritefont", 24.0f },
+            { 20.0f, L"arial24.spritefont", 24.0f },
+            { 48.0f, L"arial120.spritefont", 120.0f },
+            { 200.0f, L"arial120.spritefont", 120.0f },
+        };
+        for (const ScaledSize& scaled : sizes)
+        {
+            const std::string sizeName = std::to_string(static_cast<int>(scaled.size));
+            SpriteFontData data = SpriteFontFile::Load(scaled.fileName);
+            GlyphTable glyphs(data);
+            CoverageAtlas atlas = CoverageAtlas::FromSpriteFont(data);
+            const size_t length = wcslen(LONG_TEXT);
+
+            GlyphCache cache(std::make_unique<SpriteGlyphSource>(glyphs, atlas, scaled.fontSize));
+            runner.Run("glyph_scale", { { "size", sizeName } }, static_cast<double>(length), [&](uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; i++)
+                {
+                    cache.Clear();
+                    for (size_t c = 0; c < length; c++)
+                    {
+                        if (const SpriteFontGlyph* glyph = glyphs.FindGlyph(LONG_TEXT[c]))
+                            DoNotOptimize(cache.GetGlyph(glyphs.GetGlyphIndex(glyph), scaled.size).pixels);
+                    }
+                }
+            });
+
+            SoftwareRenderer renderer;
+            renderer.Initialize(nullptr, 1280, 720);
+            renderer.DrawText(LONG_TEXT, 40.0f, 200.0f, scaled.size, 1.0f, 1.0f, 1.0f);
+            bool ran = runner.Run("atlas_blit_scaled", { { "size", sizeName } }, static_cast<double>(length),
+                                  [&](uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; i++)
+                    renderer.DrawText(LONG_TEXT, 40.0f, 200.0f, scaled.size, 1.0f, 1.0f, 1.0f);
+            });
+            if (ran)
+            {
+                GlyphCacheStats stats = renderer.GetGlyphCacheStats();
+                runner.AddCounter("hit_rate", static_cast<double>(stats.hits) / std::max<uint64_t>(1, stats.hits + stats.misses));
+            }
+            renderer.OnDestroy();
+        }
+    }
+
+    // Outline font text: rasterizing glyphs on a cold cache, then drawing through the glyph
+    // cache at a fixed size and at a size that zooms every frame
+    void RunOutlineBenchmarks(BenchmarkRunner& runner, const Settings& settings)
+    {
+        if (settings.outlineFontPath.empty())
+            return;
+
+        std::shared_ptr<const TrueTypeFont> font =
+            TrueTypeFont::Load(Utf8ToWide(settings.outlineFontPath).c_str());
+        const size_t length = wcslen(LONG_TEXT);
+        std::vector<uint16_t> glyphs;
+        for (size_t i = 0; i < length; i++)
+            glyphs.push_back(font->FindGlyph(LONG_TEXT[i]));
+
+        for (float size : { 12.0f, 24.0f, 48.0f, 120.0f })
+        {
+            GlyphCache cache(std::make_unique<OutlineGlyphSource>(font));
+            bool ran = runner.Run("glyph_rasterize", { { "size", std::to_string(static_cast<int>(size)) } },
+                                  static_cast<double>(length), [&](uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; i++)
+                {
+                    cache.Clear();
+                    for (uint16_t glyph : glyphs)
+                        DoNotOptimize(cache.GetGlyph(glyph, size).pixels);
+                }
+            });
+            if (ran)
+            {
+                // Coverage pixels written per pass over the text
+                GlyphCacheStats stats = cache.GetStats();
+                runner.AddCounter("text_pixels", static_cast<double>(stats.renderedPixels) / stats.misses * length);
+            }
+        }
+
+        for (bool animated : { false, true })
+        {
+            auto resources = std::make_shared<ResourceManager>();
+            resources->LoadOutlineFont(Utf8ToWide(settings.outlineFontPath).c_str());
+            SoftwareRenderer renderer;
+            renderer.SetResources(resources);
+            renderer.Initialize(nullptr, 1280, 720);
+
+            // The zoom cycles through 16 sizes, which the cache holds at once after one cycle
+            uint64_t frame = 0;
+            bool ran = runner.Run("outline_text_draw", { { "size", animated ? "animated" : "24" } },
+                                  static_cast<double>(length), [&](uint64_t iterations)
+            {
+                for (uint64_t i = 0; i < iterations; i++, frame++)
+                {
+                    float size = animated ? 16.0f + static_cast<float>(frame % 16) * 3.0f : 24.0f;
+                    renderer.BeginFrame();
+                    renderer.DrawText(LONG_TEXT, 20.0f, 200.0f, size, 1.0f, 1.0f, 1.0f);
+                    renderer.EndFrame();
+                }
+            });
+            if (ran)
+            {
+                GlyphCacheStats stats = renderer.GetGlyphCacheStats();
+                runner.AddCounter("hit_rate", static_cast<double>(stats.hits) / std::max<uint64_t>(1, stats.hits + stats.misses));
+                runner.AddCounter("evicted_pages", static_cast<double>(stats.evictedPages));
+            }
+            renderer.OnDestroy();
+        }
+    }
+
+    std::string GetOption(const std::string& arg, const std::string& prefix)
+    {
+        return arg.compare(0, prefix.size(), prefix) == 0 ? arg.substr(prefix.size()) : std::string();
+    }
+
+    bool ParseResolutions(const std::string& list, std::vector<Resolution>& out)
+    {
+        out.clear();
+        size_t start = 0;
+        while (start <= list.size())
+        {
+            size_t end = list.find(',', start);
+            if (end == std::string::npos)
+                end = list.size();
+            std::string name = list.substr(start, end - start);
+
+            auto match = std::find_if(std::begin(ALL_RESOLUTIONS), std::end(ALL_RESOLUTIONS),
+                                      [&](const Resolution& r) { return name == r.name; });
+            if (match == std::end(ALL_RESOLUTIONS))
+                return false;
+            out.push_back(*match);
+            start = end + 1;
+        }
+        return !out.empty();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    BenchmarkOptions options;
+    Settings settings;
+    settings.resolutions.assign(std::begin(ALL_RESOLUTIONS), std::end(ALL_RESOLUTIONS));
+    int maxThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    std::vector<std::string> args = GetUtf8Arguments(argc, argv);
+    for (size_t i = 1; i < args.size(); i++)
+    {
+        const std::string& arg = args[i];
+        std::string value;
+        if (!(value = GetOption(arg, "--out=")).empty())
+            settings.outputPath = value;
+        else if (!(value = GetOption(arg, "--filter=")).empty())
+            options.filter = value;
+        else if (!(value = GetOption(arg, "--repetitions=")).empty())
+            options.repetitions = std::max(1, atoi(value.c_str()));
+        else if (!(value = GetOption(arg, "--min-time-ms=")).empty())
+            options.minSampleMs = std::max(1.0, atof(value.c_str()));
+        else if (!(value = GetOption(arg, "--max-threads=")).empty())
+            maxThreads = std::max(1, atoi(value.c_str()));
+        else if (!(value = GetOption(arg, "--ttf=")).empty())
+            settings.outlineFontPath = value;
+        else if (!(value = GetOption(arg, "--resolutions=")).empty())
+        {
+            if (!ParseResolutions(value, settings.resolutions))
+            {
+                printf("Invalid resolution list: %s (use 720p, 1080p, 4k, 8k)\n", value.c_str());
+                return 2;
+            }
+        }
+        else
+        {
+            printf("Unknown option: %s\n", arg.c_str());
+            return 2;
+        }
+    }
+
+    // Powers of two up to the limit, plus the limit itself
+    for (int threads = 1; threads < maxThreads; threads *= 2)
+        settings.threadCounts.push_back(threads);
+    settings.threadCounts.push_back(maxThreads);
+
+    try
+    {
+        SpriteFontData smallData = SpriteFontFile::Load(L"arial24.spritefont", false);
+        SpriteFontData largeData = SpriteFontFile::Load(L"arial120.spritefont", false);
+        GlyphTable smallFont(smallData);
+        GlyphTable largeFont(largeData);
+
+        BenchmarkRunner runner(options);
+        RunGlyphBenchmarks(runner, settings, smallFont, largeFont);
+        RunRasterBenchmarks(runner, settings);
+        RunFrameBenchmarks(runner, settings);
+        RunRecordingBenchmarks(runner, settings, smallFont);
+        RunSimulationBenchmarks(runner, settings);
+        RunTimerBenchmarks(runner);
+        RunPipelineBenchmarks(runner);
+        RunResourceBenchmarks(runner);
+        RunStartupBenchmarks(runner);
+        RunAtlasBenchmarks(runner);
+        RunOutlineBenchmarks(runner, settings);
+
+        if (!runner.WriteJson(settings.outputPath))
+        {
+            printf("Failed to write %s\n", settings.outputPath.c_str());
+            return 1;
+        }
+        printf("\n%zu benchmarks written to %s\n", runner.GetResults().size(), settings.outputPath.c_str());
+    }
+    catch (const std::exception& e)
+    {
+        printf("Benchmark failed: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,271 @@
+// LatencyBench - measures how long input and simulation steps wait when update and render
+// share the window thread, compared with running them on EngineThreads.
+//
+// Usage: LatencyBench [--seconds=S] [--present-ms=MS] [--input-hz=N] [--mode=single|threaded|both]
+//
+// Frames go to the headless software renderer, wrapped so EndFrame() blocks for
+// --present-ms (default 12 ms) in place of a vsync present or a DX12 fence wait. A
+// generator thread queues input events at --input-hz (default 250); input latency is the
+// time from queueing to handling on the window thread. Step lateness is how long after a
+// fixed step fell due Update() ran it. Run from a directory containing the sprite fonts.
+#include <windows.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Clock.h"
+#include "Engine.h"
+#include "EngineThreads.h"
+#include "SoftwareRenderer.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Settings
+    {
+        double seconds = 5.0;
+        double presentMs = 12.0;
+        double inputHz = 250.0;
+        bool single = true;
+        bool threaded = true;
+    };
+
+    // Forwards to a renderer and blocks in EndFrame like a synchronized present
+    class BlockingRenderer : public IRenderer
+    {
+    public:
+        BlockingRenderer(std::unique_ptr<IRenderer> inner, double presentMs)
+            : m_inner(std::move(inner))
+            , m_present(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(presentMs)))
+        {
+        }
+
+        void Initialize(HWND hwnd, UINT width, UINT height) override { m_inner->Initialize(hwnd, width, height); }
+        void BeginFrame() override { m_inner->BeginFrame(); }
+        void Clear(float r, float g, float b) override { m_inner->Clear(r, g, b); }
+        void DrawText(const wchar_t* text, float x, float y, float fontSize,
+                      float r, float g, float b, bool bold) override
+        {
+            m_inner->DrawText(text, x, y, fontSize, r, g, b, bold);
+        }
+        void MeasureText(const wchar_t* text, float fontSize, float& outWidth, float& outHeight) override
+        {
+            m_inner->MeasureText(text, fontSize, outWidth, outHeight);
+        }
+        void EndFrame() override
+        {
+            m_inner->EndFrame();
+            std::this_thread::sleep_for(m_present);
+            frames++;
+        }
+        bool IsPresentPaced() const override { return true; }
+        void Resize(UINT width, UINT height) override { m_inner->Resize(width, height); }
+        void OnDestroy() override { m_inner->OnDestroy(); }
+        const char* GetName() const override { return m_inner->GetName(); }
+
+        std::atomic<uint64_t> frames{ 0 };
+
+    private:
+        std::unique_ptr<IRenderer> m_inner;
+        Clock::duration m_present;
+    };
+
+    // Input events queued by the generator thread, stamped with their queueing time
+    class InputQueue
+    {
+    public:
+        void Push(Clock::time_point time)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_events.push_back(time);
+            }
+            m_available.notify_one();
+        }
+
+        // Handle everything queued; waits up to `timeout` for the first event
+        void Drain(std::vector<double>& latencies, Clock::duration timeout)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_available.wait_for(lock, timeout, [this] { return !m_events.empty(); });
+            Clock::time_point now = Clock::now();
+            for (Clock::time_point queued : m_events)
+                latencies.push_back(std::chrono::duration<double, std::milli>(now - queued).count());
+            m_events.clear();
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_available;
+        std::deque<Clock::time_point> m_events;
+    };
+
+    struct RunResult
+    {
+        std::vector<double> inputMs;
+        std::vector<double> stepLatenessMs;
+        uint64_t updates = 0;
+        uint64_t frames = 0;
+        double droppedMs = 0.0;
+    };
+
+    double Percentile(std::vector<double> values, double p)
+    {
+        if (values.empty())
+            return 0.0;
+        size_t index = static_cast<size_t>(p * (values.size() - 1));
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    }
+
+    void PrintLatencies(const char* name, const std::vector<double>& ms)
+    {
+        if (ms.empty())
+            return;
+        printf("  %-16s %8zu  p50 %8.3f  p99 %8.3f  max %8.3f ms\n", name, ms.size(),
+               Percentile(ms, 0.50), Percentile(ms, 0.99), *std::max_element(ms.begin(), ms.end()));
+    }
+
+    RunResult Run(const Settings& settings, bool threaded)
+    {
+        RunResult result;
+        auto clock = std::make_shared<SteadyClock>();
+        Engine engine(1280, 720, clock);
+        engine.SetSeed(1);
+
+        auto renderer = std::make_unique<BlockingRenderer>(std::make_unique<SoftwareRenderer>(), settings.presentMs);
+        BlockingRenderer* blocking = renderer.get();
+        engine.Initialize(nullptr, std::move(renderer));
+
+        // Runs inside every fixed step: how far the clock is past the step's due time
+        engine.ScheduleTimer(engine.GetFixedTimestep(), [&]
+        {
+            IClock::Duration late = clock->Now() - engine.GetSimulationTime();
+            result.stepLatenessMs.push_back(std::chrono::duration<double, std::milli>(late).count());
+        }, true);
+
+        InputQueue input;
+        std::atomic<bool> generating(true);
+        std::thread generator([&]
+        {
+            // Jittered intervals around the requested rate
+            uint32_t state = 12345;
+            double meanUs = 1e6 / settings.inputHz;
+            while (generating.load())
+            {
+                state = state * 1664525u + 1013904223u;
+                double us = meanUs * (0.5 + (state >> 8) / double(1u << 24));
+                std::this_thread::sleep_for(std::chrono::duration<double, std::micro>(us));
+                input.Push(Clock::now());
+            }
+        });
+
+        Clock::time_point end = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(settings.seconds));
+
+        if (threaded)
+        {
+            EngineThreads threads(engine);
+            threads.Start();
+            while (Clock::now() < end)
+                input.Drain(result.inputMs, std::chrono::milliseconds(5));
+            threads.Stop();
+        }
+        else
+        {
+            // Same shape as the single-threaded window loop: handle input, then a frame
+            while (Clock::now() < end)
+            {
+                input.Drain(result.inputMs, Clock::duration::zero());
+                engine.Update();
+                engine.Render();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+
+        generating = false;
+        generator.join();
+
+        result.updates = engine.GetStepCount();
+        result.frames = blocking->frames.load();
+        result.droppedMs = std::chrono::duration<double, std::milli>(engine.GetDroppedTime()).count();
+        engine.OnDestroy();
+        return result;
+    }
+
+    void Report(const char* mode, const RunResult& result, double seconds)
+    {
+        printf("%s: %llu steps, %llu frames (%.1f fps), %.1f ms dropped by the catch-up cap\n", mode,
+               static_cast<unsigned long long>(result.updates), static_cast<unsigned long long>(result.frames),
+               result.frames / seconds, result.droppedMs);
+        PrintLatencies("Input latency", result.inputMs);
+        PrintLatencies("Step lateness", result.stepLatenessMs);
+    }
+
+    std::string GetOption(const std::string& arg, const std::string& prefix)
+    {
+        return arg.compare(0, prefix.size(), prefix) == 0 ? arg.substr(prefix.size()) : std::string();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Settings settings;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        std::string value;
+        if (!(value = GetOption(arg, "--seconds=")).empty())
+            settings.seconds = atof(value.c_str());
+        else if (!(value = GetOption(arg, "--present-ms=")).empty())
+            settings.presentMs = atof(value.c_str());
+        else if (!(value = GetOption(arg, "--input-hz=")).empty())
+            settings.inputHz = atof(value.c_str());
+        else if (arg == "--mode=single")
+            settings.threaded = false;
+        else if (arg == "--mode=threaded")
+            settings.single = false;
+        else if (arg == "--mode=both")
+            settings.single = settings.threaded = true;
+        else
+        {
+            printf("Unknown option: %s\n", arg.c_str());
+            return 2;
+        }
+    }
+
+    if (settings.seconds <= 0.0 || settings.presentMs < 0.0 || settings.inputHz <= 0.0)
+    {
+        printf("Seconds and input rate must be positive, present time non-negative\n");
+        return 2;
+    }
+
+    printf("%.1f s per mode, %.1f ms blocking present, %.0f Hz input\n\n",
+           settings.seconds, settings.presentMs, settings.inputHz);
+
+    try
+    {
+        if (settings.single)
+            Report("Single thread", Run(settings, false), settings.seconds);
+        if (settings.single && settings.threaded)
+            printf("\n");
+        if (settings.threaded)
+            Report("Engine threads", Run(settings, true), settings.seconds);
+    }
+    catch (const std::exception& e)
+    {
+        printf("Benchmark failed: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
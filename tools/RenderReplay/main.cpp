@@ -0,0 +1,233 @@
+// RenderReplay - streams a .gecap draw-command capture through a renderer as fast as possible
+//
+// Usage: RenderReplay <capture.gecap> [--renderer=gdi|dx12|software] [--loops=N]
+#include <windows.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "CaptureFormat.h"
+#include "CommandLine.h"
+#include "RendererFactory.h"
+#include "Logger.h"
+
+using namespace CaptureFormat;
+
+namespace
+{
+    struct ReplayStats
+    {
+        uint64_t frames = 0;
+        uint64_t records = 0;
+        uint64_t measureMismatches = 0;
+        std::vector<double> frameMs;
+    };
+
+    // Text payload of a record, or nullptr unless the record holds the payload plus
+    // the terminated string
+    const TextPayload* GetTextPayload(const RecordHeader* record)
+    {
+        auto payload = CaptureReader::GetPayload<TextPayload>(record);
+        if (!payload)
+            return nullptr;
+        size_t needed = sizeof(RecordHeader) + sizeof(TextPayload) + (static_cast<size_t>(payload->textLength) + 1) * sizeof(wchar_t);
+        return record->size >= needed ? payload : nullptr;
+    }
+
+    HWND CreateReplayWindow(UINT width, UINT height)
+    {
+        const wchar_t CLASS_NAME[] = L"RenderReplayWindowClass";
+
+        WNDCLASSW wc = {};
+        wc.lpfnWndProc = DefWindowProcW;
+        wc.hInstance = GetModuleHandleW(nullptr);
+        wc.lpszClassName = CLASS_NAME;
+        RegisterClassW(&wc);
+
+        RECT windowRect = { 0, 0, static_cast<LONG>(width), static_cast<LONG>(height) };
+        AdjustWindowRect(&windowRect, WS_OVERLAPPEDWINDOW, FALSE);
+
+        return CreateWindowExW(0, CLASS_NAME, L"RenderReplay", WS_OVERLAPPEDWINDOW,
+            CW_USEDEFAULT, CW_USEDEFAULT,
+            windowRect.right - windowRect.left, windowRect.bottom - windowRect.top,
+            nullptr, nullptr, wc.hInstance, nullptr);
+    }
+
+    void PumpMessages()
+    {
+        MSG msg = {};
+        while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE))
+        {
+            TranslateMessage(&msg);
+            DispatchMessageW(&msg);
+        }
+    }
+
+    void ReplayCapture(const CaptureReader& reader, IRenderer& renderer, ReplayStats& stats)
+    {
+        auto frameStart = std::chrono::steady_clock::now();
+
+        for (const RecordHeader* record = reader.First(); record; record = reader.Next(record))
+        {
+            stats.records++;
+
+            switch (record->type)
+            {
+            case RecordType::BeginFrame:
+                frameStart = std::chrono::steady_clock::now();
+                renderer.BeginFrame();
+                break;
+
+            case RecordType::Clear:
+            {
+                auto payload = CaptureReader::GetPayload<ClearPayload>(record);
+                if (payload)
+                    renderer.Clear(payload->r, payload->g, payload->b);
+                break;
+            }
+
+            case RecordType::DrawText:
+            {
+                auto payload = GetTextPayload(record);
+                if (payload)
+                {
+                    renderer.DrawText(PayloadText(payload), payload->x, payload->y, payload->fontSize,
+                                      payload->r, payload->g, payload->b, payload->bold != 0);
+                }
+                break;
+            }
+
+            case RecordType::MeasureText:
+            {
+                auto payload = GetTextPayload(record);
+                if (payload)
+                {
+                    float width, height;
+                    renderer.MeasureText(PayloadText(payload), payload->fontSize, width, height);
+                    if (width != payload->x || height != payload->y)
+                        stats.measureMismatches++;
+                }
+                break;
+            }
+
+            case RecordType::EndFrame:
+            {
+                renderer.EndFrame();
+                auto frameEnd = std::chrono::steady_clock::now();
+                stats.frameMs.push_back(std::chrono::duration<double, std::milli>(frameEnd - frameStart).count());
+                stats.frames++;
+
+                // Keep the window responsive without paying for a pump every frame
+                if ((stats.frames & 63) == 0)
+                    PumpMessages();
+                break;
+            }
+
+            default:
+                // Initialize records mark renderer switches in the live session; the
+                // replay keeps one backend for the whole capture.
+                break;
+            }
+        }
+    }
+
+    double Percentile(std::vector<double> values, double p)
+    {
+        if (values.empty())
+            return 0.0;
+        size_t index = static_cast<size_t>(p * (values.size() - 1));
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        printf("Usage: RenderReplay <capture.gecap> [--renderer=gdi|dx12|software] [--loops=N]\n");
+        return 1;
+    }
+
+    std::vector<std::string> args = GetUtf8Arguments(argc, argv);
+    std::string capturePath = args[1];
+    RendererType rendererType = RendererType::DirectX12;
+    int loops = 1;
+
+    for (size_t i = 2; i < args.size(); i++)
+    {
+        const std::string& arg = args[i];
+        if (arg.compare(0, 11, "--renderer=") == 0)
+        {
+            if (!ParseRendererType(arg.substr(11), rendererType))
+            {
+                printf("Unknown renderer: %s\n", arg.substr(11).c_str());
+                return 1;
+            }
+        }
+        else if (arg.compare(0, 8, "--loops=") == 0)
+        {
+            loops = std::max(1, atoi(arg.c_str() + 8));
+        }
+    }
+
+    try
+    {
+        CaptureReader reader;
+        reader.Open(Utf8ToWide(capturePath));
+
+        // The first Initialize record tells us the window size the session used
+        UINT width = 1280;
+        UINT height = 720;
+        uint64_t capturedNs = 0;
+        for (const RecordHeader* record = reader.First(); record; record = reader.Next(record))
+        {
+            if (record->type == RecordType::Initialize && capturedNs == 0)
+            {
+                auto payload = CaptureReader::GetPayload<InitializePayload>(record);
+                if (payload)
+                {
+                    width = payload->width;
+                    height = payload->height;
+                }
+            }
+            capturedNs = record->timestampNs;
+        }
+
+        HWND hwnd = CreateReplayWindow(width, height);
+        if (!hwnd)
+        {
+            printf("Failed to create replay window\n");
+            return 1;
+        }
+
+        auto renderer = CreateRenderer(rendererType);
+        renderer->Initialize(hwnd, width, height);
+
+        ReplayStats stats;
+        auto start = std::chrono::steady_clock::now();
+        for (int loop = 0; loop < loops; loop++)
+            ReplayCapture(reader, *renderer, stats);
+        auto end = std::chrono::steady_clock::now();
+
+        renderer->OnDestroy();
+        DestroyWindow(hwnd);
+
+        double totalMs = std::chrono::duration<double, std::milli>(end - start).count();
+        printf("Capture:            %s (%zu bytes, %.1f s recorded)\n", capturePath.c_str(), reader.GetSize(), capturedNs / 1e9);
+        printf("Renderer:           %s\n", renderer->GetName());
+        printf("Records replayed:   %llu\n", static_cast<unsigned long long>(stats.records));
+        printf("Frames replayed:    %llu in %.2f ms (%.1f fps)\n", static_cast<unsigned long long>(stats.frames),
+               totalMs, totalMs > 0.0 ? stats.frames * 1000.0 / totalMs : 0.0);
+        printf("Frame time p50/p99: %.3f / %.3f ms\n", Percentile(stats.frameMs, 0.50), Percentile(stats.frameMs, 0.99));
+        printf("Measure mismatches: %llu\n", static_cast<unsigned long long>(stats.measureMismatches));
+    }
+    catch (const std::exception& e)
+    {
+        printf("Replay failed: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
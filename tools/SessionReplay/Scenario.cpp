@@ -0,0 +1,171 @@
+#include "Scenario.h"
+#include "RendererFactory.h"
+#include "CommandLine.h"
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+using namespace SessionFormat;
+
+namespace
+{
+    struct Rule
+    {
+        bool repeating;         // "every" vs "at"
+        uint64_t frame;         // Period or absolute frame
+        EventType type;
+        std::vector<std::pair<uint32_t, uint32_t>> arguments;   // Cycled on each firing
+        size_t next = 0;
+    };
+
+    [[noreturn]] void Fail(int line, const std::string& message)
+    {
+        throw std::runtime_error("Scenario line " + std::to_string(line) + ": " + message);
+    }
+
+    bool ParseSize(const std::string& text, uint32_t& width, uint32_t& height)
+    {
+        size_t separator = text.find('x');
+        if (separator == std::string::npos)
+            return false;
+        width = static_cast<uint32_t>(strtoul(text.c_str(), nullptr, 10));
+        height = static_cast<uint32_t>(strtoul(text.c_str() + separator + 1, nullptr, 10));
+        return width > 0 && height > 0;
+    }
+
+    uint32_t ParseRenderer(int line, const std::string& name)
+    {
+        RendererType type;
+        if (!ParseRendererType(name, type))
+            Fail(line, "unknown renderer '" + name + "'");
+        return static_cast<uint32_t>(type);
+    }
+}
+
+namespace Scenario
+{
+    SessionRecording Parse(const std::string& script)
+    {
+        SessionRecording recording;
+        recording.seed = 1;
+        recording.renderer = static_cast<uint32_t>(RendererType::Software);
+
+        uint64_t frames = 1000;
+        double stepMs = 1000.0 / 60.0;
+        std::vector<Rule> rules;
+
+        std::istringstream lines(script);
+        std::string text;
+        int lineNumber = 0;
+        while (std::getline(lines, text))
+        {
+            lineNumber++;
+            size_t comment = text.find('#');
+            if (comment != std::string::npos)
+                text.erase(comment);
+
+            std::istringstream tokens(text);
+            std::string keyword;
+            if (!(tokens >> keyword))
+                continue;
+
+            std::string value;
+            if (keyword == "seed" && tokens >> value)
+                recording.seed = static_cast<uint32_t>(strtoul(value.c_str(), nullptr, 10));
+            else if (keyword == "size" && tokens >> value)
+            {
+                if (!ParseSize(value, recording.width, recording.height))
+                    Fail(lineNumber, "expected WIDTHxHEIGHT");
+            }
+            else if (keyword == "renderer" && tokens >> value)
+                recording.renderer = ParseRenderer(lineNumber, value);
+            else if (keyword == "frames" && tokens >> value)
+                frames = strtoull(value.c_str(), nullptr, 10);
+            else if (keyword == "step-ms" && tokens >> value)
+            {
+                stepMs = atof(value.c_str());
+                if (stepMs <= 0.0)
+                    Fail(lineNumber, "step must be positive");
+            }
+            else if (keyword == "every" || keyword == "at")
+            {
+                Rule rule;
+                rule.repeating = keyword == "every";
+
+                std::string action;
+                if (!(tokens >> value >> action))
+                    Fail(lineNumber, "expected '" + keyword + " FRAME ACTION ...'");
+                rule.frame = strtoull(value.c_str(), nullptr, 10);
+                if (rule.repeating && rule.frame == 0)
+                    Fail(lineNumber, "period must be at least 1");
+
+                if (action == "switch")
+                {
+                    rule.type = EventType::SwitchRenderer;
+                    while (tokens >> value)
+                        rule.arguments.push_back({ ParseRenderer(lineNumber, value), 0 });
+                }
+                else if (action == "resize")
+                {
+                    rule.type = EventType::Resize;
+                    while (tokens >> value)
+                    {
+                        uint32_t width, height;
+                        if (!ParseSize(value, width, height))
+                            Fail(lineNumber, "expected WIDTHxHEIGHT");
+                        rule.arguments.push_back({ width, height });
+                    }
+                }
+                else if (action == "timer")
+                {
+                    rule.type = EventType::TimerTick;
+                    rule.arguments.push_back({ 0, 0 });
+                }
+                else
+                    Fail(lineNumber, "unknown action '" + action + "'");
+
+                if (rule.arguments.empty())
+                    Fail(lineNumber, "'" + action + "' needs at least one argument");
+                rules.push_back(rule);
+            }
+            else
+                Fail(lineNumber, "unknown or incomplete statement '" + keyword + "'");
+        }
+
+        const auto step = std::chrono::duration<double, std::nano>(stepMs * 1e6);
+        for (uint64_t frame = 0; frame < frames; frame++)
+        {
+            uint64_t timeNs = static_cast<uint64_t>(step.count() * frame);
+
+            for (Rule& rule : rules)
+            {
+                bool fires = rule.repeating ? (frame > 0 && frame % rule.frame == 0) : frame == rule.frame;
+                if (!fires)
+                    continue;
+
+                const auto& argument = rule.arguments[rule.next];
+                rule.next = (rule.next + 1) % rule.arguments.size();
+                recording.events.push_back({ rule.type, argument.first, argument.second, 0, timeNs });
+            }
+
+            recording.events.push_back({ EventType::Frame, 0, 0, 0, timeNs });
+        }
+
+        return recording;
+    }
+
+    SessionRecording Load(const std::string& path)
+    {
+        std::ifstream file(std::filesystem::path(Utf8ToWide(path)));
+        if (!file)
+            throw std::runtime_error("Failed to open scenario " + path);
+
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return Parse(contents.str());
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <string>
+#include "Session.h"
+
+// Authored scenario scripts, expanded into the same event stream a recorded session has.
+//
+//   # Renderer switch storm with resizes
+//   seed 42
+//   size 1280x720
+//   renderer dx12
+//   frames 2000
+//   step-ms 16.667
+//   every 100 switch gdi dx12 software    # cycles through the list
+//   at 500 resize 1920x1080
+//   every 250 resize 800x600 1280x720
+//   every 1 timer
+//
+// "every N" fires on frames N, 2N, ...; "at F" fires once before frame F. Events
+// scheduled for the same frame happen in script order, before that frame's update.
+namespace Scenario
+{
+    // Throws std::runtime_error naming the offending line on bad input
+    SessionRecording Parse(const std::string& script);
+
+    // Read and parse a script file; path is UTF-8
+    SessionRecording Load(const std::string& path);
+}
@@ -0,0 +1,298 @@
+// SessionReplay - replays a recorded session (.gesession) or a scenario script at full speed.
+//
+// Usage: SessionReplay <session.gesession | scenario.txt> [--renderer=gdi|dx12|software]
+//                      [--save=FILE] [--warm-renderers]
+//
+// The engine runs on a VirtualClock set from each frame event, so the random number
+// sequence matches the original run exactly. --renderer forces every switch to one
+// backend (e.g. software on machines without a GPU). --save writes an expanded scenario
+// out as a session file. --warm-renderers switches through a RendererPool, keeping
+// switched-out backends initialized, instead of recreating them on every switch.
+// Prints latency percentiles for frames, renderer switches, resizes and the first frame
+// after each switch or resize.
+#include <windows.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Clock.h"
+#include "CommandLine.h"
+#include "Engine.h"
+#include "Session.h"
+#include "RendererFactory.h"
+#include "RendererPool.h"
+#include "Scenario.h"
+
+using namespace SessionFormat;
+
+namespace
+{
+    struct Latencies
+    {
+        const char* name;
+        std::vector<double> ms;
+    };
+
+    struct ReplayStats
+    {
+        Latencies frames = { "Frame" };
+        Latencies switches = { "Renderer switch" };
+        Latencies resizes = { "Resize" };
+        Latencies firstFrames = { "First frame after switch/resize" };
+        uint64_t timerTicks = 0;
+        uint64_t skippedSwitches = 0;
+        uint64_t warmSwitches = 0;
+        uint64_t checksum = 1469598103934665603ull;    // FNV-1a over the number sequence
+    };
+
+    HWND CreateReplayWindow(UINT width, UINT height)
+    {
+        const wchar_t CLASS_NAME[] = L"SessionReplayWindowClass";
+
+        WNDCLASSW wc = {};
+        wc.lpfnWndProc = DefWindowProcW;
+        wc.hInstance = GetModuleHandleW(nullptr);
+        wc.lpszClassName = CLASS_NAME;
+        RegisterClassW(&wc);
+
+        RECT windowRect = { 0, 0, static_cast<LONG>(width), static_cast<LONG>(height) };
+        AdjustWindowRect(&windowRect, WS_OVERLAPPEDWINDOW, FALSE);
+
+        return CreateWindowExW(0, CLASS_NAME, L"SessionReplay", WS_OVERLAPPEDWINDOW,
+            CW_USEDEFAULT, CW_USEDEFAULT,
+            windowRect.right - windowRect.left, windowRect.bottom - windowRect.top,
+            nullptr, nullptr, wc.hInstance, nullptr);
+    }
+
+    void PumpMessages()
+    {
+        MSG msg = {};
+        while (PeekMessageW(&msg, nullptr, 0, 0, PM_REMOVE))
+        {
+            TranslateMessage(&msg);
+            DispatchMessageW(&msg);
+        }
+    }
+
+    double ElapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    double Percentile(std::vector<double> values, double p)
+    {
+        if (values.empty())
+            return 0.0;
+        size_t index = static_cast<size_t>(p * (values.size() - 1));
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    }
+
+    void PrintLatencies(const Latencies& latencies)
+    {
+        if (latencies.ms.empty())
+            return;
+
+        printf("%-33s %8zu  p50 %8.3f  p99 %8.3f  max %8.3f ms\n", latencies.name, latencies.ms.size(),
+               Percentile(latencies.ms, 0.50), Percentile(latencies.ms, 0.99),
+               *std::max_element(latencies.ms.begin(), latencies.ms.end()));
+    }
+
+    RendererType ToRendererType(uint32_t value)
+    {
+        if (value > static_cast<uint32_t>(RendererType::Software))
+            throw std::runtime_error("Session references an unknown renderer " + std::to_string(value));
+        return static_cast<RendererType>(value);
+    }
+
+    bool EndsWith(const std::string& text, const std::string& suffix)
+    {
+        return text.size() >= suffix.size() && text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        printf("Usage: SessionReplay <session.gesession | scenario.txt> [--renderer=gdi|dx12|software] [--save=FILE]"
+               " [--warm-renderers]\n");
+        return 1;
+    }
+
+    std::vector<std::string> args = GetUtf8Arguments(argc, argv);
+    std::string inputPath = args[1];
+    std::string savePath;
+    bool overrideRenderer = false;
+    bool warmRenderers = false;
+    RendererType forcedRenderer = RendererType::Software;
+
+    for (size_t i = 2; i < args.size(); i++)
+    {
+        const std::string& arg = args[i];
+        if (arg.compare(0, 11, "--renderer=") == 0)
+        {
+            if (!ParseRendererType(arg.substr(11), forcedRenderer))
+            {
+                printf("Unknown renderer: %s\n", arg.substr(11).c_str());
+                return 1;
+            }
+            overrideRenderer = true;
+        }
+        else if (arg.compare(0, 7, "--save=") == 0)
+        {
+            savePath = arg.substr(7);
+        }
+        else if (arg == "--warm-renderers")
+        {
+            warmRenderers = true;
+        }
+        else
+        {
+            printf("Unknown option: %s\n", arg.c_str());
+            return 1;
+        }
+    }
+
+    try
+    {
+        SessionRecording session = EndsWith(inputPath, ".gesession")
+            ? SessionRecording::Load(Utf8ToWide(inputPath))
+            : Scenario::Load(inputPath);
+
+        if (!savePath.empty())
+            session.Save(Utf8ToWide(savePath));
+
+        auto pick = [&](uint32_t value) { return overrideRenderer ? forcedRenderer : ToRendererType(value); };
+
+        HWND hwnd = CreateReplayWindow(session.width, session.height);
+        if (!hwnd)
+        {
+            printf("Failed to create replay window\n");
+            return 1;
+        }
+
+        auto clock = std::make_shared<VirtualClock>();
+        Engine engine(session.width, session.height, clock);
+        engine.SetSeed(session.seed);
+
+        RendererType current = ToRendererType(session.renderer);
+        engine.Initialize(hwnd, CreateRenderer(pick(session.renderer)));
+
+        // Pooled by the session's backend, so a forced renderer still gets one per type
+        std::unique_ptr<RendererPool> pool;
+        if (warmRenderers)
+        {
+            pool = std::make_unique<RendererPool>([&](RendererType type)
+            {
+                return CreateRenderer(pick(static_cast<uint32_t>(type)));
+            });
+            pool->SetCurrent(current);
+        }
+
+        ReplayStats stats;
+        bool afterDisruption = false;
+        auto start = std::chrono::steady_clock::now();
+
+        for (const Event& event : session.events)
+        {
+            switch (event.type)
+            {
+            case EventType::Frame:
+            {
+                clock->SetTime(IClock::Duration(event.timeNs));
+                uint64_t updatesBefore = engine.GetUpdateCount();
+
+                auto frameStart = std::chrono::steady_clock::now();
+                engine.Update();
+                engine.Render();
+                double ms = ElapsedMs(frameStart);
+
+                (afterDisruption ? stats.firstFrames : stats.frames).ms.push_back(ms);
+                afterDisruption = false;
+
+                if (engine.GetUpdateCount() != updatesBefore)
+                    stats.checksum = (stats.checksum ^ static_cast<uint64_t>(engine.GetRandomNumber())) * 1099511628211ull;
+
+                // Keep the window responsive without paying for a pump every frame
+                if ((stats.frames.ms.size() & 63) == 0)
+                    PumpMessages();
+                break;
+            }
+
+            case EventType::SwitchRenderer:
+            {
+                // Like the live window procedure, switching to the active backend is a no-op
+                RendererType requested = ToRendererType(event.arg0);
+                if (requested == current)
+                {
+                    stats.skippedSwitches++;
+                    break;
+                }
+                current = requested;
+
+                auto switchStart = std::chrono::steady_clock::now();
+                if (pool)
+                    stats.warmSwitches += pool->Switch(engine, requested) ? 1 : 0;
+                else
+                    engine.SwitchRenderer(CreateRenderer(pick(event.arg0)));
+                stats.switches.ms.push_back(ElapsedMs(switchStart));
+                afterDisruption = true;
+                break;
+            }
+
+            case EventType::Resize:
+            {
+                auto resizeStart = std::chrono::steady_clock::now();
+                engine.Resize(event.arg0, event.arg1);
+                stats.resizes.ms.push_back(ElapsedMs(resizeStart));
+                afterDisruption = true;
+                break;
+            }
+
+            case EventType::TimerTick:
+                stats.timerTicks++;
+                break;
+
+            default:
+                break;
+            }
+        }
+
+        double totalMs = ElapsedMs(start);
+        pool.reset();
+        engine.OnDestroy();
+        DestroyWindow(hwnd);
+
+        uint64_t frames = stats.frames.ms.size() + stats.firstFrames.ms.size();
+        double engineSeconds = std::chrono::duration<double>(clock->Now()).count();
+
+        printf("Session:      %s (seed %u, %ux%u, %zu events)\n", inputPath.c_str(), session.seed,
+               session.width, session.height, session.events.size());
+        printf("Replayed:     %llu frames in %.2f ms (%.1f s of engine time)\n",
+               static_cast<unsigned long long>(frames), totalMs, engineSeconds);
+        printf("Timer ticks:  %llu, redundant switches skipped: %llu\n",
+               static_cast<unsigned long long>(stats.timerTicks),
+               static_cast<unsigned long long>(stats.skippedSwitches));
+        if (warmRenderers)
+            printf("Warm pool:    %llu of %zu switches resumed a parked renderer\n",
+                   static_cast<unsigned long long>(stats.warmSwitches), stats.switches.ms.size());
+        printf("Final number: %d\n", engine.GetRandomNumber());
+        printf("Checksum:     %016llx\n\n", static_cast<unsigned long long>(stats.checksum));
+
+        PrintLatencies(stats.frames);
+        PrintLatencies(stats.switches);
+        PrintLatencies(stats.resizes);
+        PrintLatencies(stats.firstFrames);
+    }
+    catch (const std::exception& e)
+    {
+        printf("Replay failed: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}